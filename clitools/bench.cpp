@@ -0,0 +1,1254 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+// Micro-benchmarks of the library, run as "hubero-bench <benchmark> [options]"
+
+#include <hubero/assignment.hpp>
+#include <hubero/binary_cnf.hpp>
+#include <hubero/core.hpp>
+#include <hubero/cube_and_conquer.hpp>
+#include <hubero/decision.hpp>
+#include <hubero/dimacs_loader.hpp>
+#include <hubero/dimacs_writer.hpp>
+#include <hubero/gauss.hpp>
+#include <hubero/local_search.hpp>
+#include <hubero/mapped_file.hpp>
+#include <hubero/portfolio.hpp>
+#include <hubero/propagator.hpp>
+#include <hubero/simplifier.hpp>
+#include <hubero/solver.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace hubero;
+
+namespace {
+
+using Args = std::map<std::string, std::string>;
+
+class UsageError : public std::runtime_error {
+public:
+    explicit UsageError(const std::string& what) : std::runtime_error(what) {}
+};
+
+std::uint64_t get_uint(const Args& args, const std::string& name, std::uint64_t value)
+{
+    auto it = args.find(name);
+    if (it == args.end()) {
+        return value;
+    }
+    try {
+        return std::stoull(it->second);
+    } catch (const std::logic_error&) {
+        throw UsageError("--" + name + " expects a number");
+    }
+}
+
+std::string get_string(const Args& args, const std::string& name)
+{
+    auto it = args.find(name);
+    return it == args.end() ? std::string() : it->second;
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double>(elapsed).count();
+}
+
+// Uniform random k-CNF in the DIMACS format
+std::string random_dimacs(std::uint64_t vars, std::uint64_t clauses, unsigned k,
+    std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<std::uint64_t> var(1, vars);
+
+    std::string text = "p cnf " + std::to_string(vars) + " "
+        + std::to_string(clauses) + "\n";
+    for (std::uint64_t i = 0; i < clauses; ++i) {
+        for (unsigned j = 0; j < k; ++j) {
+            if (rng() & 1) {
+                text += '-';
+            }
+            text += std::to_string(var(rng));
+            text += ' ';
+        }
+        text += "0\n";
+    }
+    return text;
+}
+
+// Parsing throughput with 1, 2, 4, ... threads
+int bench_parse(const Args& args)
+{
+    auto clauses = get_uint(args, "clauses", 4000000);
+    auto vars = get_uint(args, "vars", clauses / 4 + 1);
+    auto max_threads = static_cast<unsigned>(get_uint(args, "max-threads",
+        std::max(16u, std::thread::hardware_concurrency())));
+    auto repeat = get_uint(args, "repeat", 3);
+    auto input = get_string(args, "input");
+
+    std::string generated;
+    tools::MappedFile file;
+    const char* begin;
+    const char* end;
+    if (input.empty()) {
+        std::cout << "generating " << clauses << " random 3-clauses over "
+                  << vars << " variables" << std::endl;
+        generated = random_dimacs(vars, clauses, 3, 1);
+        begin = generated.data();
+        end = generated.data() + generated.size();
+    } else {
+        file = tools::MappedFile(input);
+        begin = file.begin();
+        end = file.end();
+    }
+    double megabytes = static_cast<double>(end - begin) / 1e6;
+
+    std::cout << "input: " << std::fixed << std::setprecision(1) << megabytes
+              << " MB, hardware threads: " << std::thread::hardware_concurrency()
+              << "\n\n"
+              << std::setw(8) << "threads" << std::setw(12) << "seconds"
+              << std::setw(12) << "MB/s" << std::setw(10) << "speedup" << "\n";
+
+    double single = 0;
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        double best = 1e300;
+        std::size_t parsed = 0;
+        for (std::uint64_t r = 0; r < repeat; ++r) {
+            auto start = std::chrono::steady_clock::now();
+            auto cnf = dimacs::parse_parallel<mini::Lit>(begin, end, threads);
+            best = std::min(best, seconds_since(start));
+            parsed = cnf.num_clauses();
+        }
+        if (threads == 1) {
+            single = best;
+        }
+
+        std::cout << std::setw(8) << threads
+                  << std::setw(12) << std::setprecision(4) << best
+                  << std::setw(12) << std::setprecision(1) << megabytes / best
+                  << std::setw(9) << std::setprecision(2) << single / best << "x"
+                  << "   (" << parsed << " clauses)" << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
+
+// Loading the same formula from DIMACS and from both binary encodings
+int bench_load(const Args& args)
+{
+    auto clauses = get_uint(args, "clauses", 4000000);
+    auto vars = get_uint(args, "vars", clauses / 4 + 1);
+    auto repeat = get_uint(args, "repeat", 3);
+    auto dir = get_string(args, "dir");
+    if (dir.empty()) {
+        dir = ".";
+    }
+
+    std::cout << "generating " << clauses << " random 3-clauses over "
+              << vars << " variables" << std::endl;
+    auto text = random_dimacs(vars, clauses, 3, 1);
+    auto cnf = dimacs::parse_parallel<mini::Lit>(text.data(), text.data() + text.size(), 1);
+
+    const std::string raw_path = dir + "/hubero-bench-raw.bin";
+    const std::string delta_path = dir + "/hubero-bench-delta.bin";
+    binary::write_file(raw_path, cnf, binary::Encoding::raw);
+    binary::write_file(delta_path, cnf, binary::Encoding::delta);
+
+    struct Row {
+        const char* name;
+        std::size_t bytes;
+        std::function<std::size_t()> load;
+    };
+    const Row rows[] = {
+        {"dimacs", text.size(), [&]() {
+            return dimacs::parse_parallel<mini::Lit>(
+                text.data(), text.data() + text.size(), 1).num_lits();
+        }},
+        {"raw (mapped)", tools::MappedFile(raw_path).size(), [&]() {
+            // touch every literal, as a solver would
+            binary::MappedCnf mapped(raw_path);
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < mapped.num_clauses(); ++i) {
+                for (auto lit : mapped.clause(i)) {
+                    count += static_cast<unsigned>(lit) > 1; // variable 0 is unused
+                }
+            }
+            return count;
+        }},
+        {"raw (copied)", tools::MappedFile(raw_path).size(), [&]() {
+            return binary::MappedCnf(raw_path).to_cnf().num_lits();
+        }},
+        {"delta (copied)", tools::MappedFile(delta_path).size(), [&]() {
+            return binary::MappedCnf(delta_path).to_cnf().num_lits();
+        }},
+    };
+
+    std::cout << "\n" << std::setw(16) << "format" << std::setw(12) << "MB"
+              << std::setw(12) << "seconds" << std::setw(10) << "speedup" << "\n";
+    double baseline = 0;
+    for (const auto& row : rows) {
+        double best = 1e300;
+        for (std::uint64_t r = 0; r < repeat; ++r) {
+            auto start = std::chrono::steady_clock::now();
+            if (row.load() != cnf.num_lits()) {
+                throw std::logic_error("benchmark loaded a different formula");
+            }
+            best = std::min(best, seconds_since(start));
+        }
+        if (baseline == 0) {
+            baseline = best;
+        }
+        std::cout << std::setw(16) << row.name
+                  << std::setw(12) << std::fixed << std::setprecision(1)
+                  << static_cast<double>(row.bytes) / 1e6
+                  << std::setw(12) << std::setprecision(4) << best
+                  << std::setw(9) << std::setprecision(1) << baseline / best << "x"
+                  << std::endl;
+    }
+
+    std::remove(raw_path.c_str());
+    std::remove(delta_path.c_str());
+    return EXIT_SUCCESS;
+}
+
+// Formatting a formula as DIMACS: to_string() into a stream vs. the writer
+int bench_write(const Args& args)
+{
+    auto clauses = get_uint(args, "clauses", 4000000);
+    auto vars = get_uint(args, "vars", clauses / 4 + 1);
+    auto repeat = get_uint(args, "repeat", 3);
+
+    std::cout << "generating " << clauses << " random 3-clauses over "
+              << vars << " variables" << std::endl;
+    auto text = random_dimacs(vars, clauses, 3, 1);
+    auto cnf = dimacs::parse_parallel<mini::Lit>(text.data(), text.data() + text.size(), 1);
+
+    struct Row {
+        const char* name;
+        std::function<std::size_t()> write;
+    };
+    const Row rows[] = {
+        {"to_string", [&]() {
+            std::ostringstream out;
+            out << "p cnf " << cnf.num_vars() << " " << cnf.num_clauses() << "\n";
+            for (auto clause : cnf) {
+                for (auto lit : clause) {
+                    out << lit.to_string() << " ";
+                }
+                out << "0\n";
+            }
+            return out.str().size();
+        }},
+        {"DimacsWriter", [&]() {
+            std::ostringstream out;
+            dimacs::StreamWriter writer{dimacs::StreamSink(out)};
+            writer.write(cnf);
+            writer.flush();
+            return out.str().size();
+        }},
+    };
+
+    std::cout << "\n" << std::setw(16) << "method" << std::setw(12) << "seconds"
+              << std::setw(12) << "MB/s" << std::setw(10) << "speedup" << "\n";
+    double baseline = 0;
+    for (const auto& row : rows) {
+        double best = 1e300;
+        std::size_t bytes = 0;
+        for (std::uint64_t r = 0; r < repeat; ++r) {
+            auto start = std::chrono::steady_clock::now();
+            bytes = row.write();
+            best = std::min(best, seconds_since(start));
+        }
+        if (baseline == 0) {
+            baseline = best;
+        }
+        std::cout << std::setw(16) << row.name
+                  << std::setw(12) << std::fixed << std::setprecision(4) << best
+                  << std::setw(12) << std::setprecision(1)
+                  << static_cast<double>(bytes) / 1e6 / best
+                  << std::setw(9) << baseline / best << "x" << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
+
+// Model checking, scalar vs. vectorized, on a random k-CNF satisfied by a
+// planted model
+int bench_check(const Args& args)
+{
+    auto clauses = get_uint(args, "clauses", 4000000);
+    auto vars = get_uint(args, "vars", clauses / 4 + 1);
+    auto k = static_cast<unsigned>(get_uint(args, "k", 3));
+    auto repeat = get_uint(args, "repeat", 5);
+
+    std::cout << "generating " << clauses << " random " << k << "-clauses over "
+              << vars << " variables" << std::endl;
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<unsigned> var(1, static_cast<unsigned>(vars));
+
+    Assignment model(Var(static_cast<unsigned>(vars)));
+    for (unsigned v = 1; v <= vars; ++v) {
+        model.assign(mini::Lit(Var(v), rng() % 2 == 0));
+    }
+    Cnf cnf;
+    cnf.set_num_vars(vars);
+    std::vector<mini::Lit> clause(k);
+    for (std::uint64_t c = 0; c < clauses; ++c) {
+        for (auto& lit : clause) {
+            lit = mini::Lit(Var(var(rng)), rng() % 2 == 0);
+        }
+        // the last literal satisfies the clause, so that all are checked
+        auto& last = clause.back();
+        last = model.is_true(last) ? last : ~last;
+        cnf.add_clause(tools::Span<const mini::Lit>(clause.data(), clause.size()));
+    }
+
+    std::cout << "\n" << std::setw(10) << "isa" << std::setw(12) << "seconds"
+              << std::setw(16) << "Mclauses/s" << std::setw(10) << "speedup" << "\n";
+    double baseline = 0;
+    const simd::Isa isas[] = {simd::Isa::scalar, simd::Isa::avx2};
+    for (auto isa : isas) {
+        if (!simd::supports(isa)) {
+            continue;
+        }
+        double best = 1e300;
+        for (std::uint64_t r = 0; r < repeat; ++r) {
+            auto start = std::chrono::steady_clock::now();
+            if (!check_model(cnf, model, isa)) {
+                throw std::logic_error("the planted model does not satisfy the formula");
+            }
+            best = std::min(best, seconds_since(start));
+        }
+        if (baseline == 0) {
+            baseline = best;
+        }
+        std::cout << std::setw(10) << simd::to_string(isa)
+                  << std::setw(12) << std::fixed << std::setprecision(4) << best
+                  << std::setw(16) << std::setprecision(1)
+                  << static_cast<double>(clauses) / 1e6 / best
+                  << std::setw(9) << baseline / best << "x" << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
+
+// Propagation speed: random decisions, each one propagated, restarting
+// from level 0 after conflicts and full assignments
+int bench_propagate(const Args& args)
+{
+    auto input = get_string(args, "input");
+    auto decisions = get_uint(args, "decisions", 2000000);
+    auto repeat = get_uint(args, "repeat", 3);
+
+    Cnf cnf;
+    if (input.empty()) {
+        auto vars = get_uint(args, "vars", 200000);
+        auto clauses = get_uint(args, "clauses", vars * 426 / 100);
+        std::cout << "generating " << clauses << " random 3-clauses over "
+                  << vars << " variables" << std::endl;
+        auto text = random_dimacs(vars, clauses, 3, 1);
+        cnf = dimacs::parse_parallel<mini::Lit>(text.data(), text.data() + text.size(), 1);
+    } else {
+        cnf = dimacs::read_file<mini::Lit>(input);
+    }
+
+    // the watched clauses must have distinct literals, units go to level 0
+    Propagator prop;
+    prop.grow_to(Var(static_cast<unsigned>(cnf.num_vars())));
+    std::vector<mini::Lit> lits;
+    std::vector<mini::Lit> units;
+    for (auto clause : cnf) {
+        lits.assign(clause.begin(), clause.end());
+        std::sort(lits.begin(), lits.end());
+        lits.erase(std::unique(lits.begin(), lits.end()), lits.end());
+        bool tautology = false;
+        for (std::size_t i = 1; i < lits.size(); ++i) {
+            tautology = tautology || lits[i] == ~lits[i - 1];
+        }
+        if (tautology) {
+            continue;
+        } else if (lits.size() == 1) {
+            units.push_back(lits[0]);
+        } else if (lits.size() > 1) {
+            prop.add_clause(tools::Span<const mini::Lit>(lits.data(), lits.size()));
+        }
+    }
+    bool refuted = false;
+    for (auto unit : units) {
+        if (prop.value(unit) == Value::undef) {
+            prop.assign(unit, ClauseRef());
+        }
+        refuted = refuted || prop.value(unit) == Value::false_;
+    }
+    if (refuted || prop.propagate().valid()) {
+        std::cout << "the formula is refuted by unit propagation" << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    auto vars = static_cast<unsigned>(cnf.num_vars());
+    std::cout << "formula: " << vars << " variables, " << cnf.num_clauses()
+              << " clauses (" << prop.arena().num_clauses() << " watched)\n\n"
+              << std::setw(12) << "decisions" << std::setw(12) << "conflicts"
+              << std::setw(14) << "propagations" << std::setw(12) << "seconds"
+              << std::setw(14) << "Mprops/s" << "\n";
+
+    std::vector<unsigned> order;
+    for (unsigned v = 1; v <= vars; ++v) {
+        order.push_back(v);
+    }
+
+    for (std::uint64_t r = 0; r < repeat; ++r) {
+        std::mt19937 rng(static_cast<std::uint32_t>(r + 1));
+        std::uint64_t conflicts = 0;
+        auto before = prop.propagations();
+
+        // decisions follow a random order of the variables, reshuffled
+        // after each descent
+        auto start = std::chrono::steady_clock::now();
+        std::size_t next = order.size();
+        for (std::uint64_t d = 0; d < decisions; ++d) {
+            while (next < order.size() && prop.value(Var(order[next])) != Value::undef) {
+                ++next;
+            }
+            if (next == order.size()) {
+                prop.backtrack(0);
+                std::shuffle(order.begin(), order.end(), rng);
+                next = 0;
+                continue;
+            }
+            prop.decide(mini::Lit(Var(order[next]), rng() % 2 == 0));
+            if (prop.propagate().valid()) {
+                ++conflicts;
+                prop.backtrack(0);
+                std::shuffle(order.begin(), order.end(), rng);
+                next = 0;
+            }
+        }
+        auto seconds = seconds_since(start);
+        prop.backtrack(0);
+
+        auto propagations = prop.propagations() - before;
+        std::cout << std::setw(12) << decisions << std::setw(12) << conflicts
+                  << std::setw(14) << propagations
+                  << std::setw(12) << std::fixed << std::setprecision(4) << seconds
+                  << std::setw(14) << std::setprecision(2)
+                  << static_cast<double>(propagations) / 1e6 / seconds << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
+
+struct SolveRun {
+    Result result;
+    std::vector<dimacs::Lit> model;
+    SolverStats stats;
+    std::vector<RestartRecord> restarts;
+};
+
+template<class S>
+SolveRun solve_cnf(const Cnf& cnf, const SolverOptions& options)
+{
+    S solver;
+    solver.options() = options;
+    solver.add_cnf(cnf);
+    SolveRun run;
+    run.result = solver.solve();
+    run.model = solver.model();
+    run.stats = solver.stats();
+    run.restarts = solver.restart_log();
+    return run;
+}
+
+template<class Heuristic>
+SolveRun solve_cnf(const Cnf& cnf, const SolverOptions& options, const std::string& restarts)
+{
+    if (restarts == "luby") {
+        return solve_cnf<SolverT<Heuristic, LubyRestarts>>(cnf, options);
+    } else if (restarts == "geometric") {
+        return solve_cnf<SolverT<Heuristic, GeometricRestarts>>(cnf, options);
+    }
+    return solve_cnf<SolverT<Heuristic, GlucoseRestarts>>(cnf, options);
+}
+
+// Solving random 3-SAT near the threshold (or the input), with the models
+// verified
+int bench_solve(const Args& args)
+{
+    auto input = get_string(args, "input");
+    auto vars = get_uint(args, "vars", 200);
+    auto clauses = get_uint(args, "clauses", vars * 426 / 100);
+    auto instances = input.empty() ? get_uint(args, "instances", 10) : 1;
+    auto heuristic = get_string(args, "heuristic");
+    if (!heuristic.empty() && heuristic != "evsids" && heuristic != "vmtf") {
+        throw UsageError("--heuristic expects evsids or vmtf");
+    }
+    auto restarts = get_string(args, "restarts");
+    if (!restarts.empty() && restarts != "glucose" && restarts != "luby"
+        && restarts != "geometric") {
+        throw UsageError("--restarts expects glucose, luby or geometric");
+    }
+    auto trace = get_string(args, "trace");
+
+    SolverOptions options;
+    options.trace_restarts = !trace.empty();
+    auto phases = get_string(args, "target-phases");
+    if (phases == "off") {
+        options.target_phases = false;
+    } else if (!phases.empty() && phases != "on") {
+        throw UsageError("--target-phases expects on or off");
+    }
+    auto reduce = get_string(args, "reduce");
+    if (reduce == "off") {
+        options.reduce_first = std::numeric_limits<std::uint64_t>::max() / 2;
+    } else if (!reduce.empty() && reduce != "on") {
+        throw UsageError("--reduce expects on or off");
+    }
+    auto probe = get_string(args, "probe");
+    if (probe == "off") {
+        options.probe_interval = 0;
+    } else if (!probe.empty() && probe != "on") {
+        throw UsageError("--probe expects on or off");
+    }
+    auto vivify = get_string(args, "vivify");
+    if (vivify == "off") {
+        options.vivify_interval = 0;
+    } else if (!vivify.empty() && vivify != "on") {
+        throw UsageError("--vivify expects on or off");
+    }
+
+    std::cout << std::setw(10) << "instance" << std::setw(16) << "result"
+              << std::setw(12) << "conflicts" << std::setw(12) << "seconds"
+              << std::setw(12) << "Mprops/s" << std::setw(10) << "learnts"
+              << std::setw(12) << "MB freed" << std::setw(10) << "restarts"
+              << std::setw(10) << "probes" << std::setw(10) << "failed"
+              << std::setw(10) << "HBRs" << std::setw(12) << "viv lits"
+              << std::setw(12) << "viv lits/s" << "\n";
+    std::ofstream trace_file;
+    if (!trace.empty()) {
+        trace_file.open(trace);
+        trace_file << "instance,conflicts,interval,level\n";
+    }
+    double total = 0;
+    for (std::uint64_t i = 0; i < instances; ++i) {
+        Cnf cnf;
+        if (input.empty()) {
+            auto text = random_dimacs(vars, clauses, 3, static_cast<std::uint32_t>(i + 1));
+            cnf = dimacs::parse_parallel<mini::Lit>(text.data(), text.data() + text.size(), 1);
+        } else {
+            cnf = dimacs::read_file<mini::Lit>(input);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        auto run = heuristic == "vmtf"
+            ? solve_cnf<Vmtf>(cnf, options, restarts)
+            : solve_cnf<Evsids>(cnf, options, restarts);
+        auto seconds = seconds_since(start);
+        total += seconds;
+        auto result = run.result;
+        const auto& stats = run.stats;
+
+        for (const auto& restart : run.restarts) {
+            trace_file << i + 1 << "," << restart.conflicts << "," << restart.interval
+                       << "," << restart.level << "\n";
+        }
+        if (result == Result::sat) {
+            Assignment model(Var(static_cast<unsigned>(cnf.num_vars())));
+            for (auto lit : run.model) {
+                model.assign(Solver::to_mini(lit));
+            }
+            if (!check_model(cnf, model)) {
+                throw std::logic_error("the solver's model does not satisfy the formula");
+            }
+        }
+
+        std::cout << std::setw(10) << i + 1 << std::setw(16) << to_string(result)
+                  << std::setw(12) << stats.conflicts
+                  << std::setw(12) << std::fixed << std::setprecision(4) << seconds
+                  << std::setw(12) << std::setprecision(2)
+                  << static_cast<double>(stats.propagations) / 1e6 / seconds
+                  << std::setw(10) << stats.learnt_clauses
+                  << std::setw(12) << static_cast<double>(stats.reclaimed_bytes) / 1e6
+                  << std::setw(10) << stats.restarts << std::setw(10) << stats.probes
+                  << std::setw(10) << stats.failed_literals
+                  << std::setw(10) << stats.hyper_binaries
+                  << std::setw(12) << stats.vivified_lits << std::setw(12) << std::setprecision(0)
+                  << (stats.vivify_seconds > 0 ? stats.vivified_lits / stats.vivify_seconds : 0.0)
+                  << std::endl;
+    }
+    std::cout << "\ntotal: " << std::setprecision(4) << total << " s" << std::endl;
+    return EXIT_SUCCESS;
+}
+
+// Random XORs of k variables over the given ones, in the direct CNF
+// encoding; with planted, all of them agree with a random assignment
+Cnf random_parity(std::uint64_t vars, std::uint64_t xors, unsigned k, bool planted,
+    std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<std::uint64_t> var(1, vars);
+    std::vector<bool> solution(vars + 1);
+    for (auto&& value : solution) {
+        value = rng() % 2 == 0;
+    }
+
+    Cnf cnf;
+    cnf.set_num_vars(vars);
+    std::vector<std::uint64_t> xor_vars;
+    std::vector<mini::Lit> clause;
+    for (std::uint64_t x = 0; x < xors; ++x) {
+        xor_vars.clear();
+        while (xor_vars.size() < k) {
+            auto v = var(rng);
+            if (std::find(xor_vars.begin(), xor_vars.end(), v) == xor_vars.end()) {
+                xor_vars.push_back(v);
+            }
+        }
+        unsigned parity = rng() % 2;
+        if (planted) {
+            parity = 0;
+            for (auto v : xor_vars) {
+                parity ^= solution[v] ? 1 : 0;
+            }
+        }
+        // one clause per assignment of the wrong parity
+        for (std::uint32_t pattern = 0; pattern < (1u << k); ++pattern) {
+            if (simd::popcount(pattern) % 2 == parity) {
+                continue;
+            }
+            clause.clear();
+            for (unsigned i = 0; i < k; ++i) {
+                clause.push_back(mini::Lit(Var(static_cast<unsigned>(xor_vars[i])),
+                    (pattern >> i & 1) == 0));
+            }
+            cnf.add_clause(tools::Span<const mini::Lit>(clause.data(), clause.size()));
+        }
+    }
+    return cnf;
+}
+
+// Parity problems with and without Gaussian elimination, models verified
+int bench_parity(const Args& args)
+{
+    auto input = get_string(args, "input");
+    auto vars = get_uint(args, "vars", 100);
+    auto xors = get_uint(args, "xors", vars);
+    auto k = static_cast<unsigned>(get_uint(args, "k", 3));
+    if (k < 3 || k > xor_size_limit) {
+        throw UsageError("--k expects 3 to " + std::to_string(xor_size_limit));
+    }
+    auto instances = input.empty() ? get_uint(args, "instances", 5) : 1;
+    auto conflicts = get_uint(args, "conflicts", 200000);
+    auto planted = get_string(args, "planted");
+    if (!planted.empty() && planted != "on" && planted != "off") {
+        throw UsageError("--planted expects on or off");
+    }
+
+    std::cout << std::setw(10) << "instance" << std::setw(8) << "XORs"
+              << std::setw(10) << "matrices" << std::setw(16) << "gauss"
+              << std::setw(12) << "conflicts" << std::setw(12) << "seconds"
+              << std::setw(14) << "eliminations" << std::setw(12) << "implied"
+              << std::setw(16) << "clauses only" << std::setw(12) << "conflicts"
+              << std::setw(12) << "seconds" << "\n";
+    for (std::uint64_t i = 0; i < instances; ++i) {
+        auto cnf = input.empty()
+            ? random_parity(vars, xors, k, planted == "on", static_cast<std::uint32_t>(i + 1))
+            : dimacs::read_file<mini::Lit>(input);
+
+        Result results[2];
+        SolverStats stats[2];
+        double seconds[2];
+        for (int gauss = 1; gauss >= 0; --gauss) {
+            Solver solver;
+            solver.options().xor_max_size = gauss ? xor_size_limit : 0;
+            solver.set_conflict_limit(conflicts);
+            solver.add_cnf(cnf);
+            auto start = std::chrono::steady_clock::now();
+            results[gauss] = solver.solve();
+            seconds[gauss] = seconds_since(start);
+            stats[gauss] = solver.stats();
+
+            if (results[gauss] == Result::sat) {
+                Assignment model(Var(static_cast<unsigned>(cnf.num_vars())));
+                for (auto lit : solver.model()) {
+                    model.assign(Solver::to_mini(lit));
+                }
+                if (!check_model(cnf, model)) {
+                    throw std::logic_error("the solver's model does not satisfy the formula");
+                }
+            }
+        }
+        if (results[0] != Result::unknown && results[1] != Result::unknown
+            && results[0] != results[1]) {
+            throw std::logic_error("the answers with and without Gaussian elimination differ");
+        }
+
+        std::cout << std::setw(10) << i + 1 << std::setw(8) << stats[1].xors
+                  << std::setw(10) << stats[1].xor_matrices
+                  << std::setw(16) << to_string(results[1]) << std::setw(12) << stats[1].conflicts
+                  << std::setw(12) << std::fixed << std::setprecision(4) << seconds[1]
+                  << std::setw(14) << stats[1].gauss_eliminations
+                  << std::setw(12) << stats[1].gauss_propagations
+                  << std::setw(16) << to_string(results[0]) << std::setw(12) << stats[0].conflicts
+                  << std::setw(12) << seconds[0] << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
+
+// Repeated calls under random assumptions, as a model checker makes them:
+// one incremental solver vs. a fresh solver per call
+int bench_incremental(const Args& args)
+{
+    auto vars = get_uint(args, "vars", 150);
+    auto clauses = get_uint(args, "clauses", vars * 400 / 100);
+    auto calls = get_uint(args, "calls", 500);
+    auto assumed = get_uint(args, "assumptions", 3);
+    if (vars == 0) {
+        throw UsageError("--vars expects a positive number");
+    }
+
+    auto text = random_dimacs(vars, clauses, 3, 1);
+    auto cnf = dimacs::parse_parallel<mini::Lit>(text.data(), text.data() + text.size(), 1);
+    std::mt19937 rng(2);
+    std::uniform_int_distribution<unsigned> var(1, static_cast<unsigned>(vars));
+    std::vector<std::vector<mini::Lit>> assumptions(calls);
+    for (auto& call : assumptions) {
+        for (std::uint64_t i = 0; i < assumed; ++i) {
+            call.push_back(mini::Lit(Var(var(rng)), rng() % 2 == 0));
+        }
+    }
+
+    struct Row {
+        const char* name;
+        std::function<void(std::vector<Result>&, std::uint64_t&)> run;
+    };
+    const Row rows[] = {
+        {"from scratch", [&](std::vector<Result>& results, std::uint64_t& conflicts) {
+            for (const auto& call : assumptions) {
+                Solver solver;
+                solver.add_cnf(cnf);
+                for (auto lit : call) {
+                    solver.assume(lit);
+                }
+                results.push_back(solver.solve());
+                conflicts += solver.stats().conflicts;
+            }
+        }},
+        {"incremental", [&](std::vector<Result>& results, std::uint64_t& conflicts) {
+            Solver solver;
+            solver.add_cnf(cnf);
+            for (const auto& call : assumptions) {
+                for (auto lit : call) {
+                    solver.assume(lit);
+                }
+                results.push_back(solver.solve());
+            }
+            conflicts = solver.stats().conflicts;
+        }},
+    };
+
+    std::cout << vars << " variables, " << clauses << " clauses, " << calls
+              << " calls with " << assumed << " assumptions\n\n"
+              << std::setw(16) << "solver" << std::setw(12) << "unsat"
+              << std::setw(12) << "conflicts" << std::setw(12) << "seconds"
+              << std::setw(12) << "calls/s" << std::setw(10) << "speedup" << "\n";
+    std::vector<Result> reference;
+    double baseline = 0;
+    for (const auto& row : rows) {
+        std::vector<Result> results;
+        std::uint64_t conflicts = 0;
+        auto start = std::chrono::steady_clock::now();
+        row.run(results, conflicts);
+        auto seconds = seconds_since(start);
+        if (reference.empty()) {
+            reference = results;
+            baseline = seconds;
+        } else if (results != reference) {
+            throw std::logic_error("the incremental answers differ");
+        }
+        std::cout << std::setw(16) << row.name
+                  << std::setw(12) << std::count(results.begin(), results.end(), Result::unsat)
+                  << std::setw(12) << conflicts
+                  << std::setw(12) << std::fixed << std::setprecision(4) << seconds
+                  << std::setw(12) << std::setprecision(0) << static_cast<double>(calls) / seconds
+                  << std::setw(9) << std::setprecision(2) << baseline / seconds << "x" << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
+
+// Portfolio solving time with 1, 2, 4, ... threads, sharing on or off
+int bench_portfolio(const Args& args)
+{
+    auto input = get_string(args, "input");
+    auto vars = get_uint(args, "vars", 250);
+    auto clauses = get_uint(args, "clauses", vars * 426 / 100);
+    auto instances = input.empty() ? get_uint(args, "instances", 4) : 1;
+    auto max_threads = get_uint(args, "max-threads",
+        std::max(1u, std::thread::hardware_concurrency()));
+    auto share = get_string(args, "share");
+    if (!share.empty() && share != "on" && share != "off") {
+        throw UsageError("--share expects on or off");
+    }
+
+    std::vector<Cnf> formulas;
+    for (std::uint64_t i = 0; i < instances; ++i) {
+        if (input.empty()) {
+            auto text = random_dimacs(vars, clauses, 3, static_cast<std::uint32_t>(i + 1));
+            formulas.push_back(dimacs::parse_parallel<mini::Lit>(
+                text.data(), text.data() + text.size(), 1));
+        } else {
+            formulas.push_back(dimacs::read_file<mini::Lit>(input));
+        }
+    }
+
+    std::cout << instances << " instances, " << std::thread::hardware_concurrency()
+              << " hardware threads\n\n"
+              << std::setw(10) << "threads" << std::setw(12) << "seconds"
+              << std::setw(10) << "speedup" << std::setw(12) << "conflicts"
+              << std::setw(12) << "exported" << std::setw(12) << "imported" << "\n";
+    double baseline = 0;
+    for (std::uint64_t threads = 1; threads <= max_threads; threads *= 2) {
+        PortfolioOptions options;
+        options.threads = static_cast<unsigned>(threads);
+        if (share == "off") {
+            options.export_lbd = 0;
+        }
+        double seconds = 0;
+        std::uint64_t conflicts = 0;
+        std::uint64_t exported = 0;
+        std::uint64_t imported = 0;
+        for (const auto& cnf : formulas) {
+            Portfolio portfolio(options);
+            auto start = std::chrono::steady_clock::now();
+            auto result = portfolio.solve(cnf);
+            seconds += seconds_since(start);
+
+            if (result == Result::sat) {
+                Assignment model(Var(static_cast<unsigned>(cnf.num_vars())));
+                for (auto lit : portfolio.model()) {
+                    model.assign(Solver::to_mini(lit));
+                }
+                if (!check_model(cnf, model)) {
+                    throw std::logic_error("the portfolio's model does not satisfy the formula");
+                }
+            }
+            for (const auto& worker : portfolio.worker_stats()) {
+                conflicts += worker.solver.conflicts;
+                exported += worker.exported;
+                imported += worker.imported;
+            }
+        }
+        if (baseline == 0) {
+            baseline = seconds;
+        }
+        std::cout << std::setw(10) << threads
+                  << std::setw(12) << std::fixed << std::setprecision(4) << seconds
+                  << std::setw(9) << std::setprecision(2) << baseline / seconds << "x"
+                  << std::setw(12) << conflicts << std::setw(12) << exported
+                  << std::setw(12) << imported << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
+
+// Cube-and-conquer with 1, 2, 4, ... threads vs. a single solver: cube
+// throughput, re-splitting, stealing and load balance
+int bench_cubes(const Args& args)
+{
+    auto input = get_string(args, "input");
+    auto vars = get_uint(args, "vars", 200);
+    auto clauses = get_uint(args, "clauses", vars * 426 / 100);
+    auto instances = input.empty() ? get_uint(args, "instances", 4) : 1;
+    auto max_threads = get_uint(args, "max-threads",
+        std::max(1u, std::thread::hardware_concurrency()));
+    CubeOptions options;
+    options.initial_depth = static_cast<unsigned>(get_uint(args, "depth", 0));
+    options.cube_conflicts = get_uint(args, "cube-conflicts", options.cube_conflicts);
+
+    std::vector<Cnf> formulas;
+    for (std::uint64_t i = 0; i < instances; ++i) {
+        if (input.empty()) {
+            auto text = random_dimacs(vars, clauses, 3, static_cast<std::uint32_t>(i + 1));
+            formulas.push_back(dimacs::parse_parallel<mini::Lit>(
+                text.data(), text.data() + text.size(), 1));
+        } else {
+            formulas.push_back(dimacs::read_file<mini::Lit>(input));
+        }
+    }
+
+    std::vector<Result> expected;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& cnf : formulas) {
+        Solver solver;
+        solver.add_cnf(cnf);
+        expected.push_back(solver.solve());
+    }
+    auto single = seconds_since(start);
+
+    std::cout << instances << " instances, " << std::thread::hardware_concurrency()
+              << " hardware threads, a single solver takes " << std::fixed
+              << std::setprecision(4) << single << " s\n\n"
+              << std::setw(10) << "threads" << std::setw(12) << "seconds"
+              << std::setw(10) << "speedup" << std::setw(10) << "initial"
+              << std::setw(10) << "cubes" << std::setw(10) << "splits"
+              << std::setw(10) << "stolen" << std::setw(10) << "cubes/s"
+              << std::setw(11) << "imbalance" << "\n";
+    for (std::uint64_t threads = 1; threads <= max_threads; threads *= 2) {
+        options.threads = static_cast<unsigned>(threads);
+        double seconds = 0;
+        double imbalance = 0;
+        std::uint64_t initial = 0;
+        std::uint64_t cubes = 0;
+        std::uint64_t splits = 0;
+        std::uint64_t stolen = 0;
+        for (std::size_t i = 0; i < formulas.size(); ++i) {
+            CubeAndConquer solver(options);
+            auto result = solver.solve(formulas[i]);
+            if (result != expected[i]) {
+                throw std::logic_error("cube-and-conquer disagrees with the solver");
+            }
+            if (result == Result::sat) {
+                Assignment model(Var(static_cast<unsigned>(formulas[i].num_vars())));
+                for (auto lit : solver.model()) {
+                    model.assign(Solver::to_mini(lit));
+                }
+                if (!check_model(formulas[i], model)) {
+                    throw std::logic_error("the cube's model does not satisfy the formula");
+                }
+            }
+            seconds += solver.seconds();
+            imbalance = std::max(imbalance, solver.load_imbalance());
+            initial += solver.num_initial_cubes();
+            for (const auto& worker : solver.worker_stats()) {
+                cubes += worker.cubes;
+                splits += worker.splits;
+                stolen += worker.stolen;
+            }
+        }
+        std::cout << std::setw(10) << threads
+                  << std::setw(12) << std::setprecision(4) << seconds
+                  << std::setw(9) << std::setprecision(2) << single / seconds << "x"
+                  << std::setw(10) << initial << std::setw(10) << cubes
+                  << std::setw(10) << splits << std::setw(10) << stolen
+                  << std::setw(10) << std::setprecision(0) << static_cast<double>(cubes) / seconds
+                  << std::setw(11) << std::setprecision(2) << imbalance << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
+
+// Subsumption and self-subsuming resolution on a random 3-CNF salted with
+// supersets of its clauses, some of them with a literal negated
+int bench_subsume(const Args& args)
+{
+    auto input = get_string(args, "input");
+    auto clauses = get_uint(args, "clauses", 1000000);
+    auto vars = get_uint(args, "vars", clauses / 4 + 1);
+
+    Cnf cnf;
+    if (input.empty()) {
+        std::mt19937 rng(1);
+        std::uniform_int_distribution<unsigned> var(1, static_cast<unsigned>(vars));
+        cnf.set_num_vars(vars);
+        std::vector<mini::Lit> clause;
+        while (cnf.num_clauses() < clauses) {
+            clause.clear();
+            for (int k = 0; k < 3; ++k) {
+                clause.push_back(mini::Lit(Var(var(rng)), rng() % 2 == 0));
+            }
+            cnf.add_clause(tools::Span<const mini::Lit>(clause.data(), clause.size()));
+            auto salt = rng() % 8;
+            if (salt < 3) {
+                if (salt == 0) {
+                    clause[0] = ~clause[0];
+                }
+                clause.push_back(mini::Lit(Var(var(rng)), rng() % 2 == 0));
+                clause.push_back(mini::Lit(Var(var(rng)), rng() % 2 == 0));
+                cnf.add_clause(tools::Span<const mini::Lit>(clause.data(), clause.size()));
+            }
+        }
+    } else {
+        cnf = dimacs::read_file<mini::Lit>(input);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Simplifier simplifier(cnf);
+    auto loading = seconds_since(start);
+    start = std::chrono::steady_clock::now();
+    simplifier.subsume();
+    auto seconds = seconds_since(start);
+
+    const auto& stats = simplifier.stats();
+    auto candidates = stats.signature_rejects + stats.subsumption_checks;
+    std::cout << std::fixed << std::setprecision(4)
+              << "clauses:              " << cnf.num_clauses() << " -> " << simplifier.num_clauses() << "\n"
+              << "subsumed:             " << stats.subsumed_clauses << "\n"
+              << "strengthened:         " << stats.strengthened_clauses << "\n"
+              << "candidate pairs:      " << candidates << "\n"
+              << "rejected by signature " << std::setprecision(1)
+              << (candidates > 0 ? 100.0 * static_cast<double>(stats.signature_rejects)
+                  / static_cast<double>(candidates) : 0.0) << " %\n"
+              << "occurrence lists:     " << std::setprecision(4) << loading << " s\n"
+              << "subsumption:          " << seconds << " s, " << std::setprecision(2)
+              << static_cast<double>(cnf.num_clauses()) / 1e6 / seconds << " Mclauses/s" << std::endl;
+    return EXIT_SUCCESS;
+}
+
+// Local search on random 3-SAT below the threshold (or the input), scalar
+// vs. SIMD break counts, models verified
+int bench_sls(const Args& args)
+{
+    auto input = get_string(args, "input");
+    auto vars = get_uint(args, "vars", 50000);
+    auto clauses = get_uint(args, "clauses", vars * 400 / 100);
+    auto instances = input.empty() ? get_uint(args, "instances", 3) : 1;
+    auto max_flips = get_uint(args, "flips", 20000000);
+    auto heuristic = get_string(args, "heuristic");
+    if (!heuristic.empty() && heuristic != "probsat" && heuristic != "walksat") {
+        throw UsageError("--heuristic expects probsat or walksat");
+    }
+
+    LocalSearchOptions options;
+    options.walksat = heuristic == "walksat";
+    std::cout << std::setw(10) << "instance" << std::setw(10) << "isa"
+              << std::setw(16) << "result" << std::setw(14) << "flips"
+              << std::setw(12) << "seconds" << std::setw(12) << "Mflips/s"
+              << std::setw(12) << "best unsat" << "\n";
+    for (std::uint64_t i = 0; i < instances; ++i) {
+        Cnf cnf;
+        if (input.empty()) {
+            auto text = random_dimacs(vars, clauses, 3, static_cast<std::uint32_t>(i + 1));
+            cnf = dimacs::parse_parallel<mini::Lit>(text.data(), text.data() + text.size(), 1);
+        } else {
+            cnf = dimacs::read_file<mini::Lit>(input);
+        }
+
+        for (auto isa : {simd::Isa::scalar, simd::best_isa()}) {
+            LocalSearch sls(options, isa);
+            sls.add_cnf(cnf);
+            auto result = sls.solve(max_flips);
+            if (result == Result::sat && !check_model(cnf, sls.assignment())) {
+                throw std::logic_error("the local search's model does not satisfy the formula");
+            }
+
+            const auto& stats = sls.stats();
+            std::cout << std::setw(10) << i + 1 << std::setw(10) << simd::to_string(isa)
+                      << std::setw(16) << to_string(result) << std::setw(14) << stats.flips
+                      << std::setw(12) << std::fixed << std::setprecision(4) << stats.seconds
+                      << std::setw(12) << std::setprecision(2) << stats.flips_per_second() / 1e6
+                      << std::setw(12) << stats.best_unsatisfied << std::endl;
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+// Drives a decision heuristic like a solver would: decisions until a
+// simulated conflict, which bumps recent variables and backjumps. Returns
+// the number of heuristic calls.
+template<class Heuristic>
+std::uint64_t run_decisions(Heuristic& heuristic, unsigned vars, std::uint64_t conflicts,
+    std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    Assignment values{Var(vars)};
+    std::vector<Var> trail;
+    heuristic.grow_to(Var(vars));
+
+    std::uint64_t calls = 0;
+    for (std::uint64_t c = 0; c < conflicts; ++c) {
+        // descend by a few dozen decisions
+        auto depth = trail.size() + 16 + rng() % 48;
+        while (trail.size() < depth) {
+            auto var = heuristic.next(values);
+            ++calls;
+            if (static_cast<unsigned>(var) == 0) {
+                break;
+            }
+            values.assign(mini::Lit(var, false));
+            trail.push_back(var);
+        }
+
+        // bump recent variables, jump back half-way
+        for (int b = 0; b < 24 && !trail.empty(); ++b) {
+            heuristic.bump(trail[trail.size() - 1 - rng() % std::min<std::size_t>(trail.size(), 64)]);
+            ++calls;
+        }
+        auto keep = trail.size() / 2;
+        while (trail.size() > keep) {
+            values.unassign(trail.back());
+            heuristic.unassigned(trail.back());
+            trail.pop_back();
+            ++calls;
+        }
+        heuristic.after_conflict(values);
+        ++calls;
+    }
+    return calls;
+}
+
+// Decision heuristics: EVSIDS heaps of several arities vs. VMTF
+int bench_heap(const Args& args)
+{
+    auto vars = static_cast<unsigned>(get_uint(args, "vars", 1000000));
+    auto conflicts = get_uint(args, "conflicts", 200000);
+    auto repeat = get_uint(args, "repeat", 3);
+
+    struct Row {
+        const char* name;
+        std::function<std::uint64_t()> run;
+    };
+    const Row rows[] = {
+        {"evsids, 2-ary", [&]() {
+            EvsidsT<2> heuristic;
+            return run_decisions(heuristic, vars, conflicts, 1);
+        }},
+        {"evsids, 4-ary", [&]() {
+            EvsidsT<4> heuristic;
+            return run_decisions(heuristic, vars, conflicts, 1);
+        }},
+        {"evsids, 8-ary", [&]() {
+            EvsidsT<8> heuristic;
+            return run_decisions(heuristic, vars, conflicts, 1);
+        }},
+        {"vmtf", [&]() {
+            Vmtf heuristic;
+            return run_decisions(heuristic, vars, conflicts, 1);
+        }},
+    };
+
+    std::cout << vars << " variables, " << conflicts << " simulated conflicts\n\n"
+              << std::setw(16) << "heuristic" << std::setw(12) << "seconds"
+              << std::setw(14) << "Mops/s" << std::setw(10) << "speedup" << "\n";
+    double baseline = 0;
+    for (const auto& row : rows) {
+        double best = 1e300;
+        std::uint64_t calls = 0;
+        for (std::uint64_t r = 0; r < repeat; ++r) {
+            auto start = std::chrono::steady_clock::now();
+            calls = row.run();
+            best = std::min(best, seconds_since(start));
+        }
+        if (baseline == 0) {
+            baseline = best;
+        }
+        std::cout << std::setw(16) << row.name
+                  << std::setw(12) << std::fixed << std::setprecision(4) << best
+                  << std::setw(14) << std::setprecision(2)
+                  << static_cast<double>(calls) / 1e6 / best
+                  << std::setw(9) << baseline / best << "x" << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
+
+struct Benchmark {
+    const char* name;
+    int (*run)(const Args&);
+    const char* help;
+};
+
+const Benchmark benchmarks[] = {
+    {"parse", bench_parse,
+        "DIMACS parsing throughput by thread count\n"
+        "      --input <file.cnf>  --clauses <n>  --vars <n>  --max-threads <n>  --repeat <n>"},
+    {"load", bench_load,
+        "loading DIMACS vs. the binary formats\n"
+        "      --clauses <n>  --vars <n>  --repeat <n>  --dir <temporary directory>"},
+    {"check", bench_check,
+        "model checking, scalar vs. SIMD\n"
+        "      --clauses <n>  --vars <n>  --k <n>  --repeat <n>"},
+    {"write", bench_write,
+        "DIMACS output throughput, to_string() vs. the buffered writer\n"
+        "      --clauses <n>  --vars <n>  --repeat <n>"},
+    {"propagate", bench_propagate,
+        "unit propagation speed under random decisions\n"
+        "      --input <file.cnf>  --vars <n>  --clauses <n>  --decisions <n>  --repeat <n>"},
+    {"solve", bench_solve,
+        "CDCL solving time and propagation rate, models verified\n"
+        "      --input <file.cnf>  --vars <n>  --clauses <n>  --instances <n>\n"
+        "      --heuristic <evsids|vmtf>  --restarts <glucose|luby|geometric>\n"
+        "      --target-phases <on|off>  --reduce <on|off>  --probe <on|off>\n"
+        "      --vivify <on|off>  --trace <restarts.csv>"},
+    {"parity", bench_parity,
+        "random XOR systems (or the input), with and without Gaussian elimination\n"
+        "      --input <file.cnf>  --vars <n>  --xors <n>  --k <n>  --instances <n>\n"
+        "      --planted <on|off>  --conflicts <n>"},
+    {"incremental", bench_incremental,
+        "repeated solving under assumptions, incremental vs. from scratch\n"
+        "      --vars <n>  --clauses <n>  --calls <n>  --assumptions <n>"},
+    {"portfolio", bench_portfolio,
+        "parallel portfolio solving time by thread count, models verified\n"
+        "      --input <file.cnf>  --vars <n>  --clauses <n>  --instances <n>\n"
+        "      --max-threads <n>  --share <on|off>"},
+    {"cubes", bench_cubes,
+        "cube-and-conquer by thread count: cube throughput and load balance\n"
+        "      --input <file.cnf>  --vars <n>  --clauses <n>  --instances <n>\n"
+        "      --max-threads <n>  --depth <n>  --cube-conflicts <n>"},
+    {"subsume", bench_subsume,
+        "subsumption and strengthening: signature filtering and throughput\n"
+        "      --input <file.cnf>  --clauses <n>  --vars <n>"},
+    {"sls", bench_sls,
+        "local search flips per second, scalar vs. SIMD break counts, models verified\n"
+        "      --input <file.cnf>  --vars <n>  --clauses <n>  --instances <n>  --flips <n>\n"
+        "      --heuristic <probsat|walksat>"},
+    {"heap", bench_heap,
+        "decision heuristic operations per second, EVSIDS heaps vs. VMTF\n"
+        "      --vars <n>  --conflicts <n>  --repeat <n>"},
+};
+
+void print_usage(std::ostream& out)
+{
+    out << "usage: hubero-bench <benchmark> [--option value]...\n\nbenchmarks:\n";
+    for (const auto& bench : benchmarks) {
+        out << "  " << bench.name << "    " << bench.help << "\n";
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    try {
+        if (argc < 2 || std::string(argv[1]) == "-h" || std::string(argv[1]) == "--help") {
+            print_usage(std::cout);
+            return argc < 2 ? 2 : EXIT_SUCCESS;
+        }
+
+        Args args;
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg.size() < 3 || arg.compare(0, 2, "--") != 0 || i + 1 == argc) {
+                throw UsageError("expected --option value, got '" + arg + "'");
+            }
+            args[arg.substr(2)] = argv[++i];
+        }
+
+        std::string name = argv[1];
+        for (const auto& bench : benchmarks) {
+            if (name == bench.name) {
+                return bench.run(args);
+            }
+        }
+        throw UsageError("unknown benchmark '" + name + "'");
+
+    } catch (const UsageError& error) {
+        std::cerr << "hubero-bench: " << error.what() << "\n\n";
+        print_usage(std::cerr);
+        return 2;
+    } catch (const std::exception& error) {
+        std::cerr << "hubero-bench: " << error.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -1,31 +1,330 @@
-// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
-//
-// This software is released under the MIT License.
-// https://opensource.org/licenses/MIT
-
-#include <hubero/core.hpp>
-
-#include <cstdint>
-#include <iostream>
-#include <utility>
-
-using namespace hubero;
-using namespace hubero::mini;
-
-int main(int, char**)
-{
-    try {
-        VarT<uint16_t> v(127);
-        std::cout << static_cast<uint16_t>(v) << std::endl;
-        VarT<uint8_t> w(v);
-        std::cout << static_cast<uint16_t>(v)
-           << " " << static_cast<uint16_t>(static_cast<uint8_t>(w)) << std::endl;
-
-        LitT<uint16_t> l(w, true);
-        std::cout << static_cast<uint16_t>(l) << std::endl;
-        static_cast<void>(LitT<uint8_t>(l));
-
-    } catch (std::out_of_range& oor) {
-        std::cout << oor.what() << std::endl;
-    }
-}
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#include <hubero/binary_cnf.hpp>
+#include <hubero/core.hpp>
+#include <hubero/dimacs_loader.hpp>
+#include <hubero/dimacs_writer.hpp>
+#include <hubero/simplifier.hpp>
+#include <hubero/solver.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace hubero;
+
+namespace {
+
+struct Options {
+    unsigned threads = 1;
+    binary::Encoding encoding = binary::Encoding::raw;
+    bool preprocess = false;
+    std::string reconstruct;
+    std::vector<std::string> args;
+};
+
+class UsageError : public std::runtime_error {
+public:
+    explicit UsageError(const std::string& what) : std::runtime_error(what) {}
+};
+
+void print_usage(std::ostream& out)
+{
+    out << "usage: hubero-main [options] <command> [arguments]\n"
+        << "\n"
+        << "commands:\n"
+        << "  parse <input>         parse a CNF file and print its statistics\n"
+        << "  convert <input> <output>\n"
+        << "                        convert DIMACS to the binary format or back\n"
+        << "  solve <input>         decide satisfiability, print the answer and a model\n"
+        << "  preprocess <input> <output> [<stack>]\n"
+        << "                        substitute equivalent literals, remove subsumed\n"
+        << "                        clauses, eliminate variables and blocked or\n"
+        << "                        covered clauses, write the simplified DIMACS and\n"
+        << "                        the reconstruction stack (see --reconstruct);\n"
+        << "                        the output alone is only equisatisfiable\n"
+        << "\n"
+        << "Inputs are DIMACS CNF (possibly compressed by gzip, xz or zstd) or binary\n"
+        << "files, recognized automatically. The solve command exits with 10 for\n"
+        << "satisfiable and 20 for unsatisfiable formulas.\n"
+        << "\n"
+        << "options:\n"
+        << "  -j, --threads <n>     number of parsing threads (0 = all cores, default 1)\n"
+        << "  -e, --encoding <e>    binary encoding: raw (default) or delta\n"
+        << "  -p, --preprocess      simplify the formula before solving (see preprocess)\n"
+        << "  -r, --reconstruct <stack>\n"
+        << "                        extend the model of a preprocessed formula to the\n"
+        << "                        original one, by the stack written by preprocess\n"
+        << "  -h, --help            print this help\n";
+}
+
+unsigned parse_unsigned(const std::string& option, const std::string& value)
+{
+    try {
+        std::size_t used = 0;
+        auto number = std::stoul(value, &used);
+        if (used == value.size()) {
+            return static_cast<unsigned>(number);
+        }
+    } catch (const std::logic_error&) {
+        // reported below
+    }
+    throw UsageError("option " + option + " expects a number, got '" + value + "'");
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double>(elapsed).count();
+}
+
+void expect_args(const Options& opts, std::size_t count, const char* command)
+{
+    if (opts.args.size() != count) {
+        throw UsageError(std::string("command '") + command + "' expects "
+            + std::to_string(count) + " argument(s)");
+    }
+}
+
+binary::Encoding parse_encoding(const std::string& option, const std::string& value)
+{
+    if (value == "raw") {
+        return binary::Encoding::raw;
+    } else if (value == "delta") {
+        return binary::Encoding::delta;
+    }
+    throw UsageError("option " + option + " expects raw or delta, got '" + value + "'");
+}
+
+// Reads a formula in either the DIMACS or the binary format
+Cnf load_formula(const Options& opts, const std::string& path)
+{
+    if (binary::is_binary_file(path)) {
+        return binary::MappedCnf(path).to_cnf();
+    }
+    return dimacs::read_file<mini::Lit>(path, opts.threads);
+}
+
+void write_dimacs(const std::string& path, const binary::MappedCnf& cnf)
+{
+    dimacs::FileWriter out{dimacs::FileSink(path)};
+    out.header(cnf.num_vars(), cnf.num_clauses());
+    cnf.for_each_clause([&](tools::Span<const mini::Lit> clause) {
+        out.clause(clause);
+    });
+    out.flush();
+}
+
+int cmd_parse(const Options& opts)
+{
+    expect_args(opts, 1, "parse");
+
+    auto start = std::chrono::steady_clock::now();
+    auto cnf = load_formula(opts, opts.args[0]);
+    auto elapsed = seconds_since(start);
+
+    std::cout << "c variables: " << cnf.num_vars() << "\n"
+              << "c clauses:   " << cnf.num_clauses() << "\n"
+              << "c literals:  " << cnf.num_lits() << "\n"
+              << "c parsed in: " << elapsed << " s\n";
+    return EXIT_SUCCESS;
+}
+
+int cmd_convert(const Options& opts)
+{
+    expect_args(opts, 2, "convert");
+
+    if (binary::is_binary_file(opts.args[0])) {
+        write_dimacs(opts.args[1], binary::MappedCnf(opts.args[0]));
+    } else {
+        auto cnf = dimacs::read_file<mini::Lit>(opts.args[0], opts.threads);
+        binary::write_file(opts.args[1], cnf, opts.encoding);
+    }
+    return EXIT_SUCCESS;
+}
+
+// Runs the preprocessing passes, returns their statistics as comment lines
+std::vector<std::string> preprocess(Simplifier& simplifier)
+{
+    auto start = std::chrono::steady_clock::now();
+    simplifier.substitute_equivalences();
+    auto equivalences = seconds_since(start);
+    start = std::chrono::steady_clock::now();
+    simplifier.subsume();
+    auto subsumption = seconds_since(start);
+    start = std::chrono::steady_clock::now();
+    simplifier.eliminate();
+    auto elimination = seconds_since(start);
+    start = std::chrono::steady_clock::now();
+    simplifier.eliminate_covered();
+    auto clause_elimination = seconds_since(start);
+
+    const auto& stats = simplifier.stats();
+    return {
+        "substituted variables: " + std::to_string(stats.substituted_vars)
+            + " in " + std::to_string(equivalences) + " s",
+        "subsumed clauses:      " + std::to_string(stats.subsumed_clauses)
+            + " in " + std::to_string(subsumption) + " s",
+        "strengthened clauses:  " + std::to_string(stats.strengthened_clauses),
+        "eliminated variables:  " + std::to_string(stats.eliminated_vars)
+            + " in " + std::to_string(elimination) + " s",
+        "eliminated clauses:    " + std::to_string(stats.eliminated_clauses),
+        "resolvents:            " + std::to_string(stats.resolvents),
+        "blocked clauses:       " + std::to_string(stats.blocked_clauses)
+            + " in " + std::to_string(clause_elimination) + " s",
+        "covered clauses:       " + std::to_string(stats.covered_clauses),
+        "units:                 " + std::to_string(stats.units),
+    };
+}
+
+int cmd_preprocess(const Options& opts)
+{
+    if (opts.args.size() != 3) {
+        expect_args(opts, 2, "preprocess");
+    }
+
+    auto cnf = load_formula(opts, opts.args[0]);
+    Simplifier simplifier(cnf);
+    auto report = preprocess(simplifier);
+    auto simplified = simplifier.formula();
+
+    dimacs::FileWriter out{dimacs::FileSink(1)};
+    for (const auto& line : report) {
+        out.comment(line);
+    }
+    out.comment("clauses:               " + std::to_string(cnf.num_clauses())
+        + " -> " + std::to_string(simplified.num_clauses()));
+    out.flush();
+
+    dimacs::FileWriter file{dimacs::FileSink(opts.args[1])};
+    file.write(simplified);
+    file.flush();
+
+    // the removed clauses, witnesses first, in the order of removal
+    if (opts.args.size() == 3) {
+        dimacs::FileWriter stack{dimacs::FileSink(opts.args[2])};
+        stack.comment("reconstruction stack of " + opts.args[1]);
+        stack.write(simplifier.reconstruction().to_cnf());
+        stack.flush();
+    }
+    return EXIT_SUCCESS;
+}
+
+// Prints the answer and the model in the SAT competition format
+int cmd_solve(const Options& opts)
+{
+    expect_args(opts, 1, "solve");
+
+    auto start = std::chrono::steady_clock::now();
+    auto cnf = load_formula(opts, opts.args[0]);
+    ReconstructionStack reconstruction;
+    if (!opts.reconstruct.empty()) {
+        reconstruction = ReconstructionStack(load_formula(opts, opts.reconstruct));
+    }
+    Simplifier simplifier;
+    std::vector<std::string> report;
+    Solver solver;
+    if (opts.preprocess) {
+        simplifier.add_cnf(cnf);
+        report = preprocess(simplifier);
+        solver.add_cnf(simplifier.formula());
+    } else {
+        solver.add_cnf(cnf);
+    }
+    auto result = solver.solve();
+    auto elapsed = seconds_since(start);
+
+    const auto& stats = solver.stats();
+    dimacs::FileWriter out{dimacs::FileSink(1)};
+    for (const auto& line : report) {
+        out.comment(line);
+    }
+    out.comment("decisions:    " + std::to_string(stats.decisions));
+    out.comment("conflicts:    " + std::to_string(stats.conflicts));
+    out.comment("propagations: " + std::to_string(stats.propagations));
+    out.comment("xors:         " + std::to_string(stats.xors));
+    out.comment("seconds:      " + std::to_string(elapsed));
+    out.status(to_string(result));
+    if (result == Result::sat) {
+        auto model = solver.model();
+        simplifier.extend(model);
+        reconstruction.extend(model);
+        out.model(tools::Span<const dimacs::Lit>(model.data(), model.size()));
+    }
+    out.flush();
+
+    switch (result) {
+        case Result::sat: return 10;
+        case Result::unsat: return 20;
+        default: return EXIT_SUCCESS;
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    try {
+        Options opts;
+        std::string command;
+
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "-h" || arg == "--help") {
+                print_usage(std::cout);
+                return EXIT_SUCCESS;
+            } else if (arg == "-j" || arg == "--threads") {
+                if (++i == argc) {
+                    throw UsageError("option " + arg + " expects a value");
+                }
+                opts.threads = parse_unsigned(arg, argv[i]);
+            } else if (arg == "-e" || arg == "--encoding") {
+                if (++i == argc) {
+                    throw UsageError("option " + arg + " expects a value");
+                }
+                opts.encoding = parse_encoding(arg, argv[i]);
+            } else if (arg == "-p" || arg == "--preprocess") {
+                opts.preprocess = true;
+            } else if (arg == "-r" || arg == "--reconstruct") {
+                if (++i == argc) {
+                    throw UsageError("option " + arg + " expects a value");
+                }
+                opts.reconstruct = argv[i];
+            } else if (arg.size() > 1 && arg[0] == '-') {
+                throw UsageError("unknown option " + arg);
+            } else if (command.empty()) {
+                command = arg;
+            } else {
+                opts.args.push_back(arg);
+            }
+        }
+
+        if (command == "parse") {
+            return cmd_parse(opts);
+        } else if (command == "convert") {
+            return cmd_convert(opts);
+        } else if (command == "solve") {
+            return cmd_solve(opts);
+        } else if (command == "preprocess") {
+            return cmd_preprocess(opts);
+        } else if (command.empty()) {
+            throw UsageError("no command given");
+        } else {
+            throw UsageError("unknown command '" + command + "'");
+        }
+
+    } catch (const UsageError& error) {
+        std::cerr << "hubero-main: " << error.what() << "\n\n";
+        print_usage(std::cerr);
+        return 2;
+    } catch (const std::exception& error) {
+        std::cerr << "hubero-main: " << error.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
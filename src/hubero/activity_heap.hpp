@@ -0,0 +1,217 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_ACTIVITY_HEAP_H_
+#define HUBERO_ACTIVITY_HEAP_H_
+
+#include <hubero/core.hpp>
+#include <hubero/maps.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace hubero {
+
+// Max-heap of variables ordered by their activities (as in VSIDS).
+//
+// The heap is ARITY-ary, so that the children of a node share a cache line
+// and the heap is shallower than a binary one. Bumping adds the increment,
+// which grows by 1/decay after every conflict instead of decaying all
+// activities (EVSIDS). When an activity gets too large, all of them and the
+// increment are scaled down at once, which keeps the order.
+template<class V, unsigned ARITY = 4>
+class ActivityHeap {
+
+    static_assert(ARITY >= 2, "The heap needs at least 2 children per node.");
+
+    static const std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+    std::vector<V> heap;
+    VarMap<std::uint32_t> positions; // npos for variables outside the heap
+    VarMap<double> activities;
+    double increment;
+    double decay_factor;
+
+public:
+
+    explicit ActivityHeap(double decay = 0.95)
+    : increment(1.0), decay_factor(decay)
+    {}
+
+    // Makes room for the variables up to max_var, with zero activity (the
+    // new variables are not inserted)
+    void grow_to(V max_var)
+    {
+        positions.grow_to(max_var, npos);
+        activities.grow_to(max_var, 0.0);
+    }
+
+    std::size_t size() const
+    {
+        return heap.size();
+    }
+
+    bool empty() const
+    {
+        return heap.empty();
+    }
+
+    bool contains(V var) const
+    {
+        return positions.contains(var) && positions[var] != npos;
+    }
+
+    double activity(V var) const
+    {
+        return activities[var];
+    }
+
+    // The most active variable
+    V top() const
+    {
+        assert(!heap.empty() && "The heap is empty");
+        return heap[0];
+    }
+
+    void insert(V var)
+    {
+        if (contains(var)) {
+            return;
+        }
+        grow_to(var);
+        positions[var] = static_cast<std::uint32_t>(heap.size());
+        heap.push_back(var);
+        sift_up(heap.size() - 1);
+    }
+
+    // Removes and returns the most active variable
+    V pop()
+    {
+        assert(!heap.empty() && "The heap is empty");
+        auto var = heap[0];
+        positions[var] = npos;
+        auto last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = last;
+            positions[last] = 0;
+            sift_down(0);
+        }
+        return var;
+    }
+
+    // Increases the activity by the current increment
+    void bump(V var)
+    {
+        auto& value = activities[var];
+        value += increment;
+        if (value > 1e100) {
+            rescale();
+        }
+        if (contains(var)) {
+            sift_up(positions[var]);
+        }
+    }
+
+    // Makes the future bumps larger, i.e. the past ones relatively smaller
+    void decay()
+    {
+        increment /= decay_factor;
+        if (increment > 1e100) {
+            rescale();
+        }
+    }
+
+    void set_decay(double decay)
+    {
+        decay_factor = decay;
+    }
+
+    // Sets an activity directly (e.g. to seed the order), the variable
+    // moves either way
+    void set_activity(V var, double value)
+    {
+        grow_to(var);
+        auto old = activities[var];
+        activities[var] = value;
+        if (contains(var)) {
+            if (value > old) {
+                sift_up(positions[var]);
+            } else {
+                sift_down(positions[var]);
+            }
+        }
+    }
+
+private:
+
+    bool before(V lhs, V rhs) const
+    {
+        return activities[lhs] > activities[rhs];
+    }
+
+    void place(std::size_t pos, V var)
+    {
+        heap[pos] = var;
+        positions[var] = static_cast<std::uint32_t>(pos);
+    }
+
+    void sift_up(std::size_t pos)
+    {
+        auto var = heap[pos];
+        while (pos > 0) {
+            auto parent = (pos - 1) / ARITY;
+            if (!before(var, heap[parent])) {
+                break;
+            }
+            place(pos, heap[parent]);
+            pos = parent;
+        }
+        place(pos, var);
+    }
+
+    void sift_down(std::size_t pos)
+    {
+        auto var = heap[pos];
+        auto size = heap.size();
+        for (;;) {
+            auto first = ARITY * pos + 1;
+            if (first >= size) {
+                break;
+            }
+            auto last = first + ARITY < size ? first + ARITY : size;
+            auto best = first;
+            for (auto child = first + 1; child < last; ++child) {
+                if (before(heap[child], heap[best])) {
+                    best = child;
+                }
+            }
+            if (!before(heap[best], var)) {
+                break;
+            }
+            place(pos, heap[best]);
+            pos = best;
+        }
+        place(pos, var);
+    }
+
+    void rescale()
+    {
+        for (auto& value : activities.storage()) {
+            value *= 1e-100;
+        }
+        increment *= 1e-100;
+    }
+
+}; // ActivityHeap
+
+template<class V, unsigned ARITY>
+const std::uint32_t ActivityHeap<V,ARITY>::npos;
+
+} // hubero
+#endif // HUBERO_ACTIVITY_HEAP_H_
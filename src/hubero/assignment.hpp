@@ -0,0 +1,322 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_ASSIGNMENT_H_
+#define HUBERO_ASSIGNMENT_H_
+
+#include <hubero/cnf.hpp>
+#include <hubero/core.hpp>
+#include <hubero/maps.hpp>
+#include <hubero/simd.hpp>
+#include <hubero/tools.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace hubero {
+
+// Truth value of a variable or a literal
+enum class Value : std::uint8_t {
+    false_ = 0,
+    true_ = 1,
+    undef = 2,
+};
+
+inline Value operator ~(Value value)
+{
+    return value == Value::undef ? value : static_cast<Value>(static_cast<std::uint8_t>(value) ^ 1);
+}
+
+// Partial assignment of truth values to variables, 2 bits per variable.
+//
+// Bit 0 holds the value of the variable's negative literal and bit 1 is set
+// for unassigned variables. The value of a literal is then the stored bits
+// XOR the literal's sign bit (see mini::LitT), with no branches.
+class Assignment {
+
+    VarMap<TwoBit> bits;
+
+    enum : std::uint8_t { unassigned = 3 };
+
+public:
+
+    Assignment() {}
+
+    // All variables up to max_var, unassigned
+    template<class U, U U_MAX>
+    explicit Assignment(VarT<U,U_MAX> max_var)
+    : bits(max_var, unassigned)
+    {}
+
+    // Makes room for the variables up to max_var, new ones are unassigned
+    template<class U, U U_MAX>
+    void grow_to(VarT<U,U_MAX> max_var)
+    {
+        bits.grow_to(max_var, unassigned);
+    }
+
+    // Number of variables (including the unused variable 0)
+    std::size_t size() const
+    {
+        return bits.size();
+    }
+
+    template<class U, U U_MAX>
+    Value value(VarT<U,U_MAX> var) const
+    {
+        return decode(bits[var] ^ 1);
+    }
+
+    template<class T, T MAX>
+    Value value(mini::LitT<T,MAX> lit) const
+    {
+        return decode(lit_bits(lit));
+    }
+
+    template<class T, T MAX>
+    bool is_true(mini::LitT<T,MAX> lit) const
+    {
+        return lit_bits(lit) == 1;
+    }
+
+    template<class T, T MAX>
+    bool is_false(mini::LitT<T,MAX> lit) const
+    {
+        return lit_bits(lit) == 0;
+    }
+
+    template<class U, U U_MAX>
+    bool is_assigned(VarT<U,U_MAX> var) const
+    {
+        return bits[var] < 2;
+    }
+
+    template<class U, U U_MAX>
+    void set(VarT<U,U_MAX> var, Value value)
+    {
+        bits[var] = value == Value::undef
+            ? static_cast<std::uint8_t>(unassigned)
+            : static_cast<std::uint8_t>(static_cast<std::uint8_t>(value) ^ 1);
+    }
+
+    // Makes the literal true
+    template<class T, T MAX>
+    void assign(mini::LitT<T,MAX> lit)
+    {
+        bits[lit.var()] = static_cast<std::uint8_t>(sign_bit(lit) ^ 1);
+    }
+
+    template<class U, U U_MAX>
+    void unassign(VarT<U,U_MAX> var)
+    {
+        bits[var] = unassigned;
+    }
+
+    // Unassigns all variables
+    void clear()
+    {
+        bits.fill(unassigned);
+    }
+
+    // The packed words, variable v is at bits 2 * (v % 32) of word v / 32
+    tools::Span<const std::uint64_t> words() const
+    {
+        return bits.storage().words();
+    }
+
+    // The raw 2-bit lookup: 1 if the literal is true, 0 if false, 2 or 3
+    // if unassigned
+    template<class T, T MAX>
+    unsigned lit_bits(mini::LitT<T,MAX> lit) const
+    {
+        return bits[lit.var()] ^ sign_bit(lit);
+    }
+
+private:
+
+    template<class T, T MAX>
+    static unsigned sign_bit(mini::LitT<T,MAX> lit)
+    {
+        return static_cast<unsigned>(static_cast<T>(lit) & 1);
+    }
+
+    static Value decode(unsigned lit_bits)
+    {
+        return lit_bits & 2 ? Value::undef : static_cast<Value>(lit_bits);
+    }
+
+}; // Assignment
+
+
+
+namespace detail {
+
+    // Literals per block of check_model(), whose truth bits stay in L1
+    const std::size_t check_block = 4096;
+
+    // Whether any bit in [from, to) is set
+    inline bool any_bit(const std::uint64_t* bits, std::size_t from, std::size_t to)
+    {
+        if (from == to) {
+            return false;
+        }
+        auto first = from / 64;
+        auto last = (to - 1) / 64;
+        auto first_mask = ~std::uint64_t(0) << (from % 64);
+        auto last_mask = ~std::uint64_t(0) >> (63 - (to - 1) % 64);
+        if (first == last) {
+            return (bits[first] & first_mask & last_mask) != 0;
+        }
+        if (bits[first] & first_mask) {
+            return true;
+        }
+        for (auto w = first + 1; w < last; ++w) {
+            if (bits[w]) {
+                return true;
+            }
+        }
+        return (bits[last] & last_mask) != 0;
+    }
+
+    // Sets truth[i] if codes[i] is a true literal, for i in [begin, end)
+    inline void eval_lits_scalar(const std::uint32_t* codes, std::size_t begin,
+        std::size_t end, const Assignment& assignment, std::uint64_t* truth)
+    {
+        auto vars = assignment.size();
+        auto words = assignment.words().data();
+        for (auto i = begin; i < end; ++i) {
+            auto code = codes[i];
+            auto var = code >> 1;
+            unsigned lit_bits = 2;
+            if (var < vars) {
+                lit_bits = static_cast<unsigned>(words[var / 32] >> (var % 32 * 2) & 3) ^ (code & 1);
+            }
+            truth[i / 64] |= static_cast<std::uint64_t>(lit_bits == 1) << (i % 64);
+        }
+    }
+
+#if defined(HUBERO_X86)
+    // Evaluates 8 literals per step: gathers the 32-bit halves of the
+    // assignment's words holding the variables, then shifts, masks and
+    // XORs the sign bits in all lanes at once
+    HUBERO_TARGET("avx2")
+    inline void eval_lits_avx2(const std::uint32_t* codes, std::size_t count,
+        const Assignment& assignment, std::uint64_t* truth)
+    {
+        auto base = reinterpret_cast<const int*>(assignment.words().data());
+        auto last_var = _mm256_set1_epi32(static_cast<int>(assignment.size() - 1));
+        auto one = _mm256_set1_epi32(1);
+        auto three = _mm256_set1_epi32(3);
+        auto fifteen = _mm256_set1_epi32(15);
+
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            auto code = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(codes + i));
+            auto var = _mm256_srli_epi32(code, 1);
+
+            // variables past the assignment are unassigned
+            auto clamped = _mm256_min_epu32(var, last_var);
+            auto in_range = _mm256_cmpeq_epi32(clamped, var);
+
+            auto word = _mm256_i32gather_epi32(base, _mm256_srli_epi32(clamped, 4), 4);
+            auto shift = _mm256_slli_epi32(_mm256_and_si256(clamped, fifteen), 1);
+            auto lit_bits = _mm256_xor_si256(
+                _mm256_and_si256(_mm256_srlv_epi32(word, shift), three),
+                _mm256_and_si256(code, one));
+
+            auto is_true = _mm256_and_si256(_mm256_cmpeq_epi32(lit_bits, one), in_range);
+            auto mask = static_cast<std::uint64_t>(
+                _mm256_movemask_ps(_mm256_castsi256_ps(is_true)));
+            truth[i / 64] |= mask << (i % 64);
+        }
+        eval_lits_scalar(codes, i, count, assignment, truth);
+    }
+#endif // HUBERO_X86
+
+} // detail
+
+// Index of the first clause which the assignment does not satisfy (that
+// has no true literal), or cnf.num_clauses() if it satisfies them all.
+//
+// Variables past the assignment's size count as unassigned. The AVX2
+// version evaluates the literals of a block of clauses in bulk into a
+// bitmask, and then tests the clauses' ranges of bits word by word.
+template<class T, T MAX>
+std::size_t find_unsatisfied(const CnfT<mini::LitT<T,MAX>>& cnf,
+    const Assignment& assignment, simd::Isa isa = simd::best_isa())
+{
+    static_assert(sizeof(mini::LitT<T,MAX>) == sizeof(std::uint32_t)
+        && std::is_standard_layout<mini::LitT<T,MAX>>::value,
+        "Literals are evaluated as uint32 codes.");
+
+    auto lits = cnf.literals();
+    auto codes = reinterpret_cast<const std::uint32_t*>(lits.data());
+    auto num_clauses = cnf.num_clauses();
+
+    bool vectorized = false;
+#if defined(HUBERO_X86)
+    vectorized = isa == simd::Isa::avx2 && simd::supports(simd::Isa::avx2)
+        && assignment.size() > 0;
+#else
+    static_cast<void>(isa);
+#endif
+
+    if (!vectorized) {
+        for (std::size_t c = 0; c < num_clauses; ++c) {
+            bool satisfied = false;
+            for (auto lit : cnf[c]) {
+                if (assignment.size() > static_cast<std::size_t>(lit.var())
+                    && assignment.is_true(lit)) {
+                    satisfied = true;
+                    break;
+                }
+            }
+            if (!satisfied) {
+                return c;
+            }
+        }
+        return num_clauses;
+    }
+
+#if defined(HUBERO_X86)
+    std::vector<std::uint64_t> truth;
+    std::size_t c = 0;
+    while (c < num_clauses) {
+        // whole clauses of about check_block literals
+        auto begin = static_cast<std::size_t>(cnf[c].data() - lits.data());
+        auto c_end = c + 1;
+        auto end = begin + cnf[c].size();
+        while (c_end < num_clauses && end + cnf[c_end].size() - begin <= detail::check_block) {
+            end += cnf[c_end].size();
+            ++c_end;
+        }
+
+        truth.assign((end - begin + 63) / 64 + 1, 0);
+        detail::eval_lits_avx2(codes + begin, end - begin, assignment, truth.data());
+
+        for (; c < c_end; ++c) {
+            auto from = static_cast<std::size_t>(cnf[c].data() - lits.data()) - begin;
+            if (!detail::any_bit(truth.data(), from, from + cnf[c].size())) {
+                return c;
+            }
+        }
+    }
+#endif
+    return num_clauses;
+}
+
+// Whether the assignment satisfies all clauses
+template<class T, T MAX>
+bool check_model(const CnfT<mini::LitT<T,MAX>>& cnf, const Assignment& assignment,
+    simd::Isa isa = simd::best_isa())
+{
+    return find_unsatisfied(cnf, assignment, isa) == cnf.num_clauses();
+}
+
+} // hubero
+#endif // HUBERO_ASSIGNMENT_H_
@@ -0,0 +1,403 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_BINARY_CNF_H_
+#define HUBERO_BINARY_CNF_H_
+
+#include <hubero/cnf.hpp>
+#include <hubero/core.hpp>
+#include <hubero/mapped_file.hpp>
+#include <hubero/tools.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace hubero {
+namespace binary {
+
+// Hubero's native CNF container, loaded by memory-mapping.
+//
+// Layout of the file (all integers in the native byte order):
+//
+//     Header          64 bytes, see below
+//     Index           uint64 offsets into Data, 8-byte aligned
+//     Data            literals, 64-byte aligned
+//
+// Literals are stored as the codes of mini::Lit (2 * variable + sign).
+//
+// Encoding::raw stores the codes as a flat uint32 array and indexes the
+// start of every clause (in literals), so that the clauses can be used in
+// place, without copying or decoding.
+//
+// Encoding::delta stores every clause as a LEB128 varint of its size, then
+// its first code and the zig-zag encoded differences of the consecutive
+// codes. The index holds the byte offset of every block_size-th clause.
+enum class Encoding : std::uint32_t {
+    raw = 0,
+    delta = 1,
+};
+
+const std::size_t block_size = 64;
+
+class FormatError : public std::runtime_error {
+public:
+    explicit FormatError(const std::string& what)
+    : std::runtime_error("invalid binary CNF: " + what)
+    {}
+};
+
+struct Header {
+    char magic[8];
+    std::uint32_t byte_order;
+    std::uint32_t version;
+    std::uint32_t encoding;
+    std::uint32_t reserved[3];
+    std::uint64_t num_vars;
+    std::uint64_t num_clauses;
+    std::uint64_t num_lits;
+    std::uint64_t data_size;
+};
+
+static_assert(sizeof(Header) == 64, "Header must be 64 bytes long.");
+static_assert(sizeof(mini::Lit) == sizeof(std::uint32_t),
+    "Literals are mapped from uint32 codes.");
+static_assert(std::is_standard_layout<mini::Lit>::value,
+    "Literals are mapped from uint32 codes.");
+
+const char magic[8] = {'H', 'U', 'B', 'E', 'R', 'O', 'C', 'N'};
+const std::uint32_t byte_order_mark = 0x01020304;
+const std::uint32_t version = 1;
+
+const std::size_t data_alignment = 64;
+
+namespace detail {
+
+    inline std::size_t align(std::size_t offset, std::size_t alignment)
+    {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    inline std::size_t index_size(const Header& hdr)
+    {
+        auto entries = hdr.encoding == static_cast<std::uint32_t>(Encoding::raw)
+            ? hdr.num_clauses + 1
+            : (hdr.num_clauses + block_size - 1) / block_size;
+        return static_cast<std::size_t>(entries) * sizeof(std::uint64_t);
+    }
+
+    inline std::size_t data_offset(const Header& hdr)
+    {
+        return align(sizeof(Header) + index_size(hdr), data_alignment);
+    }
+
+    inline void put_varint(std::vector<unsigned char>& out, std::uint64_t value)
+    {
+        while (value >= 0x80) {
+            out.push_back(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<unsigned char>(value));
+    }
+
+    // Reads a varint from [pos, end), throws FormatError if it is truncated
+    inline std::uint64_t get_varint(const unsigned char*& pos, const unsigned char* end)
+    {
+        std::uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            if (pos == end) {
+                throw FormatError("truncated clause data");
+            }
+            auto byte = *pos++;
+            if (shift == 63 && byte > 1) {
+                break;
+            }
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if (byte < 0x80) {
+                return value;
+            }
+        }
+        throw FormatError("malformed varint");
+    }
+
+    // The difference of two literal codes spans 33 bits, so its zigzag
+    // code needs 64
+    inline std::uint64_t zigzag(std::uint32_t from, std::uint32_t to)
+    {
+        auto diff = static_cast<std::int64_t>(to) - static_cast<std::int64_t>(from);
+        return static_cast<std::uint64_t>(diff >= 0 ? 2 * diff : -2 * diff - 1);
+    }
+
+    // Throws FormatError if the code leads out of the literal codes
+    inline std::uint32_t unzigzag(std::uint32_t from, std::uint64_t code)
+    {
+        auto distance = code / 2 + (code & 1);
+        if (code & 1 ? distance > from : distance > std::numeric_limits<std::uint32_t>::max() - from) {
+            throw FormatError("literal out of range");
+        }
+        return static_cast<std::uint32_t>(code & 1 ? from - distance : from + distance);
+    }
+
+    inline void write_bytes(std::ofstream& out, const void* data, std::size_t size,
+        const std::string& path)
+    {
+        out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        if (!out) {
+            throw std::runtime_error("Cannot write file " + path);
+        }
+    }
+
+} // detail
+
+// Writes a formula in the binary format
+inline void write_file(const std::string& path, const Cnf& cnf,
+    Encoding encoding = Encoding::raw)
+{
+    Header hdr;
+    std::memset(&hdr, 0, sizeof(hdr));
+    std::memcpy(hdr.magic, magic, sizeof(magic));
+    hdr.byte_order = byte_order_mark;
+    hdr.version = version;
+    hdr.encoding = static_cast<std::uint32_t>(encoding);
+    hdr.num_vars = cnf.num_vars();
+    hdr.num_clauses = cnf.num_clauses();
+    hdr.num_lits = cnf.num_lits();
+
+    std::vector<std::uint64_t> index;
+    std::vector<unsigned char> delta_data;
+    if (encoding == Encoding::raw) {
+        index.reserve(cnf.num_clauses() + 1);
+        std::uint64_t offset = 0;
+        for (auto clause : cnf) {
+            index.push_back(offset);
+            offset += clause.size();
+        }
+        index.push_back(offset);
+        hdr.data_size = cnf.num_lits() * sizeof(std::uint32_t);
+    } else {
+        std::size_t i = 0;
+        for (auto clause : cnf) {
+            if (i++ % block_size == 0) {
+                index.push_back(delta_data.size());
+            }
+            detail::put_varint(delta_data, clause.size());
+            std::uint32_t previous = 0;
+            for (auto lit : clause) {
+                auto code = static_cast<std::uint32_t>(lit);
+                detail::put_varint(delta_data, detail::zigzag(previous, code));
+                previous = code;
+            }
+        }
+        hdr.data_size = delta_data.size();
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot open file " + path + " for writing");
+    }
+    detail::write_bytes(out, &hdr, sizeof(hdr), path);
+    detail::write_bytes(out, index.data(), index.size() * sizeof(std::uint64_t), path);
+
+    auto padding = detail::data_offset(hdr) - sizeof(hdr) - detail::index_size(hdr);
+    const char zeros[data_alignment] = {};
+    detail::write_bytes(out, zeros, padding, path);
+
+    if (encoding == Encoding::raw) {
+        auto lits = cnf.literals();
+        detail::write_bytes(out, lits.data(), lits.size() * sizeof(std::uint32_t), path);
+    } else {
+        detail::write_bytes(out, delta_data.data(), delta_data.size(), path);
+    }
+}
+
+// Checks the magic number of a file
+inline bool is_binary_file(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    char prefix[sizeof(magic)];
+    if (!in.read(prefix, sizeof(prefix))) {
+        return false;
+    }
+    return std::memcmp(prefix, magic, sizeof(magic)) == 0;
+}
+
+// Memory-mapped formula in the binary format.
+//
+// The file is validated when opened, so that no clause reaches past the
+// end of the file.
+class MappedCnf {
+
+    tools::MappedFile file;
+    Header hdr;
+    const std::uint64_t* index;
+    const unsigned char* data;
+
+public:
+
+    explicit MappedCnf(const std::string& path)
+    : file(path)
+    {
+        if (file.size() < sizeof(Header)) {
+            throw FormatError("file is too short");
+        }
+        std::memcpy(&hdr, file.data(), sizeof(Header));
+
+        if (std::memcmp(hdr.magic, magic, sizeof(magic)) != 0) {
+            throw FormatError("not a hubero binary CNF");
+        }
+        if (hdr.byte_order != byte_order_mark) {
+            throw FormatError("written on a machine of a different byte order");
+        }
+        if (hdr.version != version) {
+            throw FormatError("unsupported version " + std::to_string(hdr.version));
+        }
+        if (hdr.encoding > static_cast<std::uint32_t>(Encoding::delta)) {
+            throw FormatError("unknown encoding " + std::to_string(hdr.encoding));
+        }
+        if (hdr.num_clauses > file.size() || hdr.num_lits > file.size()
+            || detail::data_offset(hdr) > file.size()
+            || hdr.data_size != file.size() - detail::data_offset(hdr)) {
+            throw FormatError("the file size does not match the header");
+        }
+
+        // mmap-ed memory is page-aligned, so are the index and the data
+        index = reinterpret_cast<const std::uint64_t*>(file.data() + sizeof(Header));
+        data = reinterpret_cast<const unsigned char*>(file.data())
+            + detail::data_offset(hdr);
+
+        validate_index();
+    }
+
+    Encoding encoding() const
+    {
+        return static_cast<Encoding>(hdr.encoding);
+    }
+
+    std::uint64_t num_vars() const
+    {
+        return hdr.num_vars;
+    }
+
+    std::size_t num_clauses() const
+    {
+        return static_cast<std::size_t>(hdr.num_clauses);
+    }
+
+    std::size_t num_lits() const
+    {
+        return static_cast<std::size_t>(hdr.num_lits);
+    }
+
+    // Clause i, pointing right into the mapped file (raw encoding only)
+    tools::Span<const mini::Lit> clause(std::size_t i) const
+    {
+        if (encoding() != Encoding::raw) {
+            throw std::logic_error("only clauses of raw-encoded files can be mapped");
+        }
+        assert(i < num_clauses() && "Clause index out of range");
+        auto lits = reinterpret_cast<const mini::Lit*>(data);
+        return tools::Span<const mini::Lit>(lits + index[i], lits + index[i + 1]);
+    }
+
+    // Calls f(tools::Span<const mini::Lit>) for every clause, the spans of
+    // delta-encoded clauses point to a buffer reused between the calls
+    template<class F>
+    void for_each_clause(F&& f) const
+    {
+        if (encoding() == Encoding::raw) {
+            for (std::size_t i = 0; i < num_clauses(); ++i) {
+                f(clause(i));
+            }
+            return;
+        }
+
+        std::vector<mini::Lit> buffer;
+        auto pos = data;
+        for (std::size_t i = 0; i < num_clauses(); ++i) {
+            decode_next(pos, buffer);
+            f(tools::Span<const mini::Lit>(buffer.data(), buffer.size()));
+        }
+    }
+
+    // Copies clause i into out (in any encoding). Delta-encoded clauses are
+    // decoded from the start of their block.
+    void copy_clause(std::size_t i, std::vector<mini::Lit>& out) const
+    {
+        assert(i < num_clauses() && "Clause index out of range");
+        if (encoding() == Encoding::raw) {
+            auto span = clause(i);
+            out.assign(span.begin(), span.end());
+            return;
+        }
+
+        auto pos = data + index[i / block_size];
+        for (std::size_t j = i / block_size * block_size; j <= i; ++j) {
+            decode_next(pos, out);
+        }
+    }
+
+    // Copies the formula into memory
+    Cnf to_cnf() const
+    {
+        Cnf cnf;
+        cnf.set_num_vars(num_vars());
+        cnf.reserve(num_clauses(), num_lits());
+        for_each_clause([&](tools::Span<const mini::Lit> clause) {
+            cnf.add_clause(clause);
+        });
+        return cnf;
+    }
+
+private:
+
+    void decode_next(const unsigned char*& pos, std::vector<mini::Lit>& out) const
+    {
+        auto end = data + hdr.data_size;
+        auto size = detail::get_varint(pos, end);
+        if (size > static_cast<std::size_t>(end - pos)) {
+            throw FormatError("truncated clause data");
+        }
+        out.resize(static_cast<std::size_t>(size));
+
+        std::uint32_t previous = 0;
+        for (std::size_t j = 0; j < size; ++j) {
+            previous = detail::unzigzag(previous, detail::get_varint(pos, end));
+            out[j] = mini::Lit(previous);
+        }
+    }
+
+    void validate_index() const
+    {
+        if (encoding() == Encoding::raw) {
+            if (hdr.data_size != hdr.num_lits * sizeof(std::uint32_t)
+                || index[0] != 0 || index[num_clauses()] != hdr.num_lits) {
+                throw FormatError("the index does not match the header");
+            }
+            for (std::size_t i = 0; i < num_clauses(); ++i) {
+                if (index[i] > index[i + 1]) {
+                    throw FormatError("the index is not sorted");
+                }
+            }
+        } else {
+            auto blocks = (num_clauses() + block_size - 1) / block_size;
+            for (std::size_t b = 0; b < blocks; ++b) {
+                if (index[b] > hdr.data_size || (b > 0 && index[b - 1] > index[b])) {
+                    throw FormatError("the index does not match the data");
+                }
+            }
+        }
+    }
+
+}; // MappedCnf
+
+} // binary
+} // hubero
+#endif // HUBERO_BINARY_CNF_H_
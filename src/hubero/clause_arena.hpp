@@ -0,0 +1,409 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_CLAUSE_ARENA_H_
+#define HUBERO_CLAUSE_ARENA_H_
+
+#include <hubero/core.hpp>
+#include <hubero/tools.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hubero {
+
+// 32-bit reference to a clause of a ClauseArena (its offset in words)
+class ClauseRef {
+
+    std::uint32_t offset;
+
+public:
+
+    static const std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+    // No clause
+    ClauseRef() : offset(npos) {}
+
+    explicit ClauseRef(std::uint32_t words) : offset(words) {}
+
+    std::uint32_t index() const
+    {
+        return offset;
+    }
+
+    bool valid() const
+    {
+        return offset != npos;
+    }
+
+    bool operator ==(const ClauseRef& rhs) const
+    {
+        return offset == rhs.offset;
+    }
+
+    bool operator !=(const ClauseRef& rhs) const
+    {
+        return offset != rhs.offset;
+    }
+
+    bool operator <(const ClauseRef& rhs) const
+    {
+        return offset < rhs.offset;
+    }
+
+}; // ClauseRef
+
+namespace detail {
+
+    // Layout of a clause in the arena:
+    //
+    //     word 0   size (bits 0..30)
+    //     word 1   flags (bits 0..2), used (bits 3..7), LBD (bits 8..31)
+    //     word 2   activity (float)
+    //     word 3.. literals
+    //
+    // Words with bit 31 set start a filler (left behind by ClauseArena::
+    // shrink()), the other bits are the filler's length in words.
+    const std::uint32_t header_words = 3;
+    const std::uint32_t filler_bit = 0x80000000u;
+    const std::uint32_t max_lbd = 0xFFFFFFu;
+
+    const std::uint32_t flag_learnt = 1u << 0;
+    const std::uint32_t flag_garbage = 1u << 1;
+    const std::uint32_t flag_vivified = 1u << 2;
+    const std::uint32_t used_shift = 3;
+    const std::uint32_t max_used = 31;
+
+} // detail
+
+// View of a clause stored in a ClauseArena.
+//
+// The view (like the literal pointers) is invalidated by allocating a new
+// clause and by garbage collection, keep ClauseRefs instead. Word is
+// std::uint32_t for mutable clauses and const std::uint32_t for read-only.
+template<class Word>
+class ClauseView {
+
+    Word* header;
+
+    using lit_type = typename std::conditional<std::is_const<Word>::value,
+        const mini::Lit, mini::Lit>::type;
+
+public:
+
+    explicit ClauseView(Word* words) : header(words) {}
+
+    std::uint32_t size() const
+    {
+        return header[0];
+    }
+
+    lit_type* begin() const
+    {
+        return reinterpret_cast<lit_type*>(header + detail::header_words);
+    }
+
+    lit_type* end() const
+    {
+        return begin() + size();
+    }
+
+    lit_type& operator [](std::uint32_t i) const
+    {
+        assert(i < size() && "Literal index out of the clause");
+        return begin()[i];
+    }
+
+    tools::Span<lit_type> lits() const
+    {
+        return tools::Span<lit_type>(begin(), size());
+    }
+
+    bool learnt() const
+    {
+        return (header[1] & detail::flag_learnt) != 0;
+    }
+
+    // Freed, waiting for the garbage collection
+    bool garbage() const
+    {
+        return (header[1] & detail::flag_garbage) != 0;
+    }
+
+    // Recently used in conflict analysis: the number of clause database
+    // reductions it survives (0 if not used since the last one)
+    std::uint32_t used() const
+    {
+        return header[1] >> detail::used_shift & detail::max_used;
+    }
+
+    void set_used(std::uint32_t reductions)
+    {
+        reductions = std::min(reductions, detail::max_used);
+        header[1] = (header[1] & ~(detail::max_used << detail::used_shift))
+            | reductions << detail::used_shift;
+    }
+
+    // Tried by vivification already
+    bool vivified() const
+    {
+        return (header[1] & detail::flag_vivified) != 0;
+    }
+
+    void set_vivified(bool value)
+    {
+        header[1] = value ? header[1] | detail::flag_vivified : header[1] & ~detail::flag_vivified;
+    }
+
+    // Literal block distance (glue) of learnt clauses
+    std::uint32_t lbd() const
+    {
+        return header[1] >> 8;
+    }
+
+    void set_lbd(std::uint32_t lbd)
+    {
+        lbd = std::min(lbd, detail::max_lbd);
+        header[1] = (header[1] & 0xFFu) | (lbd << 8);
+    }
+
+    float activity() const
+    {
+        float value;
+        std::memcpy(&value, header + 2, sizeof(value));
+        return value;
+    }
+
+    void set_activity(float value)
+    {
+        std::memcpy(header + 2, &value, sizeof(value));
+    }
+
+}; // ClauseView
+
+using Clause = ClauseView<std::uint32_t>;
+using ConstClause = ClauseView<const std::uint32_t>;
+
+
+
+// Old-to-new reference mapping produced by ClauseArena::collect()
+class Relocation {
+
+    // pairs of (old offset, new offset), sorted by the old ones
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> moves;
+
+public:
+
+    Relocation() {}
+
+    explicit Relocation(std::vector<std::pair<std::uint32_t, std::uint32_t>> table)
+    : moves(std::move(table))
+    {}
+
+    // The new reference of a clause, or an invalid one for collected clauses
+    ClauseRef operator ()(ClauseRef old) const
+    {
+        auto it = std::lower_bound(moves.begin(), moves.end(),
+            std::make_pair(old.index(), std::uint32_t(0)));
+        if (it == moves.end() || it->first != old.index()) {
+            return ClauseRef();
+        }
+        return ClauseRef(it->second);
+    }
+
+    void relocate(ClauseRef& ref) const
+    {
+        ref = (*this)(ref);
+    }
+
+    std::size_t size() const
+    {
+        return moves.size();
+    }
+
+}; // Relocation
+
+
+
+// Clause database in one contiguous region of 32-bit words.
+//
+// Clauses are bump-allocated, each one as a header and its literals
+// inline, and referenced by 32-bit offsets. Freed clauses are only marked
+// (tombstoned) and the space is reclaimed by collect(), which slides the
+// live clauses down in place and returns the mapping for the references
+// held elsewhere:
+//
+//     auto moved = arena.collect();
+//     for (auto& ref : refs) {
+//         moved.relocate(ref);
+//     }
+class ClauseArena {
+
+    std::vector<std::uint32_t> words;
+    std::size_t wasted;
+    std::size_t live;
+
+public:
+
+    ClauseArena() : wasted(0), live(0) {}
+
+    void reserve(std::size_t num_words)
+    {
+        words.reserve(num_words);
+    }
+
+    ClauseRef alloc(tools::Span<const mini::Lit> lits, bool learnt = false)
+    {
+        auto offset = words.size();
+        auto needed = detail::header_words + lits.size();
+        if (lits.size() >= detail::filler_bit
+            || needed > ClauseRef::npos - offset) {
+            throw std::length_error("The clause arena is limited to 2^32 words.");
+        }
+
+        words.resize(offset + needed);
+        auto header = words.data() + offset;
+        header[0] = static_cast<std::uint32_t>(lits.size());
+        header[1] = learnt ? detail::flag_learnt : 0;
+        header[2] = 0; // activity 0.0f
+        if (!lits.empty()) {
+            std::memcpy(header + detail::header_words, lits.data(),
+                lits.size() * sizeof(std::uint32_t));
+        }
+        ++live;
+        return ClauseRef(static_cast<std::uint32_t>(offset));
+    }
+
+    ClauseRef alloc(std::initializer_list<mini::Lit> lits, bool learnt = false)
+    {
+        return alloc(tools::Span<const mini::Lit>(lits.begin(), lits.end()), learnt);
+    }
+
+    Clause operator [](ClauseRef ref)
+    {
+        assert(ref.index() < words.size() && "Invalid clause reference");
+        return Clause(words.data() + ref.index());
+    }
+
+    ConstClause operator [](ClauseRef ref) const
+    {
+        assert(ref.index() < words.size() && "Invalid clause reference");
+        return ConstClause(words.data() + ref.index());
+    }
+
+    // Drops the literals past the first size ones, their space is
+    // reclaimed by collect()
+    void shrink(ClauseRef ref, std::uint32_t size)
+    {
+        auto header = words.data() + ref.index();
+        assert(size <= header[0] && "Clauses can only shrink");
+        auto gap = header[0] - size;
+        if (gap > 0) {
+            header[detail::header_words + size] = detail::filler_bit | gap;
+            header[0] = size;
+            wasted += gap;
+        }
+    }
+
+    // Tombstones the clause, its space is reclaimed by collect()
+    void free(ClauseRef ref)
+    {
+        auto clause = (*this)[ref];
+        assert(!clause.garbage() && "The clause is freed twice");
+        words[ref.index() + 1] |= detail::flag_garbage;
+        wasted += detail::header_words + clause.size();
+        --live;
+    }
+
+    // Number of live clauses
+    std::size_t num_clauses() const
+    {
+        return live;
+    }
+
+    // Words allocated, including the garbage
+    std::size_t size() const
+    {
+        return words.size();
+    }
+
+    // Words of freed clauses and of dropped literals
+    std::size_t wasted_words() const
+    {
+        return wasted;
+    }
+
+    // Calls f(ClauseRef) for all live clauses, in the order of allocation
+    template<class F>
+    void for_each_clause(F f) const
+    {
+        std::size_t pos = 0;
+        while (pos < words.size()) {
+            auto word = words[pos];
+            if (word & detail::filler_bit) {
+                pos += word & ~detail::filler_bit;
+                continue;
+            }
+            if (!(words[pos + 1] & detail::flag_garbage)) {
+                f(ClauseRef(static_cast<std::uint32_t>(pos)));
+            }
+            pos += detail::header_words + word;
+        }
+    }
+
+    // Compacts the arena: slides the live clauses down over the garbage
+    // (keeping their order) and returns where they moved
+    Relocation collect()
+    {
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> moves;
+        moves.reserve(live);
+
+        std::size_t src = 0;
+        std::size_t dst = 0;
+        while (src < words.size()) {
+            auto word = words[src];
+            if (word & detail::filler_bit) {
+                src += word & ~detail::filler_bit;
+                continue;
+            }
+
+            auto length = detail::header_words + word;
+            if (!(words[src + 1] & detail::flag_garbage)) {
+                if (dst != src) {
+                    std::memmove(words.data() + dst, words.data() + src,
+                        length * sizeof(std::uint32_t));
+                }
+                moves.push_back(std::make_pair(static_cast<std::uint32_t>(src),
+                    static_cast<std::uint32_t>(dst)));
+                dst += length;
+            }
+            src += length;
+        }
+
+        words.resize(dst);
+        wasted = 0;
+        return Relocation(std::move(moves));
+    }
+
+    void clear()
+    {
+        words.clear();
+        wasted = 0;
+        live = 0;
+    }
+
+}; // ClauseArena
+
+} // hubero
+#endif // HUBERO_CLAUSE_ARENA_H_
@@ -0,0 +1,212 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_CLAUSE_RING_H_
+#define HUBERO_CLAUSE_RING_H_
+
+#include <hubero/core.hpp>
+#include <hubero/tools.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace hubero {
+
+// Limits of the clauses in a ClauseRing
+const std::size_t max_shared_size = (1u << 16) - 1;
+const std::uint32_t max_shared_lbd = (1u << 8) - 1;
+const std::uint32_t max_shared_source = (1u << 8) - 1;
+
+// A clause read from a ClauseRing
+struct SharedClause {
+    std::uint32_t source;   // the producer
+    std::uint32_t lbd;
+    std::vector<mini::Lit> lits;
+};
+
+// Lock-free ring buffer broadcasting clauses from many producers to many
+// consumers (e.g. learnt clauses between the threads of a Portfolio).
+//
+// A clause takes a header word (size, LBD, producer) and one word per
+// literal. Producers reserve the words by a single fetch_add on the head,
+// so they never wait for each other. Each slot holds a word together with
+// the lap of the ring it was written in, which tells a reader whether the
+// word is not written yet (an older lap), valid, or overwritten already (a
+// newer one). Readers keep their own cursors, so every reader sees every
+// clause unless it falls a whole ring behind the producers, in which case
+// it skips to the head and the skipped clauses are lost (sharing is an
+// optimization, not an obligation).
+class ClauseRing {
+
+    static const unsigned size_bits = 16;
+    static const unsigned lbd_bits = 8;
+    static_assert(max_shared_size == (1u << size_bits) - 1, "header layout");
+    static_assert(max_shared_lbd == (1u << lbd_bits) - 1, "header layout");
+
+    std::unique_ptr<std::atomic<std::uint64_t>[]> slots;
+    std::uint64_t mask;
+    unsigned shift;
+    std::atomic<std::uint64_t> head;
+
+public:
+
+    // Where a reader continues, and how much it missed
+    class Cursor {
+        friend class ClauseRing;
+        std::uint64_t position;
+        std::uint64_t skipped;
+    public:
+        Cursor() : position(0), skipped(0) {}
+
+        // Words overwritten before the reader got to them
+        std::uint64_t skipped_words() const
+        {
+            return skipped;
+        }
+    };
+
+    // The capacity is rounded up to a power of two (of at least 64 words)
+    explicit ClauseRing(std::size_t words = std::size_t(1) << 16)
+    : mask(0), shift(6), head(0)
+    {
+        while ((std::uint64_t(1) << shift) < words) {
+            ++shift;
+        }
+        auto capacity = std::size_t(1) << shift;
+        mask = capacity - 1;
+        slots.reset(new std::atomic<std::uint64_t>[capacity]);
+        for (std::size_t i = 0; i < capacity; ++i) {
+            slots[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    ClauseRing(const ClauseRing&) = delete;
+    ClauseRing& operator =(const ClauseRing&) = delete;
+
+    std::size_t capacity() const
+    {
+        return static_cast<std::size_t>(mask + 1);
+    }
+
+    // Words published so far (the head never moves back)
+    std::uint64_t written() const
+    {
+        return head.load(std::memory_order_relaxed);
+    }
+
+    // A cursor that reads the clauses published from now on
+    Cursor cursor() const
+    {
+        Cursor result;
+        result.position = written();
+        return result;
+    }
+
+    // Publishes a clause, false if it is empty or does not fit (longer than
+    // max_shared_size or a quarter of the ring). LBDs are capped.
+    bool push(std::uint32_t source, tools::Span<const mini::Lit> lits, std::uint32_t lbd)
+    {
+        if (lits.size() == 0 || lits.size() > max_shared_size
+            || lits.size() > capacity() / 4 || source > max_shared_source) {
+            return false;
+        }
+        auto header = static_cast<std::uint32_t>(lits.size())
+            | ((lbd < max_shared_lbd ? lbd : max_shared_lbd) << size_bits)
+            | (source << (size_bits + lbd_bits));
+
+        auto pos = head.fetch_add(lits.size() + 1, std::memory_order_relaxed);
+        store(pos, header);
+        for (std::size_t i = 0; i < lits.size(); ++i) {
+            store(pos + 1 + i, static_cast<std::uint32_t>(lits[i]));
+        }
+        return true;
+    }
+
+    // Reads the next clause into out, false if none is complete yet
+    bool pop(Cursor& cursor, SharedClause& out) const
+    {
+        for (;;) {
+            auto end = written();
+            if (end - cursor.position > capacity()) {
+                skip(cursor, end);
+            }
+            if (cursor.position == end) {
+                return false;
+            }
+
+            std::uint32_t header;
+            auto state = load(cursor.position, header);
+            if (state == pending) {
+                return false;
+            } else if (state == overwritten) {
+                skip(cursor, written());
+                continue;
+            }
+
+            std::size_t size = header & max_shared_size;
+            out.lbd = (header >> size_bits) & max_shared_lbd;
+            out.source = header >> (size_bits + lbd_bits);
+            out.lits.resize(size);
+            for (std::size_t i = 0; i < size && state == valid; ++i) {
+                std::uint32_t word;
+                state = load(cursor.position + 1 + i, word);
+                out.lits[i] = mini::Lit(word);
+            }
+            if (state == pending) {
+                return false;
+            } else if (state == overwritten) {
+                skip(cursor, written());
+                continue;
+            }
+            cursor.position += size + 1;
+            return true;
+        }
+    }
+
+private:
+
+    enum State { pending, valid, overwritten };
+
+    std::uint64_t tag(std::uint64_t pos) const
+    {
+        return ((pos >> shift) + 1) & 0xffffffffu;
+    }
+
+    // Writes unless a later lap got there first (when this producer was
+    // stalled for a whole ring), so the tags never go back
+    void store(std::uint64_t pos, std::uint32_t word)
+    {
+        auto& slot = slots[pos & mask];
+        auto desired = (tag(pos) << 32) | word;
+        auto current = slot.load(std::memory_order_relaxed);
+        while ((current >> 32) < tag(pos)) {
+            if (slot.compare_exchange_weak(current, desired,
+                    std::memory_order_release, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+    }
+
+    State load(std::uint64_t pos, std::uint32_t& word) const
+    {
+        auto value = slots[pos & mask].load(std::memory_order_acquire);
+        auto lap = value >> 32;
+        word = static_cast<std::uint32_t>(value);
+        return lap == tag(pos) ? valid : lap < tag(pos) ? pending : overwritten;
+    }
+
+    static void skip(Cursor& cursor, std::uint64_t to)
+    {
+        cursor.skipped += to - cursor.position;
+        cursor.position = to;
+    }
+
+}; // ClauseRing
+
+} // hubero
+#endif // HUBERO_CLAUSE_RING_H_
@@ -0,0 +1,162 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_CNF_H_
+#define HUBERO_CNF_H_
+
+#include <hubero/core.hpp>
+#include <hubero/tools.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+namespace hubero {
+
+// Formula in conjunctive normal form.
+//
+// All literals are stored in one flat array, clause i spans the literals
+// starts[i] .. starts[i+1]-1. Clauses can be added, but not removed.
+template<class L>
+class CnfT {
+
+    std::vector<L> lits;
+    std::vector<std::size_t> starts;
+    std::uint64_t vars;
+
+public:
+
+    using lit_type = L;
+    using clause_type = tools::Span<const L>;
+
+    CnfT() : starts(1, 0), vars(0) {}
+
+    // Number of variables, as declared by the DIMACS header (if any)
+    std::uint64_t num_vars() const
+    {
+        return vars;
+    }
+
+    void set_num_vars(std::uint64_t num_vars)
+    {
+        vars = num_vars;
+    }
+
+    std::size_t num_clauses() const
+    {
+        return starts.size() - 1;
+    }
+
+    std::size_t num_lits() const
+    {
+        return lits.size();
+    }
+
+    bool empty() const
+    {
+        return num_clauses() == 0;
+    }
+
+    void reserve(std::size_t num_clauses, std::size_t num_lits)
+    {
+        starts.reserve(num_clauses + 1);
+        lits.reserve(num_lits);
+    }
+
+    void add_clause(tools::Span<const L> clause)
+    {
+        lits.insert(lits.end(), clause.begin(), clause.end());
+        starts.push_back(lits.size());
+    }
+
+    void add_clause(std::initializer_list<L> clause)
+    {
+        add_clause(tools::Span<const L>(clause.begin(), clause.end()));
+    }
+
+    // Appends all clauses of another formula
+    void append(const CnfT<L>& other)
+    {
+        auto offset = lits.size();
+        lits.insert(lits.end(), other.lits.begin(), other.lits.end());
+
+        starts.reserve(starts.size() + other.num_clauses());
+        for (std::size_t i = 1; i < other.starts.size(); ++i) {
+            starts.push_back(offset + other.starts[i]);
+        }
+        vars = vars > other.vars ? vars : other.vars;
+    }
+
+    clause_type operator [](std::size_t i) const
+    {
+        assert(i < num_clauses() && "Clause index out of range");
+        return clause_type(lits.data() + starts[i], starts[i + 1] - starts[i]);
+    }
+
+    void clear()
+    {
+        lits.clear();
+        starts.assign(1, 0);
+        vars = 0;
+    }
+
+    // All literals of all clauses
+    tools::Span<const L> literals() const
+    {
+        return tools::Span<const L>(lits.data(), lits.size());
+    }
+
+    class const_iterator {
+
+        const CnfT<L>* cnf;
+        std::size_t index;
+
+    public:
+
+        const_iterator(const CnfT<L>* formula, std::size_t i)
+        : cnf(formula), index(i)
+        {}
+
+        clause_type operator *() const
+        {
+            return (*cnf)[index];
+        }
+
+        const_iterator& operator ++()
+        {
+            ++index;
+            return *this;
+        }
+
+        bool operator ==(const const_iterator& rhs) const
+        {
+            return index == rhs.index;
+        }
+
+        bool operator !=(const const_iterator& rhs) const
+        {
+            return index != rhs.index;
+        }
+
+    }; // const_iterator
+
+    const_iterator begin() const
+    {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(this, num_clauses());
+    }
+
+}; // CnfT
+
+using Cnf = CnfT<mini::Lit>;
+
+} // hubero
+#endif // HUBERO_CNF_H_
@@ -0,0 +1,511 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_COMPRESSED_SOURCE_H_
+#define HUBERO_COMPRESSED_SOURCE_H_
+
+#include <hubero/dimacs_reader.hpp>
+#include <hubero/mapped_file.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// The decompressors are optional, CMake defines HUBERO_HAVE_* for each one found
+#ifdef HUBERO_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HUBERO_HAVE_LZMA
+#include <lzma.h>
+#endif
+#ifdef HUBERO_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace hubero {
+namespace dimacs {
+
+enum class Compression {
+    none,
+    gzip,
+    xz,
+    zstd,
+};
+
+inline const char* to_string(Compression compression)
+{
+    switch (compression) {
+    case Compression::gzip: return "gzip";
+    case Compression::xz:   return "xz";
+    case Compression::zstd: return "zstd";
+    default:                return "none";
+    }
+}
+
+// Whether hubero was built with the decompressor
+inline bool is_supported(Compression compression)
+{
+    switch (compression) {
+    case Compression::none:
+        return true;
+    case Compression::gzip:
+#ifdef HUBERO_HAVE_ZLIB
+        return true;
+#else
+        return false;
+#endif
+    case Compression::xz:
+#ifdef HUBERO_HAVE_LZMA
+        return true;
+#else
+        return false;
+#endif
+    case Compression::zstd:
+#ifdef HUBERO_HAVE_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+// Recognizes the compression by the magic number (not by the file name)
+inline Compression detect_compression(const unsigned char* data, std::size_t size)
+{
+    static const unsigned char gzip[] = {0x1F, 0x8B};
+    static const unsigned char xz[] = {0xFD, '7', 'z', 'X', 'Z', 0x00};
+    static const unsigned char zstd[] = {0x28, 0xB5, 0x2F, 0xFD};
+
+    if (size >= sizeof(gzip) && std::memcmp(data, gzip, sizeof(gzip)) == 0) {
+        return Compression::gzip;
+    } else if (size >= sizeof(xz) && std::memcmp(data, xz, sizeof(xz)) == 0) {
+        return Compression::xz;
+    } else if (size >= sizeof(zstd) && std::memcmp(data, zstd, sizeof(zstd)) == 0) {
+        return Compression::zstd;
+    }
+    return Compression::none;
+}
+
+inline Compression detect_compression(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    unsigned char prefix[6] = {};
+    in.read(reinterpret_cast<char*>(prefix), sizeof(prefix));
+    return detect_compression(prefix, static_cast<std::size_t>(in.gcount()));
+}
+
+class DecompressionError : public std::runtime_error {
+public:
+    explicit DecompressionError(const std::string& what)
+    : std::runtime_error(what)
+    {}
+};
+
+namespace detail {
+
+    // Decompresses a whole in-memory stream, piece by piece
+    class Decoder {
+    public:
+        virtual ~Decoder() {}
+
+        // Fills up to size bytes of out, returns 0 at the end of the stream
+        virtual std::size_t decode(char* out, std::size_t size) = 0;
+    };
+
+#ifdef HUBERO_HAVE_ZLIB
+    // Also reads concatenated gzip members (as produced by pigz or cat)
+    class GzipDecoder : public Decoder {
+
+        z_stream zs;
+        const unsigned char* pos;
+        const unsigned char* end;
+        bool member_end;
+
+    public:
+
+        GzipDecoder(const unsigned char* data, std::size_t size)
+        : pos(data), end(data + size), member_end(false)
+        {
+            std::memset(&zs, 0, sizeof(zs));
+            if (inflateInit2(&zs, 15 + 32) != Z_OK) { // 32 = detect the gzip header
+                throw DecompressionError("cannot initialize zlib");
+            }
+        }
+
+        ~GzipDecoder()
+        {
+            inflateEnd(&zs);
+        }
+
+        std::size_t decode(char* out, std::size_t size) override
+        {
+            // avail_in and avail_out are 32-bit
+            auto max_chunk = static_cast<std::size_t>(1) << 30;
+            zs.next_out = reinterpret_cast<Bytef*>(out);
+            zs.avail_out = static_cast<uInt>(std::min(size, max_chunk));
+
+            while (zs.avail_out > 0) {
+                if (zs.avail_in == 0) {
+                    if (pos == end) {
+                        if (!member_end) {
+                            throw DecompressionError("gzip: unexpected end of file");
+                        }
+                        break;
+                    }
+                    auto chunk = std::min(static_cast<std::size_t>(end - pos), max_chunk);
+                    zs.next_in = const_cast<Bytef*>(pos);
+                    zs.avail_in = static_cast<uInt>(chunk);
+                    pos += chunk;
+                }
+                if (member_end) {
+                    // another member follows
+                    inflateReset(&zs);
+                    member_end = false;
+                }
+
+                auto ret = inflate(&zs, Z_NO_FLUSH);
+                if (ret == Z_STREAM_END) {
+                    member_end = true;
+                } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+                    throw DecompressionError(std::string("gzip: ")
+                        + (zs.msg ? zs.msg : "corrupt data"));
+                }
+            }
+            return static_cast<std::size_t>(
+                reinterpret_cast<char*>(zs.next_out) - out);
+        }
+
+    }; // GzipDecoder
+#endif
+
+#ifdef HUBERO_HAVE_LZMA
+    class XzDecoder : public Decoder {
+
+        lzma_stream strm;
+        bool finished;
+
+    public:
+
+        XzDecoder(const unsigned char* data, std::size_t size)
+        : strm(LZMA_STREAM_INIT), finished(false)
+        {
+            if (lzma_stream_decoder(&strm, UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK) {
+                throw DecompressionError("cannot initialize liblzma");
+            }
+            strm.next_in = data;
+            strm.avail_in = size;
+        }
+
+        ~XzDecoder()
+        {
+            lzma_end(&strm);
+        }
+
+        std::size_t decode(char* out, std::size_t size) override
+        {
+            strm.next_out = reinterpret_cast<std::uint8_t*>(out);
+            strm.avail_out = size;
+
+            while (strm.avail_out > 0 && !finished) {
+                auto ret = lzma_code(&strm, LZMA_FINISH); // all input is there
+                if (ret == LZMA_STREAM_END) {
+                    finished = true;
+                } else if (ret == LZMA_BUF_ERROR) {
+                    throw DecompressionError("xz: unexpected end of file");
+                } else if (ret != LZMA_OK) {
+                    throw DecompressionError("xz: corrupt data (error "
+                        + std::to_string(static_cast<int>(ret)) + ")");
+                }
+            }
+            return size - strm.avail_out;
+        }
+
+    }; // XzDecoder
+#endif
+
+#ifdef HUBERO_HAVE_ZSTD
+    class ZstdDecoder : public Decoder {
+
+        ZSTD_DStream* stream;
+        ZSTD_inBuffer in;
+        std::size_t pending; // 0 after a complete frame
+
+    public:
+
+        ZstdDecoder(const unsigned char* data, std::size_t size)
+        : stream(ZSTD_createDStream()), pending(0)
+        {
+            if (stream == nullptr || ZSTD_isError(ZSTD_initDStream(stream))) {
+                ZSTD_freeDStream(stream);
+                throw DecompressionError("cannot initialize libzstd");
+            }
+            in.src = data;
+            in.size = size;
+            in.pos = 0;
+        }
+
+        ~ZstdDecoder()
+        {
+            ZSTD_freeDStream(stream);
+        }
+
+        std::size_t decode(char* out, std::size_t size) override
+        {
+            ZSTD_outBuffer buffer = {out, size, 0};
+            while (buffer.pos < buffer.size) {
+                if (in.pos == in.size && pending == 0) {
+                    break;
+                }
+                auto before = buffer.pos;
+                auto ret = ZSTD_decompressStream(stream, &buffer, &in);
+                if (ZSTD_isError(ret)) {
+                    throw DecompressionError(std::string("zstd: ") + ZSTD_getErrorName(ret));
+                }
+                pending = ret;
+                if (in.pos == in.size && pending != 0 && buffer.pos == before) {
+                    throw DecompressionError("zstd: unexpected end of file");
+                }
+            }
+            return buffer.pos;
+        }
+
+    }; // ZstdDecoder
+#endif
+
+    inline std::unique_ptr<Decoder> make_decoder(Compression compression,
+        const unsigned char* data, std::size_t size)
+    {
+        switch (compression) {
+#ifdef HUBERO_HAVE_ZLIB
+        case Compression::gzip:
+            return std::unique_ptr<Decoder>(new GzipDecoder(data, size));
+#endif
+#ifdef HUBERO_HAVE_LZMA
+        case Compression::xz:
+            return std::unique_ptr<Decoder>(new XzDecoder(data, size));
+#endif
+#ifdef HUBERO_HAVE_ZSTD
+        case Compression::zstd:
+            return std::unique_ptr<Decoder>(new ZstdDecoder(data, size));
+#endif
+        default:
+            throw DecompressionError(std::string("hubero was built without ")
+                + to_string(compression) + " support");
+        }
+    }
+
+    // Decompresses on a worker thread into two alternating buffers, so that
+    // one block is parsed while the next one is being decompressed.
+    //
+    // Blocks are cut after the last complete line, the rest of the line is
+    // carried over to the next block. Lines longer than a block make the
+    // buffer grow.
+    class Pipeline {
+
+        tools::MappedFile file;
+        std::unique_ptr<Decoder> decoder;
+        std::size_t block_size;
+
+        std::vector<char> buffers[2];
+        std::size_t lengths[2];
+        bool filled[2];
+        unsigned consumer_slot;
+        bool holding; // the consumer reads from buffers[consumer_slot]
+
+        bool done;
+        bool stopping;
+        std::exception_ptr error;
+
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::thread worker;
+
+    public:
+
+        Pipeline(const std::string& path, std::size_t block)
+        : file(path)
+        , block_size(std::max<std::size_t>(block, 1))
+        , consumer_slot(0), holding(false)
+        , done(false), stopping(false)
+        {
+            auto data = reinterpret_cast<const unsigned char*>(file.data());
+            decoder = make_decoder(detect_compression(data, file.size()), data, file.size());
+
+            lengths[0] = lengths[1] = 0;
+            filled[0] = filled[1] = false;
+            worker = std::thread(&Pipeline::run, this);
+        }
+
+        Pipeline(const Pipeline&) = delete;
+        Pipeline& operator =(const Pipeline&) = delete;
+
+        ~Pipeline()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            changed.notify_all();
+            worker.join();
+        }
+
+        // Hands over the next block and takes back the previous one
+        bool next(const char*& begin, const char*& end)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (holding) {
+                release(lock);
+            }
+
+            for (;;) {
+                changed.wait(lock, [this] { return filled[consumer_slot] || done; });
+                if (!filled[consumer_slot]) {
+                    if (error) {
+                        std::rethrow_exception(error);
+                    }
+                    return false;
+                }
+                if (lengths[consumer_slot] == 0) {
+                    release(lock);
+                    continue;
+                }
+
+                holding = true;
+                begin = buffers[consumer_slot].data();
+                end = begin + lengths[consumer_slot];
+                return true;
+            }
+        }
+
+    private:
+
+        void release(std::unique_lock<std::mutex>&)
+        {
+            filled[consumer_slot] = false;
+            consumer_slot ^= 1;
+            holding = false;
+            changed.notify_all();
+        }
+
+        void run()
+        {
+            try {
+                std::vector<char> carry;
+                for (unsigned slot = 0;; slot ^= 1) {
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        changed.wait(lock, [&] { return !filled[slot] || stopping; });
+                        if (stopping) {
+                            return;
+                        }
+                    }
+
+                    // the buffer is not shared until it is filled
+                    auto& buffer = buffers[slot];
+                    if (buffer.size() < carry.size() + block_size) {
+                        buffer.resize(carry.size() + block_size);
+                    }
+                    std::copy(carry.begin(), carry.end(), buffer.begin());
+                    auto length = carry.size();
+
+                    bool eof = false;
+                    std::size_t cut;
+                    for (;;) {
+                        while (length < buffer.size() && !eof) {
+                            auto n = decoder->decode(buffer.data() + length,
+                                buffer.size() - length);
+                            length += n;
+                            eof = n == 0;
+                        }
+                        if (eof) {
+                            cut = length;
+                            break;
+                        }
+
+                        cut = length;
+                        while (cut > 0 && buffer[cut - 1] != '\n') {
+                            --cut;
+                        }
+                        if (cut > 0) {
+                            break;
+                        }
+                        buffer.resize(2 * buffer.size()); // a very long line
+                    }
+                    carry.assign(buffer.begin() + static_cast<std::ptrdiff_t>(cut),
+                        buffer.begin() + static_cast<std::ptrdiff_t>(length));
+
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        lengths[slot] = cut;
+                        filled[slot] = true;
+                        done = eof;
+                    }
+                    changed.notify_all();
+                    if (eof) {
+                        return;
+                    }
+                }
+            } catch (...) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    error = std::current_exception();
+                    done = true;
+                }
+                changed.notify_all();
+            }
+        }
+
+    }; // Pipeline
+
+} // detail
+
+// Default size of the blocks decompressed ahead of the parser
+const std::size_t decompress_block_size = 1 << 20;
+
+// The input is a compressed file (gzip, xz or zstd, if supported), which is
+// decompressed by a background thread, one block ahead of the reader.
+class CompressedSource {
+
+    // on the heap, so that the worker's pointer survives moves
+    std::unique_ptr<detail::Pipeline> pipeline;
+
+public:
+
+    explicit CompressedSource(const std::string& path,
+        std::size_t block_size = decompress_block_size)
+    : pipeline(new detail::Pipeline(path, block_size))
+    {}
+
+    bool next(const char*& begin, const char*& end)
+    {
+        return pipeline->next(begin, end);
+    }
+
+}; // CompressedSource
+
+template<class L>
+using CompressedReader = ReaderT<L, CompressedSource>;
+
+template<class L>
+CompressedReader<L> open_compressed(const std::string& path,
+    std::size_t block_size = decompress_block_size)
+{
+    return CompressedReader<L>(CompressedSource(path, block_size));
+}
+
+} // dimacs
+} // hubero
+#endif // HUBERO_COMPRESSED_SOURCE_H_
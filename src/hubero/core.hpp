@@ -245,9 +245,22 @@ public:
         return static_cast<U>(var_id);
     }
 
+    // Longest output of to_chars()
+    static constexpr std::size_t max_chars()
+    {
+        return tools::max_chars<T>();
+    }
+
+    // Writes the decimal id into [first, last), without allocating
+    tools::ToCharsResult to_chars(char* first, char* last) const
+    {
+        return tools::to_chars(first, last, var_id);
+    }
+
     std::string to_string() const
     {
-        return std::to_string(var_id);
+        char buffer[max_chars()];
+        return std::string(buffer, to_chars(buffer, buffer + sizeof(buffer)).ptr);
     }
 
 }; // VarT
@@ -504,15 +517,23 @@ public:
         return static_cast<U>(lit_id);
     }
 
-    std::string to_string() const
+    // Longest output of to_chars()
+    static constexpr std::size_t max_chars()
     {
-        std::string retval;
-        if (!sign()) {
-            retval += "-";
-        }
+        return tools::max_chars<T>() + 1;
+    }
+
+    // Writes the DIMACS form ("-" for negative literals and the variable)
+    // into [first, last), without allocating
+    tools::ToCharsResult to_chars(char* first, char* last) const
+    {
+        return tools::to_chars(first, last, !sign(), static_cast<T>(lit_id / 2));
+    }
 
-        retval += std::to_string(static_cast<T>(var()));
-        return retval;
+    std::string to_string() const
+    {
+        char buffer[max_chars()];
+        return std::string(buffer, to_chars(buffer, buffer + sizeof(buffer)).ptr);
     }
 }; // LitT
 
@@ -767,16 +788,25 @@ public:
         return static_cast<U>(lit_id);
     }
 
-    std::string to_string() const
+    // Longest output of to_chars()
+    static constexpr std::size_t max_chars()
     {
-        std::string retval;
-        if (!sign()) {
-            retval += "-";
-        }
+        return tools::max_chars<T>();
+    }
 
-        auto var_id = static_cast<UNSIGNED_T>(var());
-        retval += std::to_string(var_id);
-        return retval;
+    // Writes the literal into [first, last), without allocating
+    tools::ToCharsResult to_chars(char* first, char* last) const
+    {
+        auto magnitude = sign()
+            ? static_cast<UNSIGNED_T>(lit_id)
+            : static_cast<UNSIGNED_T>(0u - static_cast<UNSIGNED_T>(lit_id));
+        return tools::to_chars(first, last, !sign(), magnitude);
+    }
+
+    std::string to_string() const
+    {
+        char buffer[max_chars()];
+        return std::string(buffer, to_chars(buffer, buffer + sizeof(buffer)).ptr);
     }
 }; // LitT
 
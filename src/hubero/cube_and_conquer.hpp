@@ -0,0 +1,328 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_CUBE_AND_CONQUER_H_
+#define HUBERO_CUBE_AND_CONQUER_H_
+
+#include <hubero/cnf.hpp>
+#include <hubero/core.hpp>
+#include <hubero/lookahead.hpp>
+#include <hubero/solver.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hubero {
+
+struct CubeOptions {
+    unsigned threads = 0;           // 0 for all the hardware threads
+
+    // the initial cubes are split to this depth, 0 for log2(threads) + 4
+    unsigned initial_depth = 0;
+
+    // a cube gets this many conflicts, then it is split again (unless it
+    // has max_depth literals); the limit grows by half with every split
+    std::uint64_t cube_conflicts = 1000;
+    std::size_t max_depth = 40;
+
+    std::size_t lookahead_vars = 32;
+};
+
+struct CubeWorkerStats {
+    std::uint64_t cubes = 0;        // solved, refuted or split
+    std::uint64_t refuted = 0;      // unsatisfiable, by the solver or the cuber
+    std::uint64_t splits = 0;       // ran out of conflicts, split again
+    std::uint64_t stolen = 0;       // taken from other workers
+    std::uint64_t conflicts = 0;
+    double busy_seconds = 0;        // solving and splitting
+};
+
+// Deque of cubes of one worker: the owner works depth-first from the back,
+// thieves take the oldest (likely the hardest) cubes from the front
+class CubeQueue {
+
+    std::deque<std::pair<Cube, std::uint64_t>> cubes; // with conflict limits
+    mutable std::mutex lock;
+
+public:
+
+    void push(Cube cube, std::uint64_t limit)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        cubes.emplace_back(std::move(cube), limit);
+    }
+
+    bool pop(Cube& cube, std::uint64_t& limit)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (cubes.empty()) {
+            return false;
+        }
+        cube = std::move(cubes.back().first);
+        limit = cubes.back().second;
+        cubes.pop_back();
+        return true;
+    }
+
+    bool steal(Cube& cube, std::uint64_t& limit)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (cubes.empty()) {
+            return false;
+        }
+        cube = std::move(cubes.front().first);
+        limit = cubes.front().second;
+        cubes.pop_front();
+        return true;
+    }
+
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        return cubes.size();
+    }
+
+}; // CubeQueue
+
+// Cube-and-conquer: a Lookahead cuber splits the formula into cubes, and
+// a pool of threads solves them as assumptions of incremental solvers.
+//
+// Each worker keeps one solver (and its learnt clauses) for all its cubes
+// and a CubeQueue, idle workers steal from the others. A cube that uses up
+// its conflicts is split again by the worker's own cuber and the halves go
+// to its queue, so hard regions of the search get divided while the easy
+// cubes are solved whole. The first satisfiable cube ends the search, the
+// formula is unsatisfiable once all the cubes are refuted.
+//
+//     CubeAndConquer solver;
+//     if (solver.solve(cnf) == Result::sat) {
+//         for (auto lit : solver.model()) ...
+//     }
+class CubeAndConquer {
+
+    CubeOptions opts;
+    std::vector<CubeWorkerStats> workers;
+    std::vector<dimacs::Lit> model_lits;
+    std::size_t initial_cubes;
+    double elapsed;
+
+public:
+
+    explicit CubeAndConquer(CubeOptions options = CubeOptions())
+    : opts(options), initial_cubes(0), elapsed(0)
+    {}
+
+    CubeOptions& options()
+    {
+        return opts;
+    }
+
+    unsigned num_threads() const
+    {
+        return opts.threads > 0 ? opts.threads : std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    template<class L>
+    Result solve(const CnfT<L>& cnf)
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto threads = num_threads();
+        workers.assign(threads, CubeWorkerStats());
+        model_lits.clear();
+
+        auto depth = opts.initial_depth;
+        if (depth == 0) {
+            depth = 4;
+            for (auto t = threads; t > 1; t /= 2) {
+                ++depth;
+            }
+        }
+        Lookahead cuber(cnf, opts.lookahead_vars);
+        auto cubes = cuber.cubes(depth);
+        initial_cubes = cubes.size();
+
+        std::vector<CubeQueue> queues(threads);
+        for (std::size_t i = 0; i < cubes.size(); ++i) {
+            queues[i % threads].push(std::move(cubes[i]), opts.cube_conflicts);
+        }
+        Shared shared{queues, opts};
+        shared.pending = initial_cubes;
+
+        std::vector<std::exception_ptr> errors(threads);
+        auto run = [&](unsigned i) {
+            try {
+                work(i, cnf, shared, workers[i]);
+            } catch (...) {
+                errors[i] = std::current_exception();
+                shared.stop = true;
+            }
+        };
+        std::vector<std::thread> pool;
+        pool.reserve(threads - 1);
+        for (unsigned i = 1; i < threads; ++i) {
+            pool.emplace_back(run, i);
+        }
+        run(0);
+        for (auto& thread : pool) {
+            thread.join();
+        }
+        for (auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (shared.found) {
+            model_lits = std::move(shared.model);
+            return Result::sat;
+        }
+        return Result::unsat;
+    }
+
+    // A satisfying assignment after Result::sat
+    const std::vector<dimacs::Lit>& model() const
+    {
+        return model_lits;
+    }
+
+    const std::vector<CubeWorkerStats>& worker_stats() const
+    {
+        return workers;
+    }
+
+    // Cubes of the initial split (after dropping the refuted ones)
+    std::size_t num_initial_cubes() const
+    {
+        return initial_cubes;
+    }
+
+    double seconds() const
+    {
+        return elapsed;
+    }
+
+    // Cubes finished per second, all threads together
+    double cube_throughput() const
+    {
+        std::uint64_t cubes = 0;
+        for (const auto& worker : workers) {
+            cubes += worker.cubes;
+        }
+        return elapsed > 0 ? static_cast<double>(cubes) / elapsed : 0.0;
+    }
+
+    // The busiest worker's time over the average, 1 is a perfect balance
+    double load_imbalance() const
+    {
+        double total = 0;
+        double busiest = 0;
+        for (const auto& worker : workers) {
+            total += worker.busy_seconds;
+            busiest = std::max(busiest, worker.busy_seconds);
+        }
+        return total > 0 ? busiest * static_cast<double>(workers.size()) / total : 1.0;
+    }
+
+private:
+
+    struct Shared {
+        std::vector<CubeQueue>& queues;
+        const CubeOptions& opts;
+        std::atomic<std::uint64_t> pending; // queued or being worked on
+        std::atomic<bool> stop;
+        bool found;                        // guarded by found_lock
+        std::vector<dimacs::Lit> model;
+        std::mutex found_lock;
+
+        Shared(std::vector<CubeQueue>& q, const CubeOptions& o)
+        : queues(q), opts(o), pending(0), stop(false), found(false)
+        {}
+    };
+
+    template<class L>
+    static void work(unsigned index, const CnfT<L>& cnf, Shared& shared, CubeWorkerStats& stats)
+    {
+        Solver solver;
+        solver.add_cnf(cnf);
+        solver.set_terminate(&shared.stop);
+        Lookahead cuber(cnf, shared.opts.lookahead_vars);
+
+        auto& queues = shared.queues;
+        auto& own = queues[index];
+        Cube cube;
+        std::uint64_t limit = 0;
+        while (!shared.stop) {
+            if (!own.pop(cube, limit) && !steal(index, queues, cube, limit, stats)) {
+                if (shared.pending == 0) {
+                    break;
+                }
+                std::this_thread::yield();
+                continue;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            for (auto lit : cube) {
+                solver.assume(lit);
+            }
+            auto unlimited = cube.size() >= shared.opts.max_depth;
+            solver.set_conflict_limit(unlimited ? std::numeric_limits<std::uint64_t>::max() : limit);
+            auto before = solver.stats().conflicts;
+            auto result = solver.solve();
+            stats.conflicts += solver.stats().conflicts - before;
+            ++stats.cubes;
+
+            if (result == Result::sat) {
+                std::lock_guard<std::mutex> guard(shared.found_lock);
+                if (!shared.found) {
+                    shared.found = true;
+                    shared.model = solver.model();
+                }
+                shared.stop = true;
+            } else if (result == Result::unsat) {
+                ++stats.refuted;
+            } else if (!shared.stop) {
+                auto parts = cuber.split(cube);
+                ++stats.splits;
+                if (parts.refuted) {
+                    ++stats.refuted;
+                }
+                auto next_limit = limit + limit / 2;
+                shared.pending += parts.children.size();
+                for (auto& part : parts.children) {
+                    own.push(std::move(part), next_limit);
+                }
+            }
+            --shared.pending;
+            stats.busy_seconds += std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+    static bool steal(unsigned index, std::vector<CubeQueue>& queues, Cube& cube,
+        std::uint64_t& limit, CubeWorkerStats& stats)
+    {
+        for (std::size_t k = 1; k < queues.size(); ++k) {
+            if (queues[(index + k) % queues.size()].steal(cube, limit)) {
+                ++stats.stolen;
+                return true;
+            }
+        }
+        return false;
+    }
+
+}; // CubeAndConquer
+
+} // hubero
+#endif // HUBERO_CUBE_AND_CONQUER_H_
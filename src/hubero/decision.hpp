@@ -0,0 +1,152 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_DECISION_H_
+#define HUBERO_DECISION_H_
+
+#include <hubero/activity_heap.hpp>
+#include <hubero/assignment.hpp>
+#include <hubero/core.hpp>
+#include <hubero/vmtf_queue.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace hubero {
+
+// Decision heuristics of SolverT, selected by its template parameter, so
+// the solver calls them directly. Each one provides:
+//
+//     grow_to(max_var)          new variables become candidates
+//     bump(var)                 the variable took part in a conflict
+//     after_conflict(values)    the conflict is learnt, values after backjump
+//     unassigned(var)           the variable is a candidate again
+//     next(values)              an unassigned variable, or Var(0) if none
+//
+// Variable 0 is never a candidate.
+
+// Exponential VSIDS: the most active variable first, from a heap of the
+// given arity
+template<unsigned ARITY = 4>
+class EvsidsT {
+
+    ActivityHeap<Var, ARITY> heap;
+    std::size_t count;
+
+public:
+
+    explicit EvsidsT(double decay = 0.95)
+    : heap(decay), count(1)
+    {}
+
+    template<class U, U U_MAX>
+    void grow_to(VarT<U,U_MAX> max_var)
+    {
+        auto size = static_cast<std::size_t>(max_var) + 1;
+        if (size > count) {
+            heap.grow_to(Var(static_cast<unsigned>(size - 1)));
+            for (; count < size; ++count) {
+                heap.insert(Var(static_cast<unsigned>(count)));
+            }
+        }
+    }
+
+    void bump(Var var)
+    {
+        heap.bump(var);
+    }
+
+    void after_conflict(const Assignment&)
+    {
+        heap.decay();
+    }
+
+    void unassigned(Var var)
+    {
+        heap.insert(var);
+    }
+
+    Var next(const Assignment& values)
+    {
+        while (!heap.empty()) {
+            auto var = heap.pop();
+            if (!values.is_assigned(var)) {
+                return var;
+            }
+        }
+        return Var(0);
+    }
+
+    const ActivityHeap<Var, ARITY>& queue() const
+    {
+        return heap;
+    }
+
+}; // EvsidsT
+
+using Evsids = EvsidsT<>;
+
+// Variable move-to-front: the most recently bumped variable first
+class Vmtf {
+
+    VmtfQueue<Var> list;
+    std::vector<Var> bumped;
+    std::size_t count;
+
+public:
+
+    Vmtf() : count(1) {}
+
+    template<class U, U U_MAX>
+    void grow_to(VarT<U,U_MAX> max_var)
+    {
+        auto size = static_cast<std::size_t>(max_var) + 1;
+        if (size > count) {
+            list.grow_to(Var(static_cast<unsigned>(size - 1)));
+            for (; count < size; ++count) {
+                list.enqueue(Var(static_cast<unsigned>(count)));
+            }
+        }
+    }
+
+    void bump(Var var)
+    {
+        bumped.push_back(var);
+    }
+
+    // Moves the bumped variables to the front, in their old order
+    void after_conflict(const Assignment& values)
+    {
+        std::sort(bumped.begin(), bumped.end(), [this](Var lhs, Var rhs) {
+            return list.stamp(lhs) < list.stamp(rhs);
+        });
+        for (auto var : bumped) {
+            list.move_to_front(var, !values.is_assigned(var));
+        }
+        bumped.clear();
+    }
+
+    void unassigned(Var var)
+    {
+        list.unassigned(var);
+    }
+
+    Var next(const Assignment& values)
+    {
+        return list.next([&values](Var var) {
+            return !values.is_assigned(var);
+        });
+    }
+
+    const VmtfQueue<Var>& queue() const
+    {
+        return list;
+    }
+
+}; // Vmtf
+
+} // hubero
+#endif // HUBERO_DECISION_H_
@@ -0,0 +1,246 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_DIMACS_LOADER_H_
+#define HUBERO_DIMACS_LOADER_H_
+
+#include <hubero/cnf.hpp>
+#include <hubero/compressed_source.hpp>
+#include <hubero/dimacs_reader.hpp>
+#include <hubero/mapped_file.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hubero {
+namespace dimacs {
+
+// Reads all the (remaining) clauses of a reader into a formula. Room for
+// the header's number of clauses is reserved up to max_clauses, what the
+// input can hold (e.g. half its bytes, as a clause takes "0\n" at least),
+// since the headers are often wrong.
+template<class L, class Source>
+CnfT<L> read_all(ReaderT<L, Source>& reader, std::size_t max_clauses = 0)
+{
+    CnfT<L> cnf;
+    const auto& hdr = reader.header();
+    cnf.set_num_vars(hdr.num_vars);
+    cnf.reserve(static_cast<std::size_t>(
+        std::min<std::uint64_t>(hdr.num_clauses, max_clauses)), 0);
+
+    while (reader.next_clause()) {
+        cnf.add_clause(reader.clause());
+    }
+    return cnf;
+}
+
+namespace detail {
+
+    // Finds the first clause boundary after pos: a reader started there
+    // sees whole clauses only.
+    //
+    // The search starts on the next line (so that comments are recognized)
+    // and stops right after the first clause terminator "0".
+    inline const char* next_clause_boundary(const char* pos, const char* end)
+    {
+        pos = static_cast<const char*>(
+            std::memchr(pos, '\n', static_cast<std::size_t>(end - pos)));
+        if (pos == nullptr) {
+            return end;
+        }
+        ++pos;
+
+        while (pos != end) {
+            // at the start of a line
+            while (pos != end && (*pos == ' ' || *pos == '\t' || *pos == '\r')) {
+                ++pos;
+            }
+            if (pos == end) {
+                return end;
+            }
+
+            if (*pos == '%') {
+                return pos; // the end marker, there are no clauses past it
+            }
+
+            if (*pos == 'c' || *pos == 'p') {
+                // comments and misplaced headers are left to the reader
+                pos = static_cast<const char*>(
+                    std::memchr(pos, '\n', static_cast<std::size_t>(end - pos)));
+                if (pos == nullptr) {
+                    return end;
+                }
+                ++pos;
+                continue;
+            }
+
+            while (pos != end && *pos != '\n') {
+                if (is_space(*pos)) {
+                    ++pos;
+                    continue;
+                }
+
+                bool zero = true;
+                auto token = pos;
+                while (pos != end && !is_space(*pos)) {
+                    zero = zero && (*pos == '0' || (*pos == '-' && pos == token));
+                    ++pos;
+                }
+                if (zero && pos - token > (*token == '-' ? 1 : 0)) {
+                    return pos;
+                }
+            }
+            if (pos != end) {
+                ++pos; // '\n'
+            }
+        }
+        return end;
+    }
+
+    template<class L>
+    struct Chunk {
+
+        const char* begin;
+        const char* end;
+
+        CnfT<L> cnf;
+        Header header;
+        std::exception_ptr error;
+
+        void parse()
+        {
+            try {
+                BufferReader<L> reader{BufferSource(begin, end)};
+                header = reader.header();
+                while (reader.next_clause()) {
+                    cnf.add_clause(reader.clause());
+                }
+            } catch (...) {
+                error = std::current_exception();
+            }
+        }
+
+    }; // Chunk
+
+    inline std::size_t count_lines(const char* begin, const char* end)
+    {
+        return static_cast<std::size_t>(std::count(begin, end, '\n'));
+    }
+
+} // detail
+
+// Smallest amount of text worth a thread of its own
+const std::size_t min_parallel_chunk = 1 << 20;
+
+// Parses a DIMACS CNF buffer using several threads.
+//
+// The buffer is split into chunks at clause boundaries, the chunks are
+// parsed into separate formulas in parallel and concatenated in order.
+// Passing 0 threads uses all the hardware threads, but no thread gets
+// less than min_chunk bytes.
+template<class L>
+CnfT<L> parse_parallel(const char* begin, const char* end, unsigned threads = 0,
+    std::size_t min_chunk = min_parallel_chunk)
+{
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    auto size = static_cast<std::size_t>(end - begin);
+    auto max_threads = size / std::max<std::size_t>(min_chunk, 1) + 1;
+    if (threads > max_threads) {
+        threads = static_cast<unsigned>(max_threads);
+    }
+
+    std::vector<detail::Chunk<L>> chunks(threads);
+    auto chunk_begin = begin;
+    for (unsigned i = 0; i < threads; ++i) {
+        auto chunk_end = end;
+        if (i + 1 < threads) {
+            auto split = begin + size / threads * (i + 1);
+            chunk_end = detail::next_clause_boundary(std::max(split, chunk_begin), end);
+        }
+        chunks[i].begin = chunk_begin;
+        chunks[i].end = chunk_end;
+        chunk_begin = chunk_end;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (unsigned i = 1; i < threads; ++i) {
+        workers.emplace_back(&detail::Chunk<L>::parse, &chunks[i]);
+    }
+    chunks[0].parse();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // the errors and the header of the first chunk that has them
+    Header header;
+    std::size_t total_clauses = 0;
+    std::size_t total_lits = 0;
+    for (auto& chunk : chunks) {
+        try {
+            if (chunk.error) {
+                std::rethrow_exception(chunk.error);
+            }
+            if (chunk.header.present) {
+                if (header.present) {
+                    throw ParseError(1, "duplicate header");
+                }
+                if (total_clauses > 0) {
+                    throw ParseError(1, "header must precede all clauses");
+                }
+                header = chunk.header;
+            }
+        } catch (const ParseError& error) {
+            // line numbers are relative to the chunk
+            auto offset = detail::count_lines(begin, chunk.begin);
+            std::string what = error.what();
+            throw ParseError(error.line() + offset,
+                what.substr(what.find(": ") + 2));
+        }
+        total_clauses += chunk.cnf.num_clauses();
+        total_lits += chunk.cnf.num_lits();
+    }
+
+    CnfT<L> cnf;
+    cnf.reserve(total_clauses, total_lits);
+    for (auto& chunk : chunks) {
+        cnf.append(chunk.cnf);
+        chunk.cnf.clear();
+    }
+    cnf.set_num_vars(header.num_vars);
+    return cnf;
+}
+
+// Reads a DIMACS CNF file (memory-mapped) into a formula.
+//
+// Compressed files are streamed through a decompressing thread, the number
+// of threads applies to uncompressed files only.
+template<class L>
+CnfT<L> read_file(const std::string& path, unsigned threads = 1)
+{
+    if (detect_compression(path) != Compression::none) {
+        auto reader = open_compressed<L>(path);
+        return read_all(reader);
+    }
+
+    tools::MappedFile file(path);
+    if (threads == 1) {
+        BufferReader<L> reader{BufferSource(file.begin(), file.end())};
+        return read_all(reader, file.size() / 2);
+    }
+    return parse_parallel<L>(file.begin(), file.end(), threads);
+}
+
+} // dimacs
+} // hubero
+#endif // HUBERO_DIMACS_LOADER_H_
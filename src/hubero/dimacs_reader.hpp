@@ -0,0 +1,526 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_DIMACS_READER_H_
+#define HUBERO_DIMACS_READER_H_
+
+#include <hubero/core.hpp>
+#include <hubero/dimacs_tokenizer.hpp>
+#include <hubero/mapped_file.hpp>
+#include <hubero/simd.hpp>
+#include <hubero/tools.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace hubero {
+namespace dimacs {
+
+class ParseError : public std::runtime_error {
+
+    std::size_t line_no;
+
+public:
+
+    ParseError(std::size_t line, const std::string& message)
+    : std::runtime_error("line " + std::to_string(line) + ": " + message)
+    , line_no(line)
+    {}
+
+    std::size_t line() const
+    {
+        return line_no;
+    }
+
+}; // ParseError
+
+
+
+// The "p cnf <variables> <clauses>" line
+struct Header {
+
+    bool present;
+    std::uint64_t num_vars;
+    std::uint64_t num_clauses;
+
+    Header() : present(false), num_vars(0), num_clauses(0) {}
+
+}; // Header
+
+
+
+// Maps a (non-zero) DIMACS integer onto a literal type.
+//
+// The bounds-checks of from_int() are those of the literal's constructors,
+// so std::out_of_range is thrown for integers the literal cannot represent.
+// The caller of from_int_unchecked() guarantees that |value| <= max_var().
+template<class L>
+struct LitTraits;
+
+template<class T, T MAX>
+struct LitTraits<LitT<T,MAX>> {
+
+    static std::uint64_t max_var()
+    {
+        return static_cast<std::uint64_t>(MAX);
+    }
+
+    static LitT<T,MAX> from_int(std::int64_t value)
+    {
+        return LitT<T,MAX>(value);
+    }
+
+    static LitT<T,MAX> from_int_unchecked(std::int64_t value)
+    {
+        return LitT<T,MAX>(static_cast<T>(value));
+    }
+
+}; // LitTraits<dimacs::LitT>
+
+template<class T, T MAX>
+struct LitTraits<mini::LitT<T,MAX>> {
+
+    static std::uint64_t max_var()
+    {
+        return static_cast<std::uint64_t>(MAX / 2);
+    }
+
+    static mini::LitT<T,MAX> from_int(std::int64_t value)
+    {
+        auto var = VarT<T, MAX / 2>(value < 0 ? -value : value);
+        return mini::LitT<T,MAX>(var, value > 0);
+    }
+
+    static mini::LitT<T,MAX> from_int_unchecked(std::int64_t value)
+    {
+        auto var = static_cast<T>(value < 0 ? -value : value);
+        return mini::LitT<T,MAX>(static_cast<T>(2 * var + (value > 0 ? 1u : 0u)));
+    }
+
+}; // LitTraits<mini::LitT>
+
+
+
+// Sources feed the reader with blocks of text.
+//
+// The reader never sees the same byte twice, and a block must not end in the
+// middle of a token (a literal or a header field). Cutting blocks at line ends
+// is always safe.
+
+// The whole input is one contiguous buffer (which must outlive the reader).
+class BufferSource {
+
+    const char* first;
+    const char* last;
+
+public:
+
+    BufferSource(const char* begin, const char* end)
+    : first(begin), last(end)
+    {}
+
+    explicit BufferSource(const std::string& text)
+    : first(text.data()), last(text.data() + text.size())
+    {}
+
+    bool next(const char*& begin, const char*& end)
+    {
+        if (first == last) {
+            return false;
+        }
+        begin = first;
+        end = last;
+        first = last;
+        return true;
+    }
+
+}; // BufferSource
+
+// The whole input is a memory-mapped file.
+class MappedSource {
+
+    tools::MappedFile file;
+    bool consumed;
+
+public:
+
+    explicit MappedSource(const std::string& path)
+    : file(path), consumed(false)
+    {}
+
+    bool next(const char*& begin, const char*& end)
+    {
+        if (consumed || file.empty()) {
+            return false;
+        }
+        begin = file.begin();
+        end = file.end();
+        consumed = true;
+        return true;
+    }
+
+}; // MappedSource
+
+
+
+// Pull-parser of DIMACS CNF.
+//
+// Clauses are parsed one at a time into a buffer owned by the reader, which
+// is reused from clause to clause. Nothing is allocated per literal, so the
+// formula can be streamed without materializing it:
+//
+//     auto reader = dimacs::open_file<mini::Lit>("formula.cnf");
+//     while (reader.next_clause()) {
+//         for (auto lit : reader.clause()) { ... }
+//     }
+//
+// Clause bodies are tokenized in batches (see dimacs_tokenizer.hpp) and the
+// bounds of the literals are checked once per batch.
+template<class L, class Source>
+class ReaderT {
+
+    Source source;
+
+    const char* pos;
+    const char* end;
+    bool finished;
+
+    bool primed;
+    Header hdr;
+
+    std::vector<L> lits;
+    std::size_t line_no;
+    std::uint64_t clause_count;
+
+    simd::Isa isa;
+    TokenBatch batch;
+    std::size_t batch_next;
+    std::size_t scalar_tokens; // to be parsed one by one
+
+public:
+
+    using lit_type = L;
+
+    explicit ReaderT(Source src)
+    : source(std::move(src))
+    , pos(nullptr), end(nullptr), finished(false)
+    , primed(false)
+    , line_no(1), clause_count(0)
+    , isa(simd::best_isa()), batch_next(0), scalar_tokens(0)
+    {}
+
+    // Instruction set used by the tokenizer (the best available by default)
+    void set_isa(simd::Isa new_isa)
+    {
+        isa = new_isa;
+    }
+
+    // Parses the comments and the header preceding the first clause
+    const Header& header()
+    {
+        prime();
+        return hdr;
+    }
+
+    // Parses the next clause, returns false at the end of the input.
+    //
+    // The last clause is accepted even if the terminating 0 is missing.
+    bool next_clause()
+    {
+        prime();
+        lits.clear();
+
+        for (;;) {
+            // integers tokenized ahead, all within the literal's bounds
+            while (batch_next < batch.size) {
+                auto value = batch.values[batch_next++];
+                if (value == 0) {
+                    ++clause_count;
+                    return true;
+                }
+                lits.push_back(LitTraits<L>::from_int_unchecked(value));
+            }
+
+            if (pos == end && !fill()) {
+                if (lits.empty()) {
+                    return false;
+                }
+                ++clause_count;
+                return true;
+            }
+
+            char c = *pos;
+            if (c == '\n') {
+                ++line_no;
+                ++pos;
+            } else if (is_blank(c)) {
+                ++pos;
+            } else if (c == '-' || is_digit(c)) {
+                if (scalar_tokens == 0) {
+                    if (tokenize_batch()) {
+                        continue;
+                    }
+                } else {
+                    --scalar_tokens;
+                }
+
+                auto value = parse_int();
+                if (value == 0) {
+                    ++clause_count;
+                    return true;
+                }
+                lits.push_back(to_lit(value));
+            } else if (c == 'c') {
+                skip_line();
+            } else if (c == '%') {
+                // SATLIB benchmarks end with "%\n0\n"
+                finished = true;
+                pos = end;
+            } else if (c == 'p') {
+                throw ParseError(line_no, hdr.present
+                    ? "duplicate header"
+                    : "header must precede all clauses");
+            } else {
+                throw unexpected(c);
+            }
+        }
+    }
+
+    // Literals of the clause parsed by the last successful next_clause()
+    tools::Span<const L> clause() const
+    {
+        return tools::Span<const L>(lits.data(), lits.size());
+    }
+
+    // Calls f(tools::Span<const L>) for every remaining clause
+    template<class F>
+    std::uint64_t for_each_clause(F&& f)
+    {
+        while (next_clause()) {
+            f(clause());
+        }
+        return clause_count;
+    }
+
+    std::size_t line() const
+    {
+        return line_no;
+    }
+
+    std::uint64_t clauses_read() const
+    {
+        return clause_count;
+    }
+
+private:
+
+    static bool is_digit(char c)
+    {
+        return static_cast<unsigned char>(c - '0') < 10;
+    }
+
+    static bool is_blank(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    ParseError unexpected(char c) const
+    {
+        return ParseError(line_no,
+            std::string("unexpected character '") + c + "'");
+    }
+
+    // Makes sure that pos != end, returns false at the end of the input
+    bool fill()
+    {
+        while (pos == end) {
+            if (finished || !source.next(pos, end)) {
+                finished = true;
+                pos = end;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Tokenizes a batch of integers, returns false if the input at pos
+    // has to be parsed by parse_int()
+    bool tokenize_batch()
+    {
+        batch.clear();
+        batch_next = 0;
+        auto next = tokenize(pos, end, batch, isa);
+
+        if (batch.max_magnitude > LitTraits<L>::max_var()) {
+            // re-parse one by one, so that the error is reported on the right
+            // line (the first one by the caller, right away)
+            scalar_tokens = batch.size - 1;
+            batch.size = 0;
+            return false;
+        }
+
+        pos = next;
+        line_no += batch.newlines;
+        return batch.size > 0;
+    }
+
+    // Skips everything up to (but excluding) the next line break
+    void skip_line()
+    {
+        for (;;) {
+            auto nl = static_cast<const char*>(
+                std::memchr(pos, '\n', static_cast<std::size_t>(end - pos)));
+            if (nl != nullptr) {
+                pos = nl;
+                return;
+            }
+            pos = end;
+            if (!fill()) {
+                return;
+            }
+        }
+    }
+
+    void prime()
+    {
+        if (primed) {
+            return;
+        }
+        primed = true;
+
+        for (;;) {
+            if (pos == end && !fill()) {
+                return;
+            }
+
+            char c = *pos;
+            if (c == '\n') {
+                ++line_no;
+                ++pos;
+            } else if (is_blank(c)) {
+                ++pos;
+            } else if (c == 'c') {
+                skip_line();
+            } else if (c == 'p') {
+                if (hdr.present) {
+                    throw ParseError(line_no, "duplicate header");
+                }
+                parse_header();
+            } else {
+                return; // the first clause
+            }
+        }
+    }
+
+    void skip_blanks()
+    {
+        while (pos != end && is_blank(*pos)) {
+            ++pos;
+        }
+    }
+
+    void parse_header()
+    {
+        ++pos; // 'p'
+        skip_blanks();
+
+        static const char format[] = "cnf";
+        auto format_len = sizeof(format) - 1;
+        if (static_cast<std::size_t>(end - pos) < format_len
+            || std::memcmp(pos, format, format_len) != 0) {
+            throw ParseError(line_no, "only the 'p cnf' format is supported");
+        }
+        pos += format_len;
+
+        hdr.num_vars = parse_header_field("number of variables");
+        hdr.num_clauses = parse_header_field("number of clauses");
+        hdr.present = true;
+
+        skip_blanks();
+        if (pos != end && *pos != '\n') {
+            throw unexpected(*pos);
+        }
+    }
+
+    std::uint64_t parse_header_field(const char* name)
+    {
+        if (pos == end || !is_blank(*pos)) {
+            throw ParseError(line_no, std::string("malformed header, expected ")
+                + name);
+        }
+        skip_blanks();
+        if (pos == end || !is_digit(*pos)) {
+            throw ParseError(line_no, std::string("malformed header, expected ")
+                + name);
+        }
+
+        std::uint64_t value = 0;
+        auto start = pos;
+        while (pos != end && is_digit(*pos)) {
+            value = value * 10 + static_cast<unsigned>(*pos - '0');
+            if (++pos - start > 18) {
+                throw ParseError(line_no, std::string("malformed header, ")
+                    + name + " is too large");
+            }
+        }
+        return value;
+    }
+
+    std::int64_t parse_int()
+    {
+        bool negative = *pos == '-';
+        if (negative) {
+            ++pos;
+        }
+        if (pos == end || !is_digit(*pos)) {
+            throw ParseError(line_no, "expected a digit after '-'");
+        }
+
+        std::uint64_t value = 0;
+        auto start = pos;
+        while (pos != end && is_digit(*pos)) {
+            value = value * 10 + static_cast<unsigned>(*pos - '0');
+            if (++pos - start > 18) {
+                throw ParseError(line_no, "literal is too large");
+            }
+        }
+        if (pos != end && !is_blank(*pos) && *pos != '\n') {
+            throw unexpected(*pos);
+        }
+
+        auto signed_value = static_cast<std::int64_t>(value);
+        return negative ? -signed_value : signed_value;
+    }
+
+    L to_lit(std::int64_t value) const
+    {
+        try {
+            return LitTraits<L>::from_int(value);
+        } catch (const std::out_of_range& oor) {
+            throw ParseError(line_no, oor.what());
+        }
+    }
+
+}; // ReaderT
+
+template<class L>
+using BufferReader = ReaderT<L, BufferSource>;
+
+template<class L>
+using FileReader = ReaderT<L, MappedSource>;
+
+template<class L>
+FileReader<L> open_file(const std::string& path)
+{
+    return FileReader<L>(MappedSource(path));
+}
+
+} // dimacs
+} // hubero
+#endif // HUBERO_DIMACS_READER_H_
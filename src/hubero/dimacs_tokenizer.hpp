@@ -0,0 +1,361 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_DIMACS_TOKENIZER_H_
+#define HUBERO_DIMACS_TOKENIZER_H_
+
+#include <hubero/simd.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace hubero {
+namespace dimacs {
+
+// Signed integers of a clause body, tokenized ahead of the reader
+struct TokenBatch {
+
+    static const std::size_t capacity = 256;
+
+    std::int64_t values[capacity];
+    std::size_t size;
+
+    // The largest absolute value in the batch, so that the bounds of the
+    // literals can be checked once per batch
+    std::uint64_t max_magnitude;
+
+    // Line breaks consumed by the tokenizer
+    std::size_t newlines;
+
+    TokenBatch() : size(0), max_magnitude(0), newlines(0) {}
+
+    void clear()
+    {
+        size = 0;
+        max_magnitude = 0;
+        newlines = 0;
+    }
+
+    void push(std::int64_t value)
+    {
+        auto magnitude = static_cast<std::uint64_t>(value < 0 ? -value : value);
+        max_magnitude = magnitude > max_magnitude ? magnitude : max_magnitude;
+        values[size++] = value;
+    }
+
+}; // TokenBatch
+
+namespace detail {
+
+    inline bool is_digit(char c)
+    {
+        return static_cast<unsigned char>(c - '0') < 10;
+    }
+
+    // blanks and line breaks
+    inline bool is_space(char c)
+    {
+        return c == ' ' || static_cast<unsigned char>(c - '\t') < 5;
+    }
+
+    // Longest integer the tokenizer accepts (fits std::int64_t)
+    const std::size_t max_digits = 18;
+
+    inline std::uint64_t parse_digits_scalar(const char* digits, std::size_t n)
+    {
+        std::uint64_t value = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            value = value * 10 + static_cast<unsigned>(digits[i] - '0');
+        }
+        return value;
+    }
+
+    // Tokenizes byte by byte, used for CPUs without SIMD and for the tails
+    // of the input too short for a SIMD window.
+    inline const char* tokenize_scalar(const char* p, const char* end,
+        TokenBatch& batch)
+    {
+        while (batch.size < TokenBatch::capacity) {
+            while (p != end && is_space(*p)) {
+                batch.newlines += *p == '\n';
+                ++p;
+            }
+            if (p == end) {
+                return p;
+            }
+
+            auto token = p;
+            bool negative = *p == '-';
+            if (negative) {
+                ++p;
+            }
+            auto digits = p;
+            while (p != end && is_digit(*p)) {
+                ++p;
+            }
+
+            auto n = static_cast<std::size_t>(p - digits);
+            if (n == 0 || n > max_digits || (p != end && !is_space(*p))) {
+                return token; // not an integer, the reader must deal with it
+            }
+
+            auto value = static_cast<std::int64_t>(parse_digits_scalar(digits, n));
+            batch.push(negative ? -value : value);
+        }
+        return p;
+    }
+
+#if defined(HUBERO_X86)
+
+    // Converts up to 8 ASCII digits at once (SWAR, little-endian).
+    // All 8 bytes starting at digits must be readable.
+    inline std::uint64_t parse_eight_digits(const char* digits, std::size_t n)
+    {
+        std::uint64_t chunk;
+        std::memcpy(&chunk, digits, sizeof(chunk));
+        // drop the bytes past the number, zero bytes become leading zeros
+        chunk <<= 8 * (8 - n);
+
+        chunk = ((chunk & 0x0F0F0F0F0F0F0F0Full) * 2561) >> 8;
+        chunk = ((chunk & 0x00FF00FF00FF00FFull) * 6553601) >> 16;
+        return ((chunk & 0x0000FFFF0000FFFFull) * 42949672960001ull) >> 32;
+    }
+
+    // n is the number of (already validated) digits
+    inline std::uint64_t parse_digits(const char* digits, std::size_t n,
+        const char* end)
+    {
+        if (n <= 8) {
+            if (end - digits >= 8) {
+                return parse_eight_digits(digits, n);
+            }
+            return parse_digits_scalar(digits, n);
+        }
+        if (n <= 16) {
+            auto high = parse_eight_digits(digits, n - 8);
+            return high * 100000000u + parse_eight_digits(digits + n - 8, 8);
+        }
+        return parse_digits_scalar(digits, n);
+    }
+
+    // Character classes of a 64-byte window, one bit per byte
+    struct Masks {
+        std::uint64_t token;   // digits and '-'
+        std::uint64_t minus;   // '-'
+        std::uint64_t newline; // '\n'
+        std::uint64_t stop;    // anything but a token or whitespace
+    };
+
+    struct ClassifySse42 {
+
+        HUBERO_TARGET("sse4.2")
+        static Masks classify(const char* p)
+        {
+            const __m128i zero = _mm_set1_epi8('0');
+            const __m128i nine = _mm_set1_epi8(9);
+            const __m128i minus = _mm_set1_epi8('-');
+            const __m128i newline = _mm_set1_epi8('\n');
+            const __m128i tab = _mm_set1_epi8('\t');
+            const __m128i four = _mm_set1_epi8(4);
+            const __m128i space = _mm_set1_epi8(' ');
+
+            Masks m = {0, 0, 0, 0};
+            for (unsigned i = 0; i < 64; i += 16) {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+
+                __m128i d = _mm_sub_epi8(v, zero);
+                __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(d, nine), d);
+                __m128i is_minus = _mm_cmpeq_epi8(v, minus);
+                __m128i is_newline = _mm_cmpeq_epi8(v, newline);
+                // '\t', '\n', '\v', '\f', '\r' are consecutive
+                __m128i w = _mm_sub_epi8(v, tab);
+                __m128i is_space = _mm_or_si128(
+                    _mm_cmpeq_epi8(_mm_min_epu8(w, four), w),
+                    _mm_cmpeq_epi8(v, space));
+
+                auto token = static_cast<std::uint32_t>(
+                    _mm_movemask_epi8(_mm_or_si128(is_digit, is_minus)));
+                auto blank = static_cast<std::uint32_t>(_mm_movemask_epi8(is_space));
+
+                m.token |= static_cast<std::uint64_t>(token) << i;
+                m.minus |= static_cast<std::uint64_t>(
+                    static_cast<std::uint32_t>(_mm_movemask_epi8(is_minus))) << i;
+                m.newline |= static_cast<std::uint64_t>(
+                    static_cast<std::uint32_t>(_mm_movemask_epi8(is_newline))) << i;
+                m.stop |= static_cast<std::uint64_t>(~(token | blank) & 0xFFFFu) << i;
+            }
+            return m;
+        }
+
+    }; // ClassifySse42
+
+    struct ClassifyAvx2 {
+
+        HUBERO_TARGET("avx2")
+        static Masks classify(const char* p)
+        {
+            const __m256i zero = _mm256_set1_epi8('0');
+            const __m256i nine = _mm256_set1_epi8(9);
+            const __m256i minus = _mm256_set1_epi8('-');
+            const __m256i newline = _mm256_set1_epi8('\n');
+            const __m256i tab = _mm256_set1_epi8('\t');
+            const __m256i four = _mm256_set1_epi8(4);
+            const __m256i space = _mm256_set1_epi8(' ');
+
+            Masks m = {0, 0, 0, 0};
+            for (unsigned i = 0; i < 64; i += 32) {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+
+                __m256i d = _mm256_sub_epi8(v, zero);
+                __m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(d, nine), d);
+                __m256i is_minus = _mm256_cmpeq_epi8(v, minus);
+                __m256i is_newline = _mm256_cmpeq_epi8(v, newline);
+                __m256i w = _mm256_sub_epi8(v, tab);
+                __m256i is_space = _mm256_or_si256(
+                    _mm256_cmpeq_epi8(_mm256_min_epu8(w, four), w),
+                    _mm256_cmpeq_epi8(v, space));
+
+                auto token = static_cast<std::uint32_t>(
+                    _mm256_movemask_epi8(_mm256_or_si256(is_digit, is_minus)));
+                auto blank = static_cast<std::uint32_t>(_mm256_movemask_epi8(is_space));
+
+                m.token |= static_cast<std::uint64_t>(token) << i;
+                m.minus |= static_cast<std::uint64_t>(
+                    static_cast<std::uint32_t>(_mm256_movemask_epi8(is_minus))) << i;
+                m.newline |= static_cast<std::uint64_t>(
+                    static_cast<std::uint32_t>(_mm256_movemask_epi8(is_newline))) << i;
+                m.stop |= static_cast<std::uint64_t>(~(token | blank)) << i;
+            }
+            return m;
+        }
+
+    }; // ClassifyAvx2
+
+    inline std::uint64_t low_bits(unsigned n)
+    {
+        return n >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << n) - 1;
+    }
+
+    // Tokenizes 64-byte windows, whose character classes are found by
+    // Classifier. Returns true if a non-integer was found (and p points
+    // to it), false if the rest of the input needs the scalar tokenizer.
+    template<class Classifier>
+    inline bool tokenize_windows(const char*& p, const char* end, TokenBatch& batch)
+    {
+        while (end - p >= 64) {
+            Masks m = Classifier::classify(p);
+
+            unsigned limit = m.stop != 0 ? simd::count_trailing_zeros(m.stop) : 64;
+            std::uint64_t starts = m.token & ~(m.token << 1) & low_bits(limit);
+            // a '-' inside of a token makes it invalid
+            std::uint64_t inner_minus = m.minus & (m.token << 1);
+
+            unsigned consumed = limit;
+            auto next = p + limit;
+            bool stopped = limit < 64;
+
+            while (starts != 0) {
+                unsigned s = simd::count_trailing_zeros(starts);
+                starts &= starts - 1;
+
+                auto token = p + s;
+                unsigned len = simd::count_trailing_zeros(~(m.token >> s));
+                bool valid = (inner_minus >> s & low_bits(len)) == 0;
+                auto after = token + len;
+
+                if (s + len == 64) {
+                    // the token continues past the window
+                    while (after != end && (is_digit(*after) || *after == '-')) {
+                        valid = valid && *after != '-';
+                        ++after;
+                    }
+                    valid = valid && (after == end || is_space(*after));
+                    consumed = 64;
+                    next = after;
+                } else if (s + len == limit) {
+                    valid = false; // followed by a stop character
+                }
+
+                bool negative = *token == '-';
+                auto n = static_cast<std::size_t>(after - token) - negative;
+                if (!valid || n - 1 >= max_digits) { // also catches n == 0
+                    // not an integer, the reader must deal with it
+                    consumed = s;
+                    next = token;
+                    stopped = true;
+                    break;
+                }
+
+                auto value = static_cast<std::int64_t>(
+                    parse_digits(token + negative, n, end));
+                batch.push(negative ? -value : value);
+
+                if (batch.size == TokenBatch::capacity) {
+                    consumed = static_cast<unsigned>(after - p);
+                    next = after;
+                    stopped = true;
+                    break;
+                }
+            }
+
+            batch.newlines += simd::popcount(m.newline & low_bits(consumed));
+            p = next;
+            if (stopped) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // The whole window loop is compiled for the target ISA, so that the
+    // classifier gets inlined into it
+    HUBERO_TARGET_FLATTEN("sse4.2")
+    inline bool tokenize_windows_sse42(const char*& p, const char* end,
+        TokenBatch& batch)
+    {
+        return tokenize_windows<ClassifySse42>(p, end, batch);
+    }
+
+    HUBERO_TARGET_FLATTEN("avx2")
+    inline bool tokenize_windows_avx2(const char*& p, const char* end,
+        TokenBatch& batch)
+    {
+        return tokenize_windows<ClassifyAvx2>(p, end, batch);
+    }
+
+#endif // HUBERO_X86
+
+} // detail
+
+// Tokenizes whitespace-separated integers of a clause body into the batch,
+// until the batch is full or a non-integer (comment, header, garbage, ...)
+// or the end of the input is reached. Returns where the tokenizer stopped.
+//
+// Integers with more than 18 digits are not tokenized. The batch is not
+// cleared beforehand.
+inline const char* tokenize(const char* begin, const char* end,
+    TokenBatch& batch, simd::Isa isa = simd::best_isa())
+{
+    auto p = begin;
+#if defined(HUBERO_X86)
+    if (isa == simd::Isa::avx2 && simd::supports(simd::Isa::avx2)) {
+        if (detail::tokenize_windows_avx2(p, end, batch)) {
+            return p;
+        }
+    } else if (isa != simd::Isa::scalar && simd::supports(simd::Isa::sse42)) {
+        if (detail::tokenize_windows_sse42(p, end, batch)) {
+            return p;
+        }
+    }
+#else
+    static_cast<void>(isa);
+#endif
+    return detail::tokenize_scalar(p, end, batch);
+}
+
+} // dimacs
+} // hubero
+#endif // HUBERO_DIMACS_TOKENIZER_H_
@@ -0,0 +1,325 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_DIMACS_WRITER_H_
+#define HUBERO_DIMACS_WRITER_H_
+
+#include <hubero/cnf.hpp>
+#include <hubero/core.hpp>
+#include <hubero/tools.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <ostream>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+    #include <fcntl.h>
+    #include <io.h>
+    #include <sys/stat.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace hubero {
+namespace dimacs {
+
+// Sinks take the writer's buffer in large blocks.
+
+// Writes to a file descriptor, with one write() call per block.
+class FileSink {
+
+    int fd;
+    bool owned;
+
+public:
+
+    // Creates (or truncates) a file
+    explicit FileSink(const std::string& path)
+    : fd(-1), owned(true)
+    {
+#if defined(_WIN32)
+        fd = ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY,
+            _S_IREAD | _S_IWRITE);
+#else
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+#endif
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                "Cannot open file " + path + " for writing");
+        }
+    }
+
+    // Writes to an open descriptor (such as 1 for the standard output),
+    // which is not closed
+    explicit FileSink(int descriptor)
+    : fd(descriptor), owned(false)
+    {}
+
+    FileSink(FileSink&& other)
+    : fd(other.fd), owned(other.owned)
+    {
+        other.owned = false;
+    }
+
+    FileSink(const FileSink&) = delete;
+    FileSink& operator =(const FileSink&) = delete;
+
+    ~FileSink()
+    {
+        if (owned) {
+#if defined(_WIN32)
+            ::_close(fd);
+#else
+            ::close(fd);
+#endif
+        }
+    }
+
+    void write(const char* data, std::size_t size)
+    {
+        while (size > 0) {
+#if defined(_WIN32)
+            auto chunk = static_cast<unsigned>(std::min<std::size_t>(size, 1u << 30));
+            auto written = ::_write(fd, data, chunk);
+#else
+            auto written = ::write(fd, data, size);
+#endif
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(), "Cannot write DIMACS");
+            }
+            data += written;
+            size -= static_cast<std::size_t>(written);
+        }
+    }
+
+}; // FileSink
+
+// Writes to a standard stream
+class StreamSink {
+
+    std::ostream* out;
+
+public:
+
+    explicit StreamSink(std::ostream& stream)
+    : out(&stream)
+    {}
+
+    void write(const char* data, std::size_t size)
+    {
+        out->write(data, static_cast<std::streamsize>(size));
+        if (!*out) {
+            throw std::runtime_error("Cannot write DIMACS");
+        }
+    }
+
+}; // StreamSink
+
+
+
+// Buffered writer of DIMACS CNF formulas and models.
+//
+// Literals are formatted by their to_chars() members straight into one
+// reusable buffer, which is handed to the sink whenever it fills up, so
+// nothing is allocated per literal:
+//
+//     dimacs::FileWriter out{dimacs::FileSink("formula.cnf")};
+//     out.write(cnf);
+//     out.flush();
+//
+// The destructor flushes too, but swallows the errors.
+template<class Sink>
+class WriterT {
+
+    Sink sink;
+    std::vector<char> buffer;
+    std::size_t used;
+
+public:
+
+    explicit WriterT(Sink snk, std::size_t buffer_size = 1 << 20)
+    : sink(std::move(snk))
+    , buffer(std::max<std::size_t>(buffer_size, 64))
+    , used(0)
+    {}
+
+    WriterT(WriterT&& other)
+    : sink(std::move(other.sink))
+    , buffer(std::move(other.buffer))
+    , used(other.used)
+    {
+        other.used = 0;
+    }
+
+    WriterT(const WriterT&) = delete;
+    WriterT& operator =(const WriterT&) = delete;
+
+    ~WriterT()
+    {
+        try {
+            flush();
+        } catch (...) {
+            // call flush() to see the errors
+        }
+    }
+
+    // Hands the buffered text to the sink
+    void flush()
+    {
+        if (used > 0) {
+            sink.write(buffer.data(), used);
+            used = 0;
+        }
+    }
+
+    // "p cnf <vars> <clauses>"
+    void header(std::uint64_t num_vars, std::uint64_t num_clauses)
+    {
+        text("p cnf ");
+        number(num_vars);
+        put(' ');
+        number(num_clauses);
+        put('\n');
+    }
+
+    // "c <line>", the comment must not contain line breaks
+    void comment(const std::string& line)
+    {
+        text("c ");
+        text(line);
+        put('\n');
+    }
+
+    // Literals followed by " 0" on one line
+    template<class L>
+    void clause(tools::Span<const L> lits)
+    {
+        for (const auto& lit : lits) {
+            literal(lit);
+            put(' ');
+        }
+        text("0\n");
+    }
+
+    template<class L>
+    void clause(std::initializer_list<L> lits)
+    {
+        clause(tools::Span<const L>(lits.begin(), lits.end()));
+    }
+
+    // The header and all clauses
+    template<class L>
+    void write(const CnfT<L>& cnf)
+    {
+        header(cnf.num_vars(), cnf.num_clauses());
+        for (auto clause_lits : cnf) {
+            clause(clause_lits);
+        }
+    }
+
+    // "s SATISFIABLE", "s UNSATISFIABLE" or "s UNKNOWN"
+    void status(const char* answer)
+    {
+        text("s ");
+        text(answer);
+        put('\n');
+    }
+
+    // The model as "v" lines (of at most about 78 characters), ending with "v 0"
+    template<class L>
+    void model(tools::Span<const L> lits)
+    {
+        const std::size_t width = 78;
+        std::size_t column = 1;
+        text("v");
+        for (const auto& lit : lits) {
+            if (column + 1 + L::max_chars() > width) {
+                text("\nv");
+                column = 1;
+            }
+            reserve(1 + L::max_chars()); // no flush in between
+            auto before = used;
+            put(' ');
+            literal(lit);
+            column += used - before;
+        }
+        text(" 0\n");
+    }
+
+    template<class L>
+    void literal(const L& lit)
+    {
+        reserve(L::max_chars());
+        auto end = buffer.data() + buffer.size();
+        used = static_cast<std::size_t>(
+            lit.to_chars(buffer.data() + used, end).ptr - buffer.data());
+    }
+
+    void number(std::uint64_t value)
+    {
+        reserve(tools::max_chars<std::uint64_t>());
+        auto end = buffer.data() + buffer.size();
+        used = static_cast<std::size_t>(
+            tools::to_chars(buffer.data() + used, end, value).ptr - buffer.data());
+    }
+
+    void text(const char* str)
+    {
+        text(str, std::strlen(str));
+    }
+
+    void text(const std::string& str)
+    {
+        text(str.data(), str.size());
+    }
+
+    void text(const char* str, std::size_t size)
+    {
+        while (size > 0) {
+            reserve(1);
+            auto chunk = std::min(size, buffer.size() - used);
+            std::memcpy(buffer.data() + used, str, chunk);
+            used += chunk;
+            str += chunk;
+            size -= chunk;
+        }
+    }
+
+    void put(char c)
+    {
+        reserve(1);
+        buffer[used++] = c;
+    }
+
+private:
+
+    // Makes room for size bytes (at most the buffer's size)
+    void reserve(std::size_t size)
+    {
+        if (buffer.size() - used < size) {
+            flush();
+        }
+    }
+
+}; // WriterT
+
+using FileWriter = WriterT<FileSink>;
+using StreamWriter = WriterT<StreamSink>;
+
+} // dimacs
+} // hubero
+#endif // HUBERO_DIMACS_WRITER_H_
@@ -0,0 +1,487 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_GAUSS_H_
+#define HUBERO_GAUSS_H_
+
+#include <hubero/assignment.hpp>
+#include <hubero/core.hpp>
+#include <hubero/simd.hpp>
+#include <hubero/tools.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <numeric>
+#include <vector>
+
+namespace hubero {
+
+// Parity constraint: the XOR of the variables is the parity
+struct Xor {
+    std::vector<Var> vars; // sorted, distinct
+    bool parity;
+};
+
+// The longest XOR recovered, its 2^6 sign patterns fit in a word
+const std::uint32_t xor_size_limit = 6;
+
+// Recovers XORs from their direct CNF encodings.
+//
+// The XOR of k variables with parity p takes 2^(k-1) clauses over the
+// variables, one for each assignment of the wrong parity. A clause excludes
+// the assignment that makes all of its literals false, whose parity is the
+// number of negative literals, so the encoding is all the sign patterns of
+// one parity. The clauses are sorted by their variables, and each group of
+// clauses over the same variables is matched against both parities:
+//
+//     XorFinder finder(5);
+//     for (auto clause : cnf) {
+//         finder.add_clause(clause);
+//     }
+//     auto xors = finder.find();
+class XorFinder {
+
+    struct Candidate {
+        std::uint32_t start;    // of the sorted literals
+        std::uint32_t size;
+    };
+
+    std::vector<mini::Lit> lits;
+    std::vector<Candidate> candidates;
+    std::uint32_t max_size;
+
+public:
+
+    // XORs of 3 to max_size (at most xor_size_limit) variables are recovered
+    explicit XorFinder(std::uint32_t max_size = 5)
+    : max_size(std::min(max_size, xor_size_limit))
+    {}
+
+    // Remembers the clause if it has the size of an XOR, skips the rest
+    void add_clause(tools::Span<const mini::Lit> clause)
+    {
+        if (clause.size() < 3 || clause.size() > max_size) {
+            return;
+        }
+        auto start = lits.size();
+        lits.insert(lits.end(), clause.begin(), clause.end());
+        std::sort(lits.begin() + start, lits.end());
+        for (auto i = start + 1; i < lits.size(); ++i) {
+            if (static_cast<unsigned>(lits[i].var()) == static_cast<unsigned>(lits[i - 1].var())) {
+                lits.resize(start); // a tautology or a duplicate literal
+                return;
+            }
+        }
+        candidates.push_back(Candidate{static_cast<std::uint32_t>(start),
+            static_cast<std::uint32_t>(clause.size())});
+    }
+
+    void add_clause(std::initializer_list<mini::Lit> clause)
+    {
+        add_clause(tools::Span<const mini::Lit>(clause.begin(), clause.end()));
+    }
+
+    std::vector<Xor> find()
+    {
+        const auto& sorted = lits;
+        auto var_less = [&sorted](const Candidate& lhs, const Candidate& rhs) {
+            if (lhs.size != rhs.size) {
+                return lhs.size < rhs.size;
+            }
+            for (std::uint32_t i = 0; i < lhs.size; ++i) {
+                auto a = static_cast<unsigned>(sorted[lhs.start + i].var());
+                auto b = static_cast<unsigned>(sorted[rhs.start + i].var());
+                if (a != b) {
+                    return a < b;
+                }
+            }
+            return false;
+        };
+        std::sort(candidates.begin(), candidates.end(), var_less);
+
+        std::vector<Xor> xors;
+        std::size_t begin = 0;
+        while (begin < candidates.size()) {
+            auto end = begin + 1;
+            while (end < candidates.size() && !var_less(candidates[begin], candidates[end])) {
+                ++end;
+            }
+            match(begin, end, xors);
+            begin = end;
+        }
+        return xors;
+    }
+
+private:
+
+    // Matches the clauses [begin, end) over the same variables
+    void match(std::size_t begin, std::size_t end, std::vector<Xor>& xors) const
+    {
+        auto size = candidates[begin].size;
+        std::uint32_t half = 1u << (size - 1);
+        if (end - begin < half) {
+            return;
+        }
+
+        // bit i of a pattern is set if the i-th literal is negative
+        std::uint64_t patterns = 0;
+        for (auto c = begin; c < end; ++c) {
+            std::uint32_t pattern = 0;
+            for (std::uint32_t i = 0; i < size; ++i) {
+                if (!lits[candidates[c].start + i].sign()) {
+                    pattern |= 1u << i;
+                }
+            }
+            patterns |= std::uint64_t(1) << pattern;
+        }
+
+        for (unsigned negatives = 0; negatives < 2; ++negatives) {
+            std::uint32_t found = 0;
+            for (std::uint32_t pattern = 0; pattern < 2 * half; ++pattern) {
+                if (simd::popcount(pattern) % 2 == negatives && (patterns >> pattern & 1)) {
+                    ++found;
+                }
+            }
+            if (found == half) {
+                Xor parity_constraint;
+                for (std::uint32_t i = 0; i < size; ++i) {
+                    parity_constraint.vars.push_back(
+                        Var(static_cast<unsigned>(lits[candidates[begin].start + i].var())));
+                }
+                parity_constraint.parity = negatives == 0;
+                xors.push_back(std::move(parity_constraint));
+            }
+        }
+    }
+
+}; // XorFinder
+
+// Splits the XORs into independent systems, sharing no variables
+inline std::vector<std::vector<Xor>> split_xors(const std::vector<Xor>& xors)
+{
+    std::size_t max_var = 0;
+    for (const auto& x : xors) {
+        for (auto var : x.vars) {
+            max_var = std::max<std::size_t>(max_var, static_cast<unsigned>(var));
+        }
+    }
+
+    // union-find over the variables
+    std::vector<std::size_t> parents(max_var + 1);
+    std::iota(parents.begin(), parents.end(), 0);
+    auto find = [&parents](std::size_t var) {
+        while (parents[var] != var) {
+            parents[var] = parents[parents[var]];
+            var = parents[var];
+        }
+        return var;
+    };
+    for (const auto& x : xors) {
+        for (std::size_t i = 1; i < x.vars.size(); ++i) {
+            parents[find(static_cast<unsigned>(x.vars[i]))] = find(static_cast<unsigned>(x.vars[0]));
+        }
+    }
+
+    std::vector<std::vector<Xor>> systems;
+    std::vector<std::size_t> indices(max_var + 1, xors.size());
+    for (const auto& x : xors) {
+        if (x.vars.empty()) {
+            continue;
+        }
+        auto root = find(static_cast<unsigned>(x.vars[0]));
+        if (indices[root] == xors.size()) {
+            indices[root] = systems.size();
+            systems.emplace_back();
+        }
+        systems[indices[root]].push_back(x);
+    }
+    return systems;
+}
+
+struct GaussStats {
+    std::uint64_t eliminations = 0;
+    std::uint64_t skipped = 0;          // the assignment did not change since the last one
+    std::uint64_t row_xors = 0;
+    std::uint64_t propagations = 0;
+    std::uint64_t conflicts = 0;
+};
+
+namespace detail {
+
+    inline void xor_words_scalar(std::uint64_t* dst, const std::uint64_t* src, std::size_t words)
+    {
+        for (std::size_t i = 0; i < words; ++i) {
+            dst[i] ^= src[i];
+        }
+    }
+
+#if defined(HUBERO_X86)
+    // The number of words must be a multiple of 4
+    HUBERO_TARGET("avx2")
+    inline void xor_words_avx2(std::uint64_t* dst, const std::uint64_t* src, std::size_t words)
+    {
+        for (std::size_t i = 0; i < words; i += 4) {
+            auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+            auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_xor_si256(a, b));
+        }
+    }
+#endif // HUBERO_X86
+
+} // detail
+
+// Gauss-Jordan elimination of a system of XORs under a partial assignment.
+//
+// The rows are bit-packed, 64 columns per word, one column per variable and
+// the last one for the parity. Each propagate() reduces a copy of the
+// system to the reduced row echelon form over the unassigned columns (rows
+// are XORed word-wise, by AVX2 where available). Then a row without
+// unassigned variables and of the wrong parity is a conflict, and a row
+// with one unassigned variable implies its value. Both come with a clause
+// over the row's variables, which is implied by the XORs: the conflict is
+// false, the implied literal is the first one and the rest are false.
+//
+// Nothing is eliminated when the matrix's variables have the same values as
+// at the previous call and that one found nothing, e.g. when the search
+// assigned other variables only. (Implications or a conflict are found
+// again, as the caller may have dropped them.)
+//
+//     GaussMatrix matrix(xors);
+//     if (!matrix.propagate(assignment, [](tools::Span<const mini::Lit> reason) {
+//         ... reason[0] is implied
+//     })) {
+//         ... matrix.conflict() is false
+//     }
+class GaussMatrix {
+
+    std::vector<Var> columns;
+    std::size_t stride;                 // words per row, a multiple of 4
+    std::size_t num_rows;
+    std::vector<std::uint64_t> system;  // the XORs as given
+    std::vector<std::uint64_t> rows;    // reduced under the assignment
+
+    std::vector<std::uint64_t> unassigned;  // column masks
+    std::vector<std::uint64_t> truth;
+    std::vector<std::uint64_t> last_unassigned;
+    std::vector<std::uint64_t> last_truth;
+    bool quiet;                         // nothing found under the last masks
+
+    std::vector<std::uint32_t> pivots;
+    std::vector<mini::Lit> clause;
+    simd::Isa isa;
+    GaussStats counters;
+
+public:
+
+    // The AVX2 row operations are used if isa allows and the CPU supports them
+    explicit GaussMatrix(const std::vector<Xor>& xors, simd::Isa isa = simd::best_isa())
+    : stride(0)
+    , num_rows(xors.size())
+    , quiet(false)
+    , isa(isa)
+    {
+        for (const auto& x : xors) {
+            columns.insert(columns.end(), x.vars.begin(), x.vars.end());
+        }
+        auto var_less = [](Var lhs, Var rhs) {
+            return static_cast<unsigned>(lhs) < static_cast<unsigned>(rhs);
+        };
+        std::sort(columns.begin(), columns.end(), var_less);
+        columns.erase(std::unique(columns.begin(), columns.end(), [](Var lhs, Var rhs) {
+            return static_cast<unsigned>(lhs) == static_cast<unsigned>(rhs);
+        }), columns.end());
+
+        stride = (columns.size() + 1 + 255) / 256 * 4;
+        system.assign(num_rows * stride, 0);
+        for (std::size_t r = 0; r < num_rows; ++r) {
+            auto row = system.data() + r * stride;
+            for (auto var : xors[r].vars) {
+                auto column = static_cast<std::size_t>(
+                    std::lower_bound(columns.begin(), columns.end(), var, var_less) - columns.begin());
+                row[column / 64] ^= std::uint64_t(1) << (column % 64);
+            }
+            if (xors[r].parity) {
+                set_bit(row, columns.size());
+            }
+        }
+        unassigned.assign(stride, 0);
+        truth.assign(stride, 0);
+    }
+
+    std::size_t size() const
+    {
+        return num_rows;
+    }
+
+    // The variables of the XORs
+    const std::vector<Var>& vars() const
+    {
+        return columns;
+    }
+
+    // Eliminates under the assignment, calls implied(reason) for each
+    // implied literal (the first one of the reason). Returns false on a
+    // conflict, see conflict().
+    template<class F>
+    bool propagate(const Assignment& values, F implied)
+    {
+        std::fill(unassigned.begin(), unassigned.end(), 0);
+        std::fill(truth.begin(), truth.end(), 0);
+        for (std::size_t c = 0; c < columns.size(); ++c) {
+            auto value = values.value(columns[c]);
+            if (value == Value::undef) {
+                set_bit(unassigned.data(), c);
+            } else if (value == Value::true_) {
+                set_bit(truth.data(), c);
+            }
+        }
+        if (quiet && unassigned == last_unassigned && truth == last_truth) {
+            ++counters.skipped;
+            return true;
+        }
+        last_unassigned = unassigned;
+        last_truth = truth;
+        quiet = false;
+        eliminate();
+        auto propagations = counters.propagations;
+
+        // rows past the pivots have no unassigned variables
+        auto rank = pivots.size();
+        for (auto r = rank; r < num_rows; ++r) {
+            auto row = rows.data() + r * stride;
+            if (true_parity(row) != bit(row, columns.size())) {
+                ++counters.conflicts;
+                build_clause(row, columns.size());
+                return false;
+            }
+        }
+        for (std::size_t r = 0; r < rank; ++r) {
+            auto row = rows.data() + r * stride;
+            if (count_unassigned(row) == 1) {
+                ++counters.propagations;
+                build_clause(row, pivots[r]);
+                implied(tools::Span<const mini::Lit>(clause.data(), clause.size()));
+            }
+        }
+        quiet = counters.propagations == propagations;
+        return true;
+    }
+
+    // The clause false under the assignment, after propagate() returned false
+    tools::Span<const mini::Lit> conflict() const
+    {
+        return tools::Span<const mini::Lit>(clause.data(), clause.size());
+    }
+
+    const GaussStats& stats() const
+    {
+        return counters;
+    }
+
+private:
+
+    static bool bit(const std::uint64_t* row, std::size_t column)
+    {
+        return (row[column / 64] >> (column % 64) & 1) != 0;
+    }
+
+    static void set_bit(std::uint64_t* row, std::size_t column)
+    {
+        row[column / 64] |= std::uint64_t(1) << (column % 64);
+    }
+
+    // Gauss-Jordan over the unassigned columns, their pivot rows go first
+    void eliminate()
+    {
+        ++counters.eliminations;
+        rows = system;
+        pivots.clear();
+        for (std::size_t w = 0; w < stride; ++w) {
+            auto bits = unassigned[w];
+            while (bits != 0 && pivots.size() < num_rows) {
+                auto column = w * 64 + simd::count_trailing_zeros(bits);
+                bits &= bits - 1;
+
+                auto rank = pivots.size();
+                auto r = rank;
+                while (r < num_rows && !bit(rows.data() + r * stride, column)) {
+                    ++r;
+                }
+                if (r == num_rows) {
+                    continue;
+                }
+                auto pivot = rows.data() + rank * stride;
+                if (r != rank) {
+                    std::swap_ranges(pivot, pivot + stride, rows.data() + r * stride);
+                }
+                for (std::size_t other = 0; other < num_rows; ++other) {
+                    auto row = rows.data() + other * stride;
+                    if (other != rank && bit(row, column)) {
+                        xor_rows(row, pivot);
+                    }
+                }
+                pivots.push_back(static_cast<std::uint32_t>(column));
+            }
+        }
+    }
+
+    void xor_rows(std::uint64_t* dst, const std::uint64_t* src)
+    {
+        ++counters.row_xors;
+#if defined(HUBERO_X86)
+        if (isa == simd::Isa::avx2 && simd::supports(simd::Isa::avx2)) {
+            detail::xor_words_avx2(dst, src, stride);
+            return;
+        }
+#endif
+        detail::xor_words_scalar(dst, src, stride);
+    }
+
+    bool true_parity(const std::uint64_t* row) const
+    {
+        unsigned ones = 0;
+        for (std::size_t w = 0; w < stride; ++w) {
+            ones += simd::popcount(row[w] & truth[w]);
+        }
+        return ones % 2 == 1;
+    }
+
+    unsigned count_unassigned(const std::uint64_t* row) const
+    {
+        unsigned count = 0;
+        for (std::size_t w = 0; w < stride; ++w) {
+            count += simd::popcount(row[w] & unassigned[w]);
+        }
+        return count;
+    }
+
+    // The row's clause: the literal of the unassigned column (if any) that
+    // makes the parity right, then the assigned variables' false literals
+    void build_clause(const std::uint64_t* row, std::size_t implied_column)
+    {
+        clause.clear();
+        if (implied_column < columns.size()) {
+            auto value = true_parity(row) != bit(row, columns.size());
+            clause.push_back(mini::Lit(columns[implied_column], value));
+        }
+        for (std::size_t w = 0; w < stride; ++w) {
+            auto bits = row[w] & ~unassigned[w];
+            while (bits != 0) {
+                auto column = w * 64 + simd::count_trailing_zeros(bits);
+                bits &= bits - 1;
+                if (column < columns.size()) {
+                    clause.push_back(mini::Lit(columns[column], !bit(truth.data(), column)));
+                }
+            }
+        }
+    }
+
+}; // GaussMatrix
+
+} // hubero
+#endif // HUBERO_GAUSS_H_
@@ -0,0 +1,447 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_LOCAL_SEARCH_H_
+#define HUBERO_LOCAL_SEARCH_H_
+
+#include <hubero/assignment.hpp>
+#include <hubero/clause_arena.hpp>
+#include <hubero/cnf.hpp>
+#include <hubero/core.hpp>
+#include <hubero/maps.hpp>
+#include <hubero/simd.hpp>
+#include <hubero/solver.hpp>
+#include <hubero/tools.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace hubero {
+
+struct LocalSearchStats {
+    std::uint64_t flips = 0;
+    std::uint64_t best_unsatisfied = 0;     // fewest unsatisfied clauses seen
+    double seconds = 0;
+
+    double flips_per_second() const
+    {
+        return seconds > 0 ? static_cast<double>(flips) / seconds : 0.0;
+    }
+};
+
+// Tunables of LocalSearch
+struct LocalSearchOptions {
+    // ProbSAT picks a variable of the clause with the probability of
+    // (eps + break)^-cb (the defaults suit 3-SAT); WalkSAT flips a variable
+    // of break 0 if there is any, a random one with the probability of
+    // noise, one of the least break otherwise
+    bool walksat = false;
+    double cb = 2.38;
+    double eps = 1.0;
+    double noise = 0.567;
+
+    std::uint32_t seed = 1;
+};
+
+namespace detail {
+
+    // Position of the satisfied clauses in LocalSearch's unsatisfied ones
+    const std::uint32_t unlisted = std::numeric_limits<std::uint32_t>::max();
+
+    // ProbSAT's weights of breaks 0..63 (and more)
+    const std::size_t break_table_size = 64;
+
+    // Lanes of the AVX2 loops, the buffers are padded to a multiple of it
+    const std::size_t break_lanes = 8;
+
+    inline void gather_breaks_scalar(const std::uint32_t* codes, std::size_t count,
+        const std::uint32_t* breaks, std::uint32_t* out)
+    {
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = breaks[codes[i] >> 1];
+        }
+    }
+
+    inline float break_weights_scalar(const std::uint32_t* codes, std::size_t count,
+        const std::uint32_t* breaks, const float* table, float* out)
+    {
+        float sum = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            auto b = std::min<std::size_t>(breaks[codes[i] >> 1], break_table_size - 1);
+            out[i] = table[b];
+            sum += out[i];
+        }
+        return sum;
+    }
+
+#if defined(HUBERO_X86)
+    // Lanes past the count read variable 0 (with no break count) and
+    // weigh nothing
+    HUBERO_TARGET("avx2")
+    inline __m256i load_vars_avx2(const std::uint32_t* codes, std::size_t count, __m256i& mask)
+    {
+        auto remaining = static_cast<int>(std::min<std::size_t>(count, break_lanes));
+        mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(remaining),
+            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        auto code = _mm256_maskload_epi32(reinterpret_cast<const int*>(codes), mask);
+        return _mm256_srli_epi32(code, 1);
+    }
+
+    // Gathers the break counts of 8 literals per step
+    HUBERO_TARGET("avx2")
+    inline void gather_breaks_avx2(const std::uint32_t* codes, std::size_t count,
+        const std::uint32_t* breaks, std::uint32_t* out)
+    {
+        auto base = reinterpret_cast<const int*>(breaks);
+        for (std::size_t i = 0; i < count; i += break_lanes) {
+            __m256i mask;
+            auto var = load_vars_avx2(codes + i, count - i, mask);
+            auto b = _mm256_i32gather_epi32(base, var, 4);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), b);
+        }
+    }
+
+    // Gathers the break counts of 8 literals per step, and their weights
+    // from the table
+    HUBERO_TARGET("avx2")
+    inline float break_weights_avx2(const std::uint32_t* codes, std::size_t count,
+        const std::uint32_t* breaks, const float* table, float* out)
+    {
+        auto base = reinterpret_cast<const int*>(breaks);
+        auto last = _mm256_set1_epi32(static_cast<int>(break_table_size - 1));
+        auto sums = _mm256_setzero_ps();
+        for (std::size_t i = 0; i < count; i += break_lanes) {
+            __m256i mask;
+            auto var = load_vars_avx2(codes + i, count - i, mask);
+            auto b = _mm256_min_epu32(_mm256_i32gather_epi32(base, var, 4), last);
+            auto weight = _mm256_and_ps(_mm256_i32gather_ps(table, b, 4), _mm256_castsi256_ps(mask));
+            _mm256_storeu_ps(out + i, weight);
+            sums = _mm256_add_ps(sums, weight);
+        }
+        auto half = _mm_add_ps(_mm256_castps256_ps128(sums), _mm256_extractf128_ps(sums, 1));
+        half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+        half = _mm_add_ss(half, _mm_shuffle_ps(half, half, 1));
+        return _mm_cvtss_f32(half);
+    }
+#endif // HUBERO_X86
+
+} // detail
+
+// Stochastic local search (ProbSAT or WalkSAT, see LocalSearchOptions) for
+// satisfiable formulas.
+//
+// The clauses live in a ClauseArena. Each clause keeps its number of true
+// literals and the XOR of its true variables, which is the critical
+// variable when there is only one; the break count of a variable is the
+// number of clauses in which it is critical. A flip updates both through
+// the occurrence lists of the two literals. The unsatisfied clauses are a
+// dense array with swap-remove, so a random one is a single lookup.
+//
+// The break counts of a picked clause's variables are gathered and turned
+// into ProbSAT's weights 8 literals at a time by AVX2 where available:
+//
+//     LocalSearch sls;
+//     sls.add_cnf(cnf);
+//     if (sls.solve(1000000) == Result::sat) {
+//         ... sls.assignment() satisfies the formula
+//     }
+class LocalSearch {
+
+    ClauseArena clauses;
+    std::vector<ClauseRef> refs;
+    LitMap<std::vector<std::uint32_t>> occurs;  // clause indices
+
+    Assignment values;
+    std::vector<std::uint32_t> true_counts;     // per clause
+    std::vector<std::uint32_t> critical;        // XOR of the true variables
+    std::vector<std::uint32_t> breaks;          // per variable, plain for gathers
+    std::vector<std::uint32_t> unsatisfied;
+    std::vector<std::uint32_t> positions;       // in unsatisfied, or unlisted
+    bool initialized;
+    bool empty_clause;
+
+    LocalSearchOptions opts;
+    std::mt19937 rng;
+    float table[detail::break_table_size];
+    std::vector<std::uint32_t> break_buffer;
+    std::vector<float> weight_buffer;
+    std::vector<mini::Lit> clause_buffer;
+    simd::Isa isa;
+    LocalSearchStats counters;
+
+public:
+
+    // The AVX2 evaluation is used if isa allows and the CPU supports it
+    explicit LocalSearch(LocalSearchOptions options = LocalSearchOptions(),
+        simd::Isa isa = simd::best_isa())
+    : initialized(false)
+    , empty_clause(false)
+    , opts(options)
+    , rng(options.seed)
+    , isa(isa)
+    {
+        for (std::size_t b = 0; b < detail::break_table_size; ++b) {
+            table[b] = static_cast<float>(std::pow(opts.eps + static_cast<double>(b), -opts.cb));
+        }
+        grow_to(Var(0));
+    }
+
+    // Makes room for the variables up to max_var (add_clause() does too)
+    template<class U, U U_MAX>
+    void grow_to(VarT<U,U_MAX> max_var)
+    {
+        occurs.grow_to(max_var);
+        values.grow_to(max_var);
+        breaks.resize(values.size(), 0);
+    }
+
+    // Adds a clause before the first solve()
+    void add_clause(tools::Span<const mini::Lit> lits)
+    {
+        if (initialized) {
+            throw std::logic_error("Clauses must be added before the search starts.");
+        }
+
+        // sort, drop duplicates, skip tautologies
+        clause_buffer.assign(lits.begin(), lits.end());
+        std::sort(clause_buffer.begin(), clause_buffer.end());
+        clause_buffer.erase(std::unique(clause_buffer.begin(), clause_buffer.end()),
+            clause_buffer.end());
+        for (std::size_t i = 1; i < clause_buffer.size(); ++i) {
+            if (clause_buffer[i] == ~clause_buffer[i - 1]) {
+                return;
+            }
+        }
+        if (clause_buffer.empty()) {
+            empty_clause = true;
+            return;
+        }
+
+        auto index = static_cast<std::uint32_t>(refs.size());
+        for (auto lit : clause_buffer) {
+            grow_to(lit.var());
+            occurs[lit].push_back(index);
+        }
+        refs.push_back(clauses.alloc(tools::Span<const mini::Lit>(
+            clause_buffer.data(), clause_buffer.size())));
+    }
+
+    void add_clause(std::initializer_list<mini::Lit> lits)
+    {
+        add_clause(tools::Span<const mini::Lit>(lits.begin(), lits.end()));
+    }
+
+    template<class T, T MAX>
+    void add_cnf(const CnfT<mini::LitT<T,MAX>>& cnf)
+    {
+        if (cnf.num_vars() > 0) {
+            grow_to(Var(static_cast<unsigned>(cnf.num_vars())));
+        }
+        for (auto clause : cnf) {
+            add_clause(tools::Span<const mini::Lit>(clause.begin(), clause.size()));
+        }
+    }
+
+    // Flips until all the clauses are satisfied (Result::sat) or up to
+    // max_flips times (Result::unknown). The first call starts from a
+    // random assignment, the next ones go on from where the previous one
+    // stopped. Only an empty clause makes it Result::unsat.
+    Result solve(std::uint64_t max_flips)
+    {
+        if (empty_clause) {
+            return Result::unsat;
+        }
+        auto start = std::chrono::steady_clock::now();
+        if (!initialized) {
+            initialize();
+        }
+
+        const auto& arena = clauses;
+        for (std::uint64_t flips = 0; flips < max_flips && !unsatisfied.empty(); ++flips) {
+            auto index = unsatisfied[rng() % unsatisfied.size()];
+            flip(pick(arena[refs[index]]).var());
+            if (unsatisfied.size() < counters.best_unsatisfied) {
+                counters.best_unsatisfied = unsatisfied.size();
+            }
+        }
+
+        counters.seconds += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        return unsatisfied.empty() ? Result::sat : Result::unknown;
+    }
+
+    // The current assignment, all variables are assigned after solve()
+    const Assignment& assignment() const
+    {
+        return values;
+    }
+
+    std::size_t num_unsatisfied() const
+    {
+        return unsatisfied.size();
+    }
+
+    // Number of clauses that the flip of the variable would falsify
+    template<class U, U U_MAX>
+    std::uint32_t break_count(VarT<U,U_MAX> var) const
+    {
+        return breaks[static_cast<std::size_t>(var)];
+    }
+
+    const LocalSearchStats& stats() const
+    {
+        return counters;
+    }
+
+private:
+
+    void initialize()
+    {
+        initialized = true;
+        for (std::size_t v = 1; v < values.size(); ++v) {
+            values.assign(mini::Lit(Var(static_cast<unsigned>(v)), rng() % 2 == 0));
+        }
+
+        true_counts.assign(refs.size(), 0);
+        critical.assign(refs.size(), 0);
+        positions.assign(refs.size(), detail::unlisted);
+        std::fill(breaks.begin(), breaks.end(), 0);
+        unsatisfied.clear();
+
+        std::size_t longest = 0;
+        for (std::size_t c = 0; c < refs.size(); ++c) {
+            auto clause = clauses[refs[c]];
+            longest = std::max<std::size_t>(longest, clause.size());
+            for (auto lit : clause) {
+                if (values.is_true(lit)) {
+                    ++true_counts[c];
+                    critical[c] ^= static_cast<std::uint32_t>(lit.var());
+                }
+            }
+            if (true_counts[c] == 0) {
+                push_unsatisfied(static_cast<std::uint32_t>(c));
+            } else if (true_counts[c] == 1) {
+                ++breaks[critical[c]];
+            }
+        }
+        counters.best_unsatisfied = unsatisfied.size();
+
+        auto padded = (longest + detail::break_lanes - 1) / detail::break_lanes * detail::break_lanes;
+        break_buffer.assign(padded, 0);
+        weight_buffer.assign(padded, 0);
+    }
+
+    bool vectorized() const
+    {
+#if defined(HUBERO_X86)
+        return isa == simd::Isa::avx2 && simd::supports(simd::Isa::avx2);
+#else
+        return false;
+#endif
+    }
+
+    // The literal of the unsatisfied clause to flip
+    mini::Lit pick(ConstClause clause)
+    {
+        static_assert(sizeof(mini::Lit) == sizeof(std::uint32_t)
+            && std::is_standard_layout<mini::Lit>::value,
+            "Literals are gathered as uint32 codes.");
+        auto codes = reinterpret_cast<const std::uint32_t*>(clause.begin());
+        auto size = static_cast<std::size_t>(clause.size());
+
+        if (!opts.walksat) {
+            float sum;
+#if defined(HUBERO_X86)
+            if (vectorized()) {
+                sum = detail::break_weights_avx2(codes, size, breaks.data(), table, weight_buffer.data());
+            } else
+#endif
+            {
+                sum = detail::break_weights_scalar(codes, size, breaks.data(), table, weight_buffer.data());
+            }
+            auto threshold = std::uniform_real_distribution<float>(0, sum)(rng);
+            for (std::size_t i = 0; i + 1 < size; ++i) {
+                threshold -= weight_buffer[i];
+                if (threshold < 0) {
+                    return clause[static_cast<std::uint32_t>(i)];
+                }
+            }
+            return clause[static_cast<std::uint32_t>(size - 1)];
+        }
+
+#if defined(HUBERO_X86)
+        if (vectorized()) {
+            detail::gather_breaks_avx2(codes, size, breaks.data(), break_buffer.data());
+        } else
+#endif
+        {
+            detail::gather_breaks_scalar(codes, size, breaks.data(), break_buffer.data());
+        }
+        auto least = static_cast<std::size_t>(
+            std::min_element(break_buffer.begin(), break_buffer.begin() + size) - break_buffer.begin());
+        if (break_buffer[least] > 0
+            && std::uniform_real_distribution<double>(0, 1)(rng) < opts.noise) {
+            least = rng() % size;
+        }
+        return clause[static_cast<std::uint32_t>(least)];
+    }
+
+    template<class U, U U_MAX>
+    void flip(VarT<U,U_MAX> var)
+    {
+        ++counters.flips;
+        auto v = static_cast<std::uint32_t>(var);
+        mini::Lit made_true(Var(v), values.value(var) == Value::false_);
+        values.assign(made_true);
+
+        for (auto c : occurs[~made_true]) {
+            critical[c] ^= v;
+            if (--true_counts[c] == 0) {
+                push_unsatisfied(c);
+                --breaks[v];
+            } else if (true_counts[c] == 1) {
+                ++breaks[critical[c]];
+            }
+        }
+        for (auto c : occurs[made_true]) {
+            if (true_counts[c] == 0) {
+                remove_unsatisfied(c);
+                ++breaks[v];
+            } else if (true_counts[c] == 1) {
+                --breaks[critical[c]];
+            }
+            ++true_counts[c];
+            critical[c] ^= v;
+        }
+    }
+
+    void push_unsatisfied(std::uint32_t c)
+    {
+        positions[c] = static_cast<std::uint32_t>(unsatisfied.size());
+        unsatisfied.push_back(c);
+    }
+
+    void remove_unsatisfied(std::uint32_t c)
+    {
+        auto last = unsatisfied.back();
+        unsatisfied[positions[c]] = last;
+        positions[last] = positions[c];
+        unsatisfied.pop_back();
+        positions[c] = detail::unlisted;
+    }
+
+}; // LocalSearch
+
+} // hubero
+#endif // HUBERO_LOCAL_SEARCH_H_
@@ -0,0 +1,258 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_LOOKAHEAD_H_
+#define HUBERO_LOOKAHEAD_H_
+
+#include <hubero/clause_arena.hpp>
+#include <hubero/cnf.hpp>
+#include <hubero/core.hpp>
+#include <hubero/maps.hpp>
+#include <hubero/propagator.hpp>
+#include <hubero/tools.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hubero {
+
+// A conjunction of literals, solved as assumptions
+using Cube = std::vector<mini::Lit>;
+
+// Outcome of Lookahead::split()
+struct Split {
+    bool refuted = false;       // the cube propagates to a conflict
+    std::vector<Cube> children; // two, or just the (extended) cube at a leaf
+};
+
+// Lookahead cuber: splits the search space into cubes for
+// cube-and-conquer.
+//
+// A cube is split on the variable whose both literals propagate the most
+// (the product of the two counts, +1 each, as in march), among the
+// unassigned variables of most occurrences (at most candidate_vars of them
+// are scored per split, failed literals aside). A literal whose propagation
+// conflicts is failed, so its negation extends the cube, and the cube is
+// refuted if both literals of a variable fail. The cuber keeps nothing
+// between the calls, so any cube can be split at any time:
+//
+//     Lookahead cuber(cnf);
+//     for (const auto& cube : cuber.cubes(8)) {
+//         for (auto lit : cube) solver.assume(lit);
+//         solver.solve();
+//     }
+class Lookahead {
+
+    Propagator prop;
+    bool conflicting; // the formula itself propagates to a conflict
+    std::vector<Var> candidates; // by occurrences, most first
+    std::size_t max_candidates;
+    std::uint64_t lookaheads;
+
+public:
+
+    template<class L>
+    explicit Lookahead(const CnfT<L>& cnf, std::size_t candidate_vars = 32)
+    : conflicting(false), max_candidates(candidate_vars), lookaheads(0)
+    {
+        if (cnf.num_vars() > 0) {
+            prop.grow_to(Var(static_cast<unsigned>(cnf.num_vars())));
+        }
+        VarMap<std::uint32_t> occurrences;
+        occurrences.grow_to(Var(static_cast<unsigned>(prop.num_vars() - 1)), 0);
+
+        std::vector<mini::Lit> lits;
+        for (auto clause : cnf) {
+            lits.clear();
+            for (auto lit : clause) {
+                lits.push_back(mini::Lit(lit.var(), lit.sign()));
+            }
+            add_clause(lits);
+            for (auto lit : lits) {
+                occurrences.grow_to(lit.var(), 0);
+                ++occurrences[lit.var()];
+            }
+        }
+        conflicting = conflicting || prop.propagate().valid();
+
+        for (std::size_t v = 1; v < prop.num_vars(); ++v) {
+            Var var(static_cast<unsigned>(v));
+            if (occurrences[var] > 0) {
+                candidates.push_back(var);
+            }
+        }
+        std::stable_sort(candidates.begin(), candidates.end(), [&occurrences](Var lhs, Var rhs) {
+            return occurrences[lhs] > occurrences[rhs];
+        });
+    }
+
+    // Whether the formula is refuted by unit propagation alone
+    bool inconsistent() const
+    {
+        return conflicting;
+    }
+
+    // Number of literals propagated to score candidates so far
+    std::uint64_t lookahead_count() const
+    {
+        return lookaheads;
+    }
+
+    // Splits the cube on the best variable, see Split
+    Split split(const Cube& cube)
+    {
+        Split result;
+        Cube extended;
+        if (!apply(cube, extended)) {
+            result.refuted = true;
+            return result;
+        }
+
+        mini::Lit best;
+        double best_score = -1;
+        std::size_t scored = 0;
+        for (std::size_t i = 0; i < candidates.size() && scored < max_candidates; ++i) {
+            auto var = candidates[i];
+            if (prop.value(var) != Value::undef) {
+                continue;
+            }
+
+            mini::Lit positive(var, true);
+            auto pos_count = look(positive);
+            auto neg_count = look(~positive);
+            if (pos_count < 0 && neg_count < 0) {
+                result.refuted = true;
+                break;
+            } else if (pos_count < 0 || neg_count < 0) {
+                // the failed literal's negation is implied, at the cube's level
+                auto implied = pos_count < 0 ? ~positive : positive;
+                prop.assign(implied, ClauseRef());
+                extended.push_back(implied);
+                if (prop.propagate().valid()) {
+                    result.refuted = true;
+                    break;
+                }
+                continue;
+            }
+
+            auto score = (pos_count + 1.0) * (neg_count + 1.0);
+            if (score > best_score) {
+                best_score = score;
+                best = positive;
+            }
+            ++scored;
+        }
+
+        if (!result.refuted && best_score >= 0 && prop.value(best.var()) != Value::undef) {
+            // a later failed literal implied the best one, start over
+            return split(extended);
+        }
+        if (!result.refuted) {
+            if (best_score < 0) {
+                result.children.push_back(extended);
+            } else {
+                result.children.push_back(extended);
+                result.children.back().push_back(best);
+                result.children.push_back(extended);
+                result.children.back().push_back(~best);
+            }
+        }
+        prop.backtrack(0);
+        return result;
+    }
+
+    // Splits the empty cube to the depth (a leaf ends early), dropping the
+    // refuted cubes
+    std::vector<Cube> cubes(unsigned depth)
+    {
+        std::vector<Cube> result;
+        if (conflicting) {
+            return result;
+        }
+        result.push_back(Cube());
+        for (unsigned d = 0; d < depth; ++d) {
+            std::vector<Cube> next;
+            bool any = false;
+            for (const auto& cube : result) {
+                auto parts = split(cube);
+                any = any || parts.children.size() > 1;
+                next.insert(next.end(), parts.children.begin(), parts.children.end());
+            }
+            result.swap(next);
+            if (!any) {
+                break;
+            }
+        }
+        return result;
+    }
+
+private:
+
+    void add_clause(std::vector<mini::Lit>& lits)
+    {
+        std::sort(lits.begin(), lits.end());
+        lits.erase(std::unique(lits.begin(), lits.end()), lits.end());
+        for (std::size_t i = 1; i < lits.size(); ++i) {
+            if (lits[i] == ~lits[i - 1]) {
+                return; // a tautology
+            }
+        }
+        for (auto lit : lits) {
+            prop.grow_to(lit.var());
+        }
+
+        if (lits.empty()) {
+            conflicting = true;
+        } else if (lits.size() == 1) {
+            auto value = prop.value(lits[0]);
+            if (value == Value::false_) {
+                conflicting = true;
+            } else if (value == Value::undef) {
+                prop.assign(lits[0], ClauseRef());
+            }
+        } else {
+            prop.add_clause(tools::Span<const mini::Lit>(lits.data(), lits.size()));
+        }
+    }
+
+    // Assigns the cube at level 1 and propagates, false on a conflict.
+    // Extended gets the cube without the literals true already.
+    bool apply(const Cube& cube, Cube& extended)
+    {
+        prop.backtrack(0);
+        prop.new_level();
+        for (auto lit : cube) {
+            auto value = prop.value(lit);
+            if (value == Value::false_) {
+                return false;
+            } else if (value == Value::undef) {
+                prop.assign(lit, ClauseRef());
+                extended.push_back(lit);
+                if (prop.propagate().valid()) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Literals propagated by the literal, or -1 if it fails
+    long look(mini::Lit lit)
+    {
+        auto before = prop.trail().size();
+        prop.decide(lit);
+        auto conflict = prop.propagate().valid();
+        long count = conflict ? -1 : static_cast<long>(prop.trail().size() - before);
+        lookaheads += prop.trail().size() - before;
+        prop.backtrack(prop.decision_level() - 1);
+        return count;
+    }
+
+}; // Lookahead
+
+} // hubero
+#endif // HUBERO_LOOKAHEAD_H_
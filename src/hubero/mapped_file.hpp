@@ -0,0 +1,177 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_MAPPED_FILE_H_
+#define HUBERO_MAPPED_FILE_H_
+
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace hubero {
+namespace tools {
+
+    // Read-only memory map of a whole file.
+    //
+    // The mapping is released in the destructor. Empty files are not mapped
+    // at all, data() then returns nullptr and size() returns 0.
+    class MappedFile {
+
+        const char* bytes;
+        std::size_t length;
+
+    public:
+
+        MappedFile() : bytes(nullptr), length(0) {}
+
+        explicit MappedFile(const std::string& path)
+        : bytes(nullptr), length(0)
+        {
+#if defined(_WIN32)
+            HANDLE file = CreateFileA(path.c_str(), GENERIC_READ,
+                FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (file == INVALID_HANDLE_VALUE) {
+                throw_last_error("Cannot open file " + path);
+            }
+
+            LARGE_INTEGER file_size;
+            if (!GetFileSizeEx(file, &file_size)) {
+                CloseHandle(file);
+                throw_last_error("Cannot read the size of file " + path);
+            }
+
+            length = static_cast<std::size_t>(file_size.QuadPart);
+            if (length > 0) {
+                HANDLE mapping = CreateFileMappingA(file, nullptr,
+                    PAGE_READONLY, 0, 0, nullptr);
+                if (mapping == nullptr) {
+                    CloseHandle(file);
+                    throw_last_error("Cannot map file " + path);
+                }
+
+                bytes = static_cast<const char*>(
+                    MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                CloseHandle(mapping); // the view keeps the mapping alive
+                if (bytes == nullptr) {
+                    CloseHandle(file);
+                    throw_last_error("Cannot map file " + path);
+                }
+            }
+            CloseHandle(file);
+#else
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                throw_last_error("Cannot open file " + path);
+            }
+
+            struct stat info;
+            if (::fstat(fd, &info) != 0) {
+                close_and_throw(fd, "Cannot read the size of file " + path);
+            }
+
+            length = static_cast<std::size_t>(info.st_size);
+            if (length > 0) {
+                void* addr = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (addr == MAP_FAILED) {
+                    close_and_throw(fd, "Cannot map file " + path);
+                }
+                // the file is read front-to-back, let the kernel read ahead
+                ::madvise(addr, length, MADV_SEQUENTIAL);
+                bytes = static_cast<const char*>(addr);
+            }
+            ::close(fd); // the mapping keeps the file alive
+#endif
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator =(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept
+        : bytes(other.bytes), length(other.length)
+        {
+            other.bytes = nullptr;
+            other.length = 0;
+        }
+
+        MappedFile& operator =(MappedFile&& other) noexcept
+        {
+            if (this != &other) {
+                unmap();
+                std::swap(bytes, other.bytes);
+                std::swap(length, other.length);
+            }
+            return *this;
+        }
+
+        ~MappedFile()
+        {
+            unmap();
+        }
+
+        const char* data() const { return bytes; }
+        std::size_t size() const { return length; }
+        bool empty() const { return length == 0; }
+
+        const char* begin() const { return bytes; }
+        const char* end() const { return bytes + length; }
+
+    private:
+
+        void unmap()
+        {
+            if (bytes != nullptr) {
+#if defined(_WIN32)
+                UnmapViewOfFile(bytes);
+#else
+                ::munmap(const_cast<char*>(bytes), length);
+#endif
+            }
+            bytes = nullptr;
+            length = 0;
+        }
+
+#if defined(_WIN32)
+        [[noreturn]] static void throw_last_error(const std::string& what)
+        {
+            throw std::system_error(static_cast<int>(GetLastError()),
+                std::system_category(), what);
+        }
+#else
+        [[noreturn]] static void throw_last_error(const std::string& what)
+        {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+
+        [[noreturn]] static void close_and_throw(int fd, const std::string& what)
+        {
+            int error = errno; // close() may overwrite it
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), what);
+        }
+#endif
+
+    }; // MappedFile
+
+} // tools
+} // hubero
+#endif // HUBERO_MAPPED_FILE_H_
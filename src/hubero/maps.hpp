@@ -0,0 +1,405 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_MAPS_H_
+#define HUBERO_MAPS_H_
+
+#include <hubero/core.hpp>
+#include <hubero/tools.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hubero {
+
+// Value type of maps which store values 0..3 packed in 2 bits each
+struct TwoBit {};
+
+namespace detail {
+
+    // Array of BITS-wide unsigned values, packed in 64-bit words.
+    //
+    // The bits past size() are always zero, so that whole words can be
+    // compared or counted.
+    template<unsigned BITS>
+    class PackedArray {
+
+        static_assert(BITS == 1 || BITS == 2 || BITS == 4 || BITS == 8,
+            "Packed values must not cross word boundaries.");
+
+        std::vector<std::uint64_t> word_array;
+        std::size_t count;
+
+    public:
+
+        using value_type = typename std::conditional<BITS == 1, bool, std::uint8_t>::type;
+        using const_reference = value_type;
+
+        static const unsigned bits = BITS;
+        static const unsigned per_word = 64 / BITS;
+        static constexpr std::uint64_t mask = (std::uint64_t(1) << BITS) - 1;
+
+        class reference {
+
+            PackedArray* array;
+            std::size_t index;
+
+        public:
+
+            reference(PackedArray* arr, std::size_t i) : array(arr), index(i) {}
+
+            operator value_type() const
+            {
+                return array->get(index);
+            }
+
+            reference& operator =(value_type value)
+            {
+                array->set(index, value);
+                return *this;
+            }
+
+            reference& operator =(const reference& other)
+            {
+                return *this = static_cast<value_type>(other);
+            }
+
+        }; // reference
+
+        PackedArray() : count(0) {}
+
+        std::size_t size() const
+        {
+            return count;
+        }
+
+        value_type get(std::size_t i) const
+        {
+            auto shift = static_cast<unsigned>(i % per_word) * BITS;
+            return static_cast<value_type>((word_array[i / per_word] >> shift) & mask);
+        }
+
+        void set(std::size_t i, value_type value)
+        {
+            auto shift = static_cast<unsigned>(i % per_word) * BITS;
+            auto& word = word_array[i / per_word];
+            word = (word & ~(mask << shift)) | ((static_cast<std::uint64_t>(value) & mask) << shift);
+        }
+
+        value_type operator [](std::size_t i) const
+        {
+            return get(i);
+        }
+
+        reference operator [](std::size_t i)
+        {
+            return reference(this, i);
+        }
+
+        void resize(std::size_t size, value_type value = value_type())
+        {
+            auto old = count;
+            word_array.resize(words_for(size), replicate(value));
+            count = size;
+            // the partial word at the old end, then zeros past the new end
+            for (auto i = old; i < size && i % per_word != 0; ++i) {
+                set(i, value);
+            }
+            clear_tail();
+        }
+
+        void assign(std::size_t size, value_type value)
+        {
+            word_array.assign(words_for(size), replicate(value));
+            count = size;
+            clear_tail();
+        }
+
+        void clear()
+        {
+            word_array.clear();
+            count = 0;
+        }
+
+        // The packed words, value i is at bits (i % per_word) * BITS
+        tools::Span<const std::uint64_t> words() const
+        {
+            return tools::Span<const std::uint64_t>(word_array.data(), word_array.size());
+        }
+
+        tools::Span<std::uint64_t> words()
+        {
+            return tools::Span<std::uint64_t>(word_array.data(), word_array.size());
+        }
+
+        static std::size_t words_for(std::size_t size)
+        {
+            return (size + per_word - 1) / per_word;
+        }
+
+        // The value repeated in every slot of a word
+        static std::uint64_t replicate(value_type value)
+        {
+            auto word = static_cast<std::uint64_t>(value) & mask;
+            for (unsigned shift = BITS; shift < 64; shift *= 2) {
+                word |= word << shift;
+            }
+            return word;
+        }
+
+    private:
+
+        void clear_tail()
+        {
+            if (count % per_word != 0) {
+                word_array.back() &= ~std::uint64_t(0) >> (64 - count % per_word * BITS);
+            }
+        }
+
+    }; // PackedArray
+
+    template<unsigned BITS>
+    constexpr std::uint64_t PackedArray<BITS>::mask;
+
+    // std::vector for most types, packed bits for bool and TwoBit
+    template<class V>
+    struct MapStorage {
+        using type = std::vector<V>;
+    };
+
+    template<>
+    struct MapStorage<bool> {
+        using type = PackedArray<1>;
+    };
+
+    template<>
+    struct MapStorage<TwoBit> {
+        using type = PackedArray<2>;
+    };
+
+    template<class Key>
+    std::size_t key_index(const Key& key)
+    {
+        // the conversion is bounds-checked only if size_t is too small
+        return static_cast<std::size_t>(key);
+    }
+
+} // detail
+
+
+
+// Dense array indexed by variables.
+//
+// Any VarT is a key, regardless of its MAX (such as the variable of a
+// mini::Lit). The indices 0..size()-1 are stored contiguously, operator[]
+// is only bounds-checked by an assertion (at() throws). VarMap<bool> packs
+// the values in bits and VarMap<TwoBit> stores values 0..3 in 2 bits each.
+template<class V>
+class VarMap {
+
+public:
+
+    using storage_type = typename detail::MapStorage<V>::type;
+    using value_type = typename storage_type::value_type;
+    using reference = typename storage_type::reference;
+    using const_reference = typename storage_type::const_reference;
+
+private:
+
+    storage_type values;
+
+public:
+
+    VarMap() {}
+
+    template<class U, U U_MAX>
+    explicit VarMap(VarT<U,U_MAX> max_var, const value_type& value = value_type())
+    {
+        grow_to(max_var, value);
+    }
+
+    // Makes room for all variables up to max_var, new ones are set to value
+    template<class U, U U_MAX>
+    void grow_to(VarT<U,U_MAX> max_var, const value_type& value = value_type())
+    {
+        auto size = detail::key_index(max_var) + 1;
+        if (size > values.size()) {
+            values.resize(size, value);
+        }
+    }
+
+    // Number of indices, i.e. max_var() + 1
+    std::size_t size() const
+    {
+        return values.size();
+    }
+
+    bool empty() const
+    {
+        return values.size() == 0;
+    }
+
+    template<class U, U U_MAX>
+    bool contains(VarT<U,U_MAX> var) const
+    {
+        return detail::key_index(var) < values.size();
+    }
+
+    template<class U, U U_MAX>
+    reference operator [](VarT<U,U_MAX> var)
+    {
+        assert(contains(var) && "Variable out of the map's range");
+        return values[detail::key_index(var)];
+    }
+
+    template<class U, U U_MAX>
+    const_reference operator [](VarT<U,U_MAX> var) const
+    {
+        assert(contains(var) && "Variable out of the map's range");
+        return values[detail::key_index(var)];
+    }
+
+    template<class U, U U_MAX>
+    const_reference at(VarT<U,U_MAX> var) const
+    {
+        if (!contains(var)) {
+            throw std::out_of_range("Variable " + var.to_string()
+                + " is out of the map's range 0.." + std::to_string(size() - 1) + ".");
+        }
+        return values[detail::key_index(var)];
+    }
+
+    // Sets all values
+    void fill(const value_type& value)
+    {
+        values.assign(values.size(), value);
+    }
+
+    void clear()
+    {
+        values.clear();
+    }
+
+    const storage_type& storage() const
+    {
+        return values;
+    }
+
+    storage_type& storage()
+    {
+        return values;
+    }
+
+}; // VarMap
+
+
+
+// Dense array indexed by literals, both polarities of a variable are
+// neighbours (see mini::LitT).
+//
+// The map grows by variables, other than that it behaves like VarMap.
+template<class V, class Key = mini::Lit>
+class LitMap {
+
+public:
+
+    using key_type = Key;
+    using storage_type = typename detail::MapStorage<V>::type;
+    using value_type = typename storage_type::value_type;
+    using reference = typename storage_type::reference;
+    using const_reference = typename storage_type::const_reference;
+
+private:
+
+    storage_type values;
+
+public:
+
+    LitMap() {}
+
+    template<class U, U U_MAX>
+    explicit LitMap(VarT<U,U_MAX> max_var, const value_type& value = value_type())
+    {
+        grow_to(max_var, value);
+    }
+
+    // Makes room for both literals of all variables up to max_var
+    template<class U, U U_MAX>
+    void grow_to(VarT<U,U_MAX> max_var, const value_type& value = value_type())
+    {
+        auto size = 2 * (detail::key_index(max_var) + 1);
+        if (size > values.size()) {
+            values.resize(size, value);
+        }
+    }
+
+    // Number of indices, i.e. twice the number of variables
+    std::size_t size() const
+    {
+        return values.size();
+    }
+
+    bool empty() const
+    {
+        return values.size() == 0;
+    }
+
+    bool contains(Key lit) const
+    {
+        return detail::key_index(lit) < values.size();
+    }
+
+    reference operator [](Key lit)
+    {
+        assert(contains(lit) && "Literal out of the map's range");
+        return values[detail::key_index(lit)];
+    }
+
+    const_reference operator [](Key lit) const
+    {
+        assert(contains(lit) && "Literal out of the map's range");
+        return values[detail::key_index(lit)];
+    }
+
+    const_reference at(Key lit) const
+    {
+        if (!contains(lit)) {
+            throw std::out_of_range("Literal " + lit.to_string()
+                + " is out of the map's range of " + std::to_string(size() / 2)
+                + " variables.");
+        }
+        return values[detail::key_index(lit)];
+    }
+
+    void fill(const value_type& value)
+    {
+        values.assign(values.size(), value);
+    }
+
+    void clear()
+    {
+        values.clear();
+    }
+
+    const storage_type& storage() const
+    {
+        return values;
+    }
+
+    storage_type& storage()
+    {
+        return values;
+    }
+
+}; // LitMap
+
+} // hubero
+#endif // HUBERO_MAPS_H_
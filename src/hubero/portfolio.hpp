@@ -0,0 +1,282 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_PORTFOLIO_H_
+#define HUBERO_PORTFOLIO_H_
+
+#include <hubero/clause_ring.hpp>
+#include <hubero/cnf.hpp>
+#include <hubero/core.hpp>
+#include <hubero/decision.hpp>
+#include <hubero/restart.hpp>
+#include <hubero/solver.hpp>
+#include <hubero/tools.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace hubero {
+
+struct PortfolioOptions {
+    unsigned threads = 0; // 0 for all the hardware threads
+
+    // learnt clauses up to both limits are published to the others
+    std::uint32_t export_lbd = 3;
+    std::size_t export_size = 12;
+
+    // and accepted by their import filters up to these
+    std::uint32_t import_lbd = 3;
+    std::size_t import_size = 12;
+
+    std::size_t ring_words = std::size_t(1) << 18;
+};
+
+// Decides which shared clauses a thread takes: short ones of low LBD, not
+// its own, and not the ones it has seen recently. The recent ones are
+// remembered by hashes in a direct-mapped table, so a repeated clause may
+// slip through once its slot is taken, which only costs a duplicate.
+class ImportFilter {
+
+    std::uint32_t self;
+    std::uint32_t max_lbd;
+    std::size_t max_size;
+    std::vector<std::uint64_t> recent;
+    std::vector<mini::Lit> sorted;
+
+public:
+
+    ImportFilter(std::uint32_t source, std::uint32_t lbd, std::size_t size,
+        std::size_t table_size = 1 << 14)
+    : self(source), max_lbd(lbd), max_size(size), recent(table_size, 0)
+    {}
+
+    bool accept(const SharedClause& clause)
+    {
+        if (clause.source == self || clause.lbd > max_lbd
+            || clause.lits.size() > max_size) {
+            return false;
+        }
+
+        // the same clause from other threads may list the literals in any order
+        sorted.assign(clause.lits.begin(), clause.lits.end());
+        std::sort(sorted.begin(), sorted.end());
+        std::uint64_t hash = 0x9e3779b97f4a7c15u;
+        for (auto lit : sorted) {
+            hash = (hash ^ static_cast<std::uint32_t>(lit)) * 0x100000001b3u;
+        }
+        hash |= 1; // 0 marks empty slots
+        auto& slot = recent[hash % recent.size()];
+        if (slot == hash) {
+            return false;
+        }
+        slot = hash;
+        return true;
+    }
+
+}; // ImportFilter
+
+struct PortfolioWorkerStats {
+    const char* config = "";
+    Result result = Result::unknown;
+    SolverStats solver;
+    std::uint64_t exported = 0;
+    std::uint64_t imported = 0;
+    std::uint64_t filtered = 0;     // shared by others, rejected by the filter
+    std::uint64_t skipped_words = 0; // overwritten before they were read
+};
+
+// Parallel portfolio: the same formula is solved by differently configured
+// SolverT instances, one per thread, and the first answer wins.
+//
+// The threads share their short learnt clauses of low LBD through a
+// lock-free ClauseRing. Each one publishes as it learns and takes the
+// others' clauses through its own ImportFilter whenever it is at level 0
+// (i.e. after restarts), so no thread ever waits for another.
+//
+//     Portfolio portfolio;
+//     if (portfolio.solve(cnf) == Result::sat) {
+//         for (auto lit : portfolio.model()) ...
+//     }
+class Portfolio {
+
+    PortfolioOptions opts;
+    std::vector<PortfolioWorkerStats> workers;
+    std::vector<dimacs::Lit> model_lits;
+    int winning;
+
+public:
+
+    explicit Portfolio(PortfolioOptions options = PortfolioOptions())
+    : opts(options), winning(-1)
+    {}
+
+    PortfolioOptions& options()
+    {
+        return opts;
+    }
+
+    unsigned num_threads() const
+    {
+        return opts.threads > 0 ? opts.threads : std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    template<class L>
+    Result solve(const CnfT<L>& cnf)
+    {
+        auto threads = std::min<unsigned>(num_threads(), max_shared_source + 1);
+        workers.assign(threads, PortfolioWorkerStats());
+        std::vector<std::vector<dimacs::Lit>> models(threads);
+        std::vector<std::exception_ptr> errors(threads);
+        ClauseRing ring(opts.ring_words);
+        std::atomic<bool> stop(false);
+        std::atomic<int> first(-1);
+
+        auto run = [&](unsigned i) {
+            try {
+                Shared shared{ring, stop, first, opts};
+                run_worker(i, cnf, shared, workers[i], models[i]);
+            } catch (...) {
+                errors[i] = std::current_exception();
+                stop = true;
+            }
+        };
+        std::vector<std::thread> pool;
+        pool.reserve(threads - 1);
+        for (unsigned i = 1; i < threads; ++i) {
+            pool.emplace_back(run, i);
+        }
+        run(0);
+        for (auto& thread : pool) {
+            thread.join();
+        }
+        for (auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        winning = first.load();
+        model_lits.clear();
+        if (winning < 0) {
+            return Result::unknown;
+        }
+        model_lits = std::move(models[static_cast<std::size_t>(winning)]);
+        return workers[static_cast<std::size_t>(winning)].result;
+    }
+
+    // The model of the winning thread after Result::sat
+    const std::vector<dimacs::Lit>& model() const
+    {
+        return model_lits;
+    }
+
+    // The thread that answered, -1 if none
+    int winner() const
+    {
+        return winning;
+    }
+
+    const std::vector<PortfolioWorkerStats>& worker_stats() const
+    {
+        return workers;
+    }
+
+private:
+
+    struct Shared {
+        ClauseRing& ring;
+        std::atomic<bool>& stop;
+        std::atomic<int>& first;
+        const PortfolioOptions& opts;
+    };
+
+    // Threads cycle through the decision heuristics and restart policies,
+    // later rounds with other phases and rephasing intervals
+    template<class L>
+    static void run_worker(unsigned index, const CnfT<L>& cnf, const Shared& shared,
+        PortfolioWorkerStats& stats, std::vector<dimacs::Lit>& model)
+    {
+        SolverOptions options;
+        options.initial_phase = (index / 2) % 2 == 1;
+        options.rephase_interval = 1000 * (1 + index / 4);
+        switch (index % 4) {
+            case 0:
+                stats.config = "evsids, glucose";
+                solve_with(SolverT<Evsids, GlucoseRestarts>(), options, index, cnf, shared, stats, model);
+                break;
+            case 1:
+                stats.config = "vmtf, luby";
+                solve_with(SolverT<Vmtf, LubyRestarts>(), options, index, cnf, shared, stats, model);
+                break;
+            case 2:
+                stats.config = "evsids, luby";
+                options.target_phases = false;
+                solve_with(SolverT<Evsids, LubyRestarts>(), options, index, cnf, shared, stats, model);
+                break;
+            default:
+                stats.config = "vmtf, glucose";
+                solve_with(SolverT<Vmtf, GlucoseRestarts>(), options, index, cnf, shared, stats, model);
+                break;
+        }
+    }
+
+    template<class S, class L>
+    static void solve_with(S&& solver, const SolverOptions& options, unsigned index,
+        const CnfT<L>& cnf, const Shared& shared, PortfolioWorkerStats& stats,
+        std::vector<dimacs::Lit>& model)
+    {
+        solver.options() = options;
+        solver.set_terminate(&shared.stop);
+
+        auto source = static_cast<std::uint32_t>(index);
+        auto& ring = shared.ring;
+        const auto& opts = shared.opts;
+        solver.set_export([&](tools::Span<const mini::Lit> lits, std::uint32_t lbd) {
+            if (lbd <= opts.export_lbd && lits.size() <= opts.export_size
+                && ring.push(source, lits, lbd)) {
+                ++stats.exported;
+            }
+        });
+
+        ImportFilter filter(source, opts.import_lbd, opts.import_size);
+        auto cursor = ring.cursor();
+        SharedClause shared_clause;
+        solver.set_import([&](std::vector<mini::Lit>& lits, std::uint32_t& lbd) {
+            while (ring.pop(cursor, shared_clause)) {
+                if (filter.accept(shared_clause)) {
+                    ++stats.imported;
+                    lits.swap(shared_clause.lits);
+                    lbd = shared_clause.lbd;
+                    return true;
+                }
+                if (shared_clause.source != source) {
+                    ++stats.filtered;
+                }
+            }
+            return false;
+        });
+
+        solver.add_cnf(cnf);
+        stats.result = solver.solve();
+        stats.solver = solver.stats();
+        stats.skipped_words = cursor.skipped_words();
+
+        int none = -1;
+        if (stats.result != Result::unknown
+            && shared.first.compare_exchange_strong(none, static_cast<int>(index))) {
+            model = solver.model();
+            shared.stop = true;
+        }
+    }
+
+}; // Portfolio
+
+} // hubero
+#endif // HUBERO_PORTFOLIO_H_
@@ -0,0 +1,201 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_PROBER_H_
+#define HUBERO_PROBER_H_
+
+#include <hubero/clause_arena.hpp>
+#include <hubero/core.hpp>
+#include <hubero/maps.hpp>
+#include <hubero/propagator.hpp>
+#include <hubero/tools.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hubero {
+
+struct ProbeStats {
+    std::uint64_t rounds = 0;
+    std::uint64_t probes = 0;
+    std::uint64_t cached = 0;           // skipped, nothing new since the last probe
+    std::uint64_t failed_literals = 0;  // their negations became units
+    std::uint64_t hyper_binaries = 0;   // resolvents added
+    std::uint64_t ticks = 0;            // literals propagated while probing
+};
+
+// Failed-literal probing with hyper-binary resolution, at level 0 of a
+// Propagator.
+//
+// Only the roots of the binary implication graph are probed (literals
+// implying something through binary clauses, but implied by none), as
+// everything implied by a root is covered by its probe. A probe that
+// conflicts makes the negation of the root a unit.
+//
+// Each literal remembers the level 0 trail size when it was last probed or
+// implied by a successful probe. Until new units arrive it cannot fail, so
+// it is skipped, and a round that runs out of ticks carries on with the
+// roots not probed yet in the next one.
+//
+// While the trail of a probe is walked, the literals implied by long
+// clauses get a hyper-binary resolvent: the clause (~d, x), where d is the
+// closest common dominator of the clause's other literals in the tree of
+// binary implications from the root. The resolvents are added to the
+// propagator as irredundant binary clauses, so later probes (and the
+// search) get the implications without the long clauses.
+//
+//     Prober prober;
+//     if (!prober.probe(prop, 100000)) {
+//         ... the formula is unsatisfiable
+//     }
+class Prober {
+
+    LitMap<std::uint64_t> stamps;   // level 0 trail size + 1 when last covered
+    VarMap<mini::Lit> parents;      // dominator tree of the current probe
+    VarMap<std::uint32_t> depths;
+    std::vector<mini::Lit> roots;
+    ProbeStats counters;
+
+public:
+
+    // Probes the roots until ticks literals are propagated (the last probe
+    // may overshoot). The propagator must be at level 0 and it stays
+    // there. Returns false if the formula is unsatisfiable.
+    bool probe(Propagator& prop, std::uint64_t ticks)
+    {
+        assert(prop.decision_level() == 0 && "Probing starts at level 0");
+        auto max_var = Var(static_cast<unsigned>(prop.num_vars() - 1));
+        stamps.grow_to(max_var, 0);
+        parents.grow_to(max_var, mini::Lit());
+        depths.grow_to(max_var, 0);
+        ++counters.rounds;
+
+        auto start = prop.propagations();
+        if (prop.propagate().valid()) {
+            return false;
+        }
+        collect_roots(prop);
+
+        bool consistent = true;
+        for (auto root : roots) {
+            if (prop.propagations() - start >= ticks) {
+                break;
+            }
+            if (prop.value(root) != Value::undef) {
+                continue;
+            }
+            auto stamp = static_cast<std::uint64_t>(prop.trail().size()) + 1;
+            if (stamps[root] == stamp) {
+                ++counters.cached;
+                continue;
+            }
+
+            ++counters.probes;
+            stamps[root] = stamp;
+            prop.decide(root);
+            auto failed = prop.propagate().valid();
+            if (!failed) {
+                learn_hyper_binaries(prop, stamp);
+            }
+            prop.backtrack(0);
+            if (failed) {
+                ++counters.failed_literals;
+                prop.assign(~root, ClauseRef());
+                if (prop.propagate().valid()) {
+                    consistent = false;
+                    break;
+                }
+            }
+        }
+        counters.ticks += prop.propagations() - start;
+        return consistent;
+    }
+
+    const ProbeStats& stats() const
+    {
+        return counters;
+    }
+
+private:
+
+    // Unassigned literals without a binary clause of their own, but with
+    // binary implications, i.e. the sources of the implication graph
+    void collect_roots(const Propagator& prop)
+    {
+        roots.clear();
+        for (std::size_t v = 1; v < prop.num_vars(); ++v) {
+            Var var(static_cast<unsigned>(v));
+            if (prop.value(var) != Value::undef) {
+                continue;
+            }
+            for (auto lit : {mini::Lit(var, true), mini::Lit(var, false)}) {
+                if (!prop.implications(lit).empty() && prop.implications(~lit).empty()) {
+                    roots.push_back(lit);
+                }
+            }
+        }
+    }
+
+    // Walks the trail of a probe (level 1, no conflict): builds the
+    // dominator tree, adds the hyper-binary resolvents and marks the
+    // implied literals as covered
+    void learn_hyper_binaries(Propagator& prop, std::uint64_t stamp)
+    {
+        auto begin = prop.level_start(1);
+        auto root = prop.trail()[begin];
+        parents[root.var()] = mini::Lit();
+        depths[root.var()] = 0;
+
+        for (auto i = begin + 1; i < prop.trail().size(); ++i) {
+            auto lit = prop.trail()[i];
+            stamps[lit] = stamp;
+            auto clause = prop.arena()[prop.reason(lit.var())];
+
+            mini::Lit dominator;
+            for (auto other : clause) {
+                if (other == lit || prop.level(other.var()) == 0) {
+                    continue;
+                }
+                dominator = dominator == mini::Lit() ? ~other : common_dominator(dominator, ~other);
+            }
+            assert(dominator != mini::Lit() && "Level 1 literals follow from the root");
+            parents[lit.var()] = dominator;
+            depths[lit.var()] = depths[dominator.var()] + 1;
+
+            if (clause.size() > 2 && !implies(prop, dominator, lit)) {
+                prop.add_clause({~dominator, lit});
+                ++counters.hyper_binaries;
+            }
+        }
+    }
+
+    mini::Lit common_dominator(mini::Lit a, mini::Lit b) const
+    {
+        while (a != b) {
+            if (depths[a.var()] >= depths[b.var()]) {
+                a = parents[a.var()];
+            } else {
+                b = parents[b.var()];
+            }
+        }
+        return a;
+    }
+
+    static bool implies(const Propagator& prop, mini::Lit from, mini::Lit to)
+    {
+        for (const auto& edge : prop.implications(from)) {
+            if (edge.other == to) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+}; // Prober
+
+} // hubero
+#endif // HUBERO_PROBER_H_
@@ -0,0 +1,417 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_PROPAGATOR_H_
+#define HUBERO_PROPAGATOR_H_
+
+#include <hubero/assignment.hpp>
+#include <hubero/clause_arena.hpp>
+#include <hubero/core.hpp>
+#include <hubero/maps.hpp>
+#include <hubero/tools.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+namespace hubero {
+
+// Entry of a watch list of a long clause. The blocker is one of the
+// clause's literals, if it is true the clause is satisfied and need not be
+// visited at all.
+struct Watch {
+    ClauseRef ref;
+    mini::Lit blocker;
+};
+
+// Entry of a binary watch list, the other literal is all there is to check
+struct BinaryWatch {
+    mini::Lit other;
+    ClauseRef ref;
+};
+
+// Why and when a variable was assigned
+struct VarInfo {
+    ClauseRef reason; // invalid for decisions and units
+    std::uint32_t level;
+};
+
+// Unit propagation by two watched literals.
+//
+// The clauses live in a ClauseArena, and the two watched literals of each
+// clause are its first two literals. Watch lists are indexed by literals:
+// watches[p] holds the clauses watching ~p, which are visited when p
+// becomes true. Binary clauses have their own watch lists, and are
+// propagated without touching the arena.
+class Propagator {
+
+    ClauseArena clauses;
+    LitMap<std::vector<Watch>> watches;
+    LitMap<std::vector<BinaryWatch>> binaries;
+
+    Assignment values;
+    VarMap<VarInfo> vars;
+
+    std::vector<mini::Lit> trail_lits;
+    std::vector<std::size_t> trail_lims; // trail size at each decision
+    std::size_t qhead;
+
+    std::uint64_t num_propagations;
+
+public:
+
+    Propagator() : qhead(0), num_propagations(0)
+    {
+        grow_to(Var(0));
+    }
+
+    // Makes room for the variables up to max_var
+    template<class U, U U_MAX>
+    void grow_to(VarT<U,U_MAX> max_var)
+    {
+        watches.grow_to(max_var);
+        binaries.grow_to(max_var);
+        values.grow_to(max_var);
+        vars.grow_to(max_var, VarInfo());
+    }
+
+    // Number of variables, including the unused variable 0
+    std::size_t num_vars() const
+    {
+        return vars.size();
+    }
+
+    ClauseArena& arena()
+    {
+        return clauses;
+    }
+
+    const ClauseArena& arena() const
+    {
+        return clauses;
+    }
+
+    const Assignment& assignment() const
+    {
+        return values;
+    }
+
+    // Stores and watches a clause of two or more literals. The first two
+    // literals are watched, so they must be unassigned (or true), unless the
+    // caller knows better (e.g. a learnt clause with the second literal
+    // false at the highest level).
+    ClauseRef add_clause(tools::Span<const mini::Lit> lits, bool learnt = false)
+    {
+        assert(lits.size() >= 2 && "Only clauses of 2+ literals are watched");
+        auto ref = clauses.alloc(lits, learnt);
+        attach(ref);
+        return ref;
+    }
+
+    ClauseRef add_clause(std::initializer_list<mini::Lit> lits, bool learnt = false)
+    {
+        return add_clause(tools::Span<const mini::Lit>(lits.begin(), lits.end()), learnt);
+    }
+
+    // Watches a clause of the arena
+    void attach(ClauseRef ref)
+    {
+        auto clause = clauses[ref];
+        if (clause.size() == 2) {
+            binaries[~clause[0]].push_back(BinaryWatch{clause[1], ref});
+            binaries[~clause[1]].push_back(BinaryWatch{clause[0], ref});
+        } else {
+            watches[~clause[0]].push_back(Watch{ref, clause[1]});
+            watches[~clause[1]].push_back(Watch{ref, clause[0]});
+        }
+    }
+
+    // Frees a clause. It stops propagating at once: a binary one is
+    // detached right away (its watches are not checked while propagating),
+    // the watches of longer ones are dropped lazily and by collect_garbage().
+    void remove_clause(ClauseRef ref)
+    {
+        assert(!locked(ref) && "Reasons of assignments cannot be removed");
+        auto clause = clauses[ref];
+        if (clause.size() == 2) {
+            detach_binary(~clause[0], ref);
+            detach_binary(~clause[1], ref);
+        }
+        clauses.free(ref);
+    }
+
+    // Whether the clause is the reason of an assignment
+    bool locked(ClauseRef ref) const
+    {
+        auto clause = clauses[ref];
+        for (std::uint32_t i = 0; i < 2 && i < clause.size(); ++i) {
+            auto var = clause[i].var();
+            if (values.is_true(clause[i]) && vars[var].reason == ref) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Drops the watches of freed clauses, compacts the arena and remaps all
+    // the references. Returns the relocation for references held elsewhere.
+    Relocation collect_garbage()
+    {
+        drop_freed_watches(watches);
+
+        auto moved = clauses.collect();
+        for (std::size_t i = 0; i < watches.size(); ++i) {
+            for (auto& watch : watches.storage()[i]) {
+                moved.relocate(watch.ref);
+            }
+            for (auto& watch : binaries.storage()[i]) {
+                moved.relocate(watch.ref);
+            }
+        }
+        for (auto lit : trail_lits) {
+            auto& reason = vars[lit.var()].reason;
+            if (reason.valid()) {
+                moved.relocate(reason);
+            }
+        }
+        return moved;
+    }
+
+
+
+    Value value(mini::Lit lit) const
+    {
+        return values.value(lit);
+    }
+
+    template<class U, U U_MAX>
+    Value value(VarT<U,U_MAX> var) const
+    {
+        return values.value(var);
+    }
+
+    template<class U, U U_MAX>
+    std::uint32_t level(VarT<U,U_MAX> var) const
+    {
+        return vars[var].level;
+    }
+
+    template<class U, U U_MAX>
+    ClauseRef reason(VarT<U,U_MAX> var) const
+    {
+        return vars[var].reason;
+    }
+
+    std::uint32_t decision_level() const
+    {
+        return static_cast<std::uint32_t>(trail_lims.size());
+    }
+
+    // All assigned literals, in the order of assignment
+    tools::Span<const mini::Lit> trail() const
+    {
+        return tools::Span<const mini::Lit>(trail_lits.data(), trail_lits.size());
+    }
+
+    // Trail size when the decision level was entered (level >= 1)
+    std::size_t level_start(std::uint32_t level) const
+    {
+        return trail_lims[level - 1];
+    }
+
+    // Number of literals propagated so far
+    std::uint64_t propagations() const
+    {
+        return num_propagations;
+    }
+
+    // The binary clauses that propagate when the literal becomes true, i.e.
+    // the edges of the binary implication graph leaving it
+    tools::Span<const BinaryWatch> implications(mini::Lit lit) const
+    {
+        const auto& list = binaries[lit];
+        return tools::Span<const BinaryWatch>(list.data(), list.size());
+    }
+
+
+    // Opens a new decision level and makes the literal true
+    void decide(mini::Lit lit)
+    {
+        trail_lims.push_back(trail_lits.size());
+        assign(lit, ClauseRef());
+    }
+
+    // Opens a new decision level without assigning anything (e.g. for an
+    // assumption that is true already)
+    void new_level()
+    {
+        trail_lims.push_back(trail_lits.size());
+    }
+
+    // Makes an unassigned literal true, at the current decision level
+    void assign(mini::Lit lit, ClauseRef reason)
+    {
+        assert(values.value(lit) == Value::undef && "The literal is assigned");
+        values.assign(lit);
+        vars[lit.var()] = VarInfo{reason, decision_level()};
+        trail_lits.push_back(lit);
+    }
+
+    // Propagates all the assignments on the trail, returns the conflicting
+    // clause (or an invalid reference)
+    ClauseRef propagate()
+    {
+        ClauseRef conflict;
+        while (qhead < trail_lits.size() && !conflict.valid()) {
+            auto p = trail_lits[qhead++];
+            ++num_propagations;
+
+            for (const auto& watch : binaries[p]) {
+                auto other = values.lit_bits(watch.other);
+                if (other == 1) {
+                    continue;
+                } else if (other == 0) {
+                    conflict = watch.ref;
+                    break;
+                }
+                assign(watch.other, watch.ref);
+            }
+            if (!conflict.valid()) {
+                conflict = propagate_long(p);
+            }
+        }
+        if (conflict.valid()) {
+            qhead = trail_lits.size();
+        }
+        return conflict;
+    }
+
+    // Unassigns everything above the level
+    void backtrack(std::uint32_t level)
+    {
+        backtrack(level, [](mini::Lit) {});
+    }
+
+    // Unassigns everything above the level, calls f(lit) for each literal
+    // in the reverse order of assignment
+    template<class F>
+    void backtrack(std::uint32_t level, F f)
+    {
+        if (decision_level() <= level) {
+            return;
+        }
+        auto keep = trail_lims[level];
+        while (trail_lits.size() > keep) {
+            auto lit = trail_lits.back();
+            trail_lits.pop_back();
+            values.unassign(lit.var());
+            f(lit);
+        }
+        trail_lims.resize(level);
+        qhead = std::min(qhead, keep);
+    }
+
+private:
+
+    void detach_binary(mini::Lit lit, ClauseRef ref)
+    {
+        auto& list = binaries[lit];
+        auto it = std::find_if(list.begin(), list.end(), [ref](const BinaryWatch& watch) {
+            return watch.ref == ref;
+        });
+        assert(it != list.end() && "The binary clause is not attached");
+        *it = list.back();
+        list.pop_back();
+    }
+
+    ClauseRef propagate_long(mini::Lit p)
+    {
+        auto false_lit = ~p;
+        auto& list = watches[p];
+        auto i = list.begin();
+        auto j = list.begin();
+        auto end = list.end();
+
+        while (i != end) {
+            auto watch = *i++;
+            if (values.is_true(watch.blocker)) {
+                *j++ = watch;
+                continue;
+            }
+
+            // freed clauses must not become reasons, their watches go now
+            auto clause = clauses[watch.ref];
+            if (clause.garbage()) {
+                continue;
+            }
+
+            // the false literal goes second
+            auto lits = clause.begin();
+            if (lits[0] == false_lit) {
+                lits[0] = lits[1];
+                lits[1] = false_lit;
+            }
+
+            auto first = lits[0];
+            Watch updated{watch.ref, first};
+            if (first != watch.blocker && values.is_true(first)) {
+                *j++ = updated;
+                continue;
+            }
+
+            // look for a new literal to watch
+            bool moved = false;
+            auto size = clause.size();
+            for (std::uint32_t k = 2; k < size; ++k) {
+                if (!values.is_false(lits[k])) {
+                    lits[1] = lits[k];
+                    lits[k] = false_lit;
+                    watches[~lits[1]].push_back(updated);
+                    moved = true;
+                    break;
+                }
+            }
+            if (moved) {
+                continue;
+            }
+
+            // unit or conflicting
+            *j++ = updated;
+            if (values.is_false(first)) {
+                while (i != end) {
+                    *j++ = *i++;
+                }
+                list.erase(j, end);
+                return watch.ref;
+            }
+            assign(first, watch.ref);
+        }
+        list.erase(j, end);
+        return ClauseRef();
+    }
+
+    template<class W>
+    void drop_freed_watches(LitMap<std::vector<W>>& lists)
+    {
+        for (std::size_t i = 0; i < lists.size(); ++i) {
+            auto& list = lists.storage()[i];
+            std::size_t kept = 0;
+            for (const auto& watch : list) {
+                if (!clauses[watch.ref].garbage()) {
+                    list[kept++] = watch;
+                }
+            }
+            list.resize(kept);
+        }
+    }
+
+}; // Propagator
+
+} // hubero
+#endif // HUBERO_PROPAGATOR_H_
@@ -0,0 +1,179 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_RECONSTRUCTION_H_
+#define HUBERO_RECONSTRUCTION_H_
+
+#include <hubero/assignment.hpp>
+#include <hubero/cnf.hpp>
+#include <hubero/core.hpp>
+#include <hubero/tools.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <vector>
+
+namespace hubero {
+
+// Clauses removed by preprocessing, which a model of the simplified
+// formula must be extended to satisfy.
+//
+// Each entry is a clause and its witness literal. extend() visits the
+// entries from the last one pushed and makes the witness true whenever the
+// clause is not satisfied, which fixes the eliminated (or blocked, or
+// substituted) variables in the reverse order of their removal:
+//
+//     stack.push(x, clause_with_x);
+//     ... solve the simplified formula ...
+//     stack.extend(model);
+//
+// To extend the models found later (e.g. of a simplified formula written
+// to a file), to_cnf() gives the entries as clauses with the witness first,
+// which the constructor reads back.
+class ReconstructionStack {
+
+    std::vector<mini::Lit> lits;        // all the clauses, one after another
+    std::vector<std::size_t> starts;    // entry i spans starts[i] .. starts[i+1]-1
+    std::vector<mini::Lit> witnesses;
+    std::uint32_t max_var;
+
+public:
+
+    ReconstructionStack() : starts(1, 0), max_var(0) {}
+
+    // The entries of to_cnf(), throws std::invalid_argument for an empty clause
+    explicit ReconstructionStack(const Cnf& entries)
+    : ReconstructionStack()
+    {
+        for (auto clause : entries) {
+            if (clause.size() == 0) {
+                throw std::invalid_argument("An entry of the reconstruction stack is empty.");
+            }
+            push(clause[0], clause);
+        }
+    }
+
+    void push(mini::Lit witness, tools::Span<const mini::Lit> clause)
+    {
+        assert(std::find(clause.begin(), clause.end(), witness) != clause.end()
+            && "The witness is a literal of the clause");
+        for (auto lit : clause) {
+            max_var = std::max(max_var, static_cast<std::uint32_t>(lit.var()));
+        }
+        lits.insert(lits.end(), clause.begin(), clause.end());
+        starts.push_back(lits.size());
+        witnesses.push_back(witness);
+    }
+
+    void push(mini::Lit witness, std::initializer_list<mini::Lit> clause)
+    {
+        push(witness, tools::Span<const mini::Lit>(clause.begin(), clause.end()));
+    }
+
+    std::size_t size() const
+    {
+        return witnesses.size();
+    }
+
+    bool empty() const
+    {
+        return witnesses.empty();
+    }
+
+    // The highest variable of all the entries (0 if none)
+    Var max_variable() const
+    {
+        return Var(max_var);
+    }
+
+    mini::Lit witness(std::size_t i) const
+    {
+        return witnesses[i];
+    }
+
+    tools::Span<const mini::Lit> clause(std::size_t i) const
+    {
+        return tools::Span<const mini::Lit>(lits.data() + starts[i], starts[i + 1] - starts[i]);
+    }
+
+    // The entries in the order of push(), each clause with its witness first
+    Cnf to_cnf() const
+    {
+        Cnf cnf;
+        cnf.set_num_vars(max_var);
+        std::vector<mini::Lit> clause;
+        for (std::size_t i = 0; i < size(); ++i) {
+            auto lits = this->clause(i);
+            clause.assign(1, witnesses[i]);
+            auto found = false;
+            for (auto lit : lits) {
+                if (lit != witnesses[i] || found) {
+                    clause.push_back(lit);
+                }
+                found = found || lit == witnesses[i];
+            }
+            cnf.add_clause(tools::Span<const mini::Lit>(clause.data(), clause.size()));
+        }
+        return cnf;
+    }
+
+    void clear()
+    {
+        lits.clear();
+        starts.assign(1, 0);
+        witnesses.clear();
+        max_var = 0;
+    }
+
+    // Extends the assignment to satisfy all the entries. Unassigned
+    // literals do not satisfy the clauses.
+    void extend(Assignment& assignment) const
+    {
+        assignment.grow_to(Var(max_var));
+        extend_by([&assignment](mini::Lit lit) {
+            return assignment.is_true(lit);
+        }, [&assignment](mini::Lit lit) {
+            assignment.assign(lit);
+        });
+    }
+
+    // Extends a model of one literal per variable (as SolverT::model()),
+    // the missing variables are added as false
+    void extend(std::vector<dimacs::Lit>& model) const
+    {
+        for (auto var = model.size() + 1; var <= max_var; ++var) {
+            model.push_back(dimacs::Lit(Var(static_cast<unsigned>(var)), false));
+        }
+        extend_by([&model](mini::Lit lit) {
+            return model[static_cast<std::size_t>(lit.var()) - 1] == dimacs::Lit(lit.var(), lit.sign());
+        }, [&model](mini::Lit lit) {
+            model[static_cast<std::size_t>(lit.var()) - 1] = dimacs::Lit(lit.var(), lit.sign());
+        });
+    }
+
+private:
+
+    template<class IsTrue, class MakeTrue>
+    void extend_by(IsTrue is_true, MakeTrue make_true) const
+    {
+        for (auto i = witnesses.size(); i-- > 0;) {
+            bool satisfied = false;
+            for (auto k = starts[i]; k < starts[i + 1] && !satisfied; ++k) {
+                satisfied = is_true(lits[k]);
+            }
+            if (!satisfied) {
+                make_true(witnesses[i]);
+            }
+        }
+    }
+
+}; // ReconstructionStack
+
+} // hubero
+#endif // HUBERO_RECONSTRUCTION_H_
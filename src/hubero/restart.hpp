@@ -0,0 +1,173 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_RESTART_H_
+#define HUBERO_RESTART_H_
+
+#include <cstdint>
+
+namespace hubero {
+
+// Restart policies of SolverT, selected by its template parameter, so
+// the solver calls them directly. Each one provides:
+//
+//     conflict(lbd)    after every conflict, with the learnt clause's LBD
+//     restart()        asked before decisions, true to restart now
+//
+// A policy answering true starts counting the next interval itself.
+
+// The i-th element (from 0) of the Luby sequence 1 1 2 1 1 2 4 1 1 2 ...
+inline std::uint64_t luby(std::uint64_t i)
+{
+    // find the finite subsequence that contains the index, and its size
+    std::uint64_t size = 1;
+    unsigned power = 0;
+    while (size < i + 1) {
+        ++power;
+        size = 2 * size + 1;
+    }
+    while (size - 1 != i) {
+        size = (size - 1) / 2;
+        --power;
+        i %= size;
+    }
+    return std::uint64_t(1) << power;
+}
+
+// Intervals of unit * luby(i) conflicts
+class LubyRestarts {
+
+    std::uint64_t unit;
+    std::uint64_t index;
+    std::uint64_t conflicts;
+
+public:
+
+    explicit LubyRestarts(std::uint64_t unit_conflicts = 100)
+    : unit(unit_conflicts), index(0), conflicts(0)
+    {}
+
+    void conflict(std::uint32_t)
+    {
+        ++conflicts;
+    }
+
+    bool restart()
+    {
+        if (conflicts < unit * luby(index)) {
+            return false;
+        }
+        ++index;
+        conflicts = 0;
+        return true;
+    }
+
+}; // LubyRestarts
+
+// Intervals growing geometrically: first, first * factor, ...
+class GeometricRestarts {
+
+    double interval;
+    double factor;
+    std::uint64_t conflicts;
+
+public:
+
+    explicit GeometricRestarts(double first = 100, double growth = 1.5)
+    : interval(first), factor(growth), conflicts(0)
+    {}
+
+    void conflict(std::uint32_t)
+    {
+        ++conflicts;
+    }
+
+    bool restart()
+    {
+        if (static_cast<double>(conflicts) < interval) {
+            return false;
+        }
+        interval *= factor;
+        conflicts = 0;
+        return true;
+    }
+
+}; // GeometricRestarts
+
+// Exponential moving average, bias-corrected for the first samples
+class Ema {
+
+    double alpha;
+    double biased;
+    double exponent; // (1 - alpha)^samples
+
+public:
+
+    explicit Ema(double smoothing)
+    : alpha(smoothing), biased(0), exponent(1)
+    {}
+
+    void update(double sample)
+    {
+        biased += alpha * (sample - biased);
+        exponent *= 1 - alpha;
+    }
+
+    double value() const
+    {
+        return exponent < 1 ? biased / (1 - exponent) : 0;
+    }
+
+}; // Ema
+
+// Glucose-style: restart when the recent LBDs (a fast moving average) get
+// worse than the long-term ones (a slow average) by the margin, i.e. the
+// search has drifted to a poor region
+class GlucoseRestarts {
+
+    Ema fast;
+    Ema slow;
+    double margin;
+    std::uint64_t min_interval;
+    std::uint64_t conflicts;
+
+public:
+
+    explicit GlucoseRestarts(double margin_factor = 1.1, std::uint64_t min_conflicts = 2,
+        double fast_alpha = 0.03, double slow_alpha = 1e-5)
+    : fast(fast_alpha), slow(slow_alpha), margin(margin_factor)
+    , min_interval(min_conflicts), conflicts(0)
+    {}
+
+    void conflict(std::uint32_t lbd)
+    {
+        fast.update(lbd);
+        slow.update(lbd);
+        ++conflicts;
+    }
+
+    bool restart()
+    {
+        if (conflicts < min_interval || fast.value() <= margin * slow.value()) {
+            return false;
+        }
+        conflicts = 0;
+        return true;
+    }
+
+    double fast_lbd() const
+    {
+        return fast.value();
+    }
+
+    double slow_lbd() const
+    {
+        return slow.value();
+    }
+
+}; // GlucoseRestarts
+
+} // hubero
+#endif // HUBERO_RESTART_H_
@@ -0,0 +1,138 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_SIMD_H_
+#define HUBERO_SIMD_H_
+
+#include <cstdint>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define HUBERO_X86 1
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #endif
+    #include <immintrin.h>
+#endif
+
+// Functions using instructions beyond the compiler's baseline are compiled
+// for the given target, and only called when the CPU supports it.
+// HUBERO_TARGET_FLATTEN also inlines all the callees into the function,
+// which is the only way to inline target-specific helpers into templates.
+#if defined(HUBERO_X86) && (defined(__GNUC__) || defined(__clang__))
+    #define HUBERO_TARGET(isa) __attribute__((target(isa)))
+    #define HUBERO_TARGET_FLATTEN(isa) __attribute__((target(isa), flatten))
+#else
+    // MSVC allows intrinsics of any ISA without flags
+    #define HUBERO_TARGET(isa)
+    #define HUBERO_TARGET_FLATTEN(isa)
+#endif
+
+namespace hubero {
+namespace simd {
+
+    enum class Isa {
+        scalar,
+        sse42,
+        avx2,
+    };
+
+    inline std::string to_string(Isa isa)
+    {
+        switch (isa) {
+            case Isa::avx2: return "avx2";
+            case Isa::sse42: return "sse4.2";
+            case Isa::scalar: return "scalar";
+        }
+        return "unknown";
+    }
+
+    // Instruction set of the CPU we are running on
+    inline Isa detect()
+    {
+#if defined(HUBERO_X86) && (defined(__GNUC__) || defined(__clang__))
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return Isa::avx2;
+        }
+        if (__builtin_cpu_supports("sse4.2")) {
+            return Isa::sse42;
+        }
+        return Isa::scalar;
+#elif defined(HUBERO_X86) && defined(_MSC_VER)
+        int regs[4];
+        __cpuid(regs, 0);
+        int max_leaf = regs[0];
+
+        __cpuid(regs, 1);
+        bool sse42 = (regs[2] & (1 << 20)) != 0;
+        bool osxsave = (regs[2] & (1 << 27)) != 0;
+        bool avx = (regs[2] & (1 << 28)) != 0;
+
+        bool avx2 = false;
+        if (max_leaf >= 7 && osxsave && avx) {
+            // the OS must save the YMM registers on context switches
+            bool ymm_enabled = (_xgetbv(0) & 0x6) == 0x6;
+            __cpuidex(regs, 7, 0);
+            avx2 = ymm_enabled && (regs[1] & (1 << 5)) != 0;
+        }
+
+        if (avx2) {
+            return Isa::avx2;
+        }
+        return sse42 ? Isa::sse42 : Isa::scalar;
+#else
+        return Isa::scalar;
+#endif
+    }
+
+    // Cached result of detect()
+    inline Isa best_isa()
+    {
+        static const Isa isa = detect();
+        return isa;
+    }
+
+    inline bool supports(Isa isa)
+    {
+        return static_cast<int>(isa) <= static_cast<int>(best_isa());
+    }
+
+
+
+    inline unsigned count_trailing_zeros(std::uint64_t x)
+    {
+        // x must not be zero
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_ctzll(x));
+#elif defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index;
+        _BitScanForward64(&index, x);
+        return static_cast<unsigned>(index);
+#else
+        unsigned n = 0;
+        while ((x & 1) == 0) {
+            x >>= 1;
+            ++n;
+        }
+        return n;
+#endif
+    }
+
+    inline unsigned popcount(std::uint64_t x)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_popcountll(x));
+#else
+        x = x - ((x >> 1) & 0x5555555555555555ull);
+        x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+        x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+        return static_cast<unsigned>((x * 0x0101010101010101ull) >> 56);
+#endif
+    }
+
+} // simd
+} // hubero
+#endif // HUBERO_SIMD_H_
@@ -0,0 +1,1174 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_SIMPLIFIER_H_
+#define HUBERO_SIMPLIFIER_H_
+
+#include <hubero/assignment.hpp>
+#include <hubero/cnf.hpp>
+#include <hubero/core.hpp>
+#include <hubero/maps.hpp>
+#include <hubero/reconstruction.hpp>
+#include <hubero/tools.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace hubero {
+
+struct SimplifierOptions {
+    // a variable is eliminated only if it has at most occurrence_limit
+    // occurrences and no clause of it is longer than clause_size_limit
+    // (pure literals always are)
+    std::size_t occurrence_limit = 100;
+    std::size_t clause_size_limit = 100;
+
+    // and if its resolvents are at most clause_growth more than the clauses
+    // they replace, none of them longer than resolvent_size_limit
+    std::size_t clause_growth = 0;
+    std::size_t resolvent_size_limit = 20;
+
+    // literals visited by resolution, all calls of eliminate() together
+    std::uint64_t step_limit = 100000000;
+};
+
+struct SimplifierStats {
+    std::uint64_t eliminated_vars = 0;
+    std::uint64_t eliminated_clauses = 0;   // replaced by resolvents
+    std::uint64_t resolvents = 0;           // non-tautological, added
+    std::uint64_t units = 0;
+    std::uint64_t satisfied_clauses = 0;    // removed by the units
+    std::uint64_t steps = 0;
+
+    // subsumption
+    std::uint64_t subsumed_clauses = 0;
+    std::uint64_t strengthened_clauses = 0; // by self-subsuming resolution
+    std::uint64_t signature_rejects = 0;    // candidates ruled out by signatures
+    std::uint64_t subsumption_checks = 0;   // candidates compared literal by literal
+
+    // equivalent literals
+    std::uint64_t substituted_vars = 0;
+    std::uint64_t equivalence_classes = 0;  // of two or more variables
+
+    // clause elimination
+    std::uint64_t blocked_clauses = 0;
+    std::uint64_t covered_clauses = 0;      // not blocked, but covered
+    std::uint64_t covered_lits = 0;         // added by covered literal addition
+
+    double seconds = 0;
+};
+
+// Min-heap of literals by the priority given when they are pushed, with
+// each literal queued at most once
+class LiteralQueue {
+
+    std::vector<std::pair<std::size_t, std::uint32_t>> heap;
+    LitMap<bool> queued;
+
+public:
+
+    template<class U, U U_MAX>
+    void grow_to(VarT<U,U_MAX> max_var)
+    {
+        queued.grow_to(max_var, false);
+    }
+
+    bool empty() const
+    {
+        return heap.empty();
+    }
+
+    void push(mini::Lit lit, std::size_t priority)
+    {
+        if (!queued[lit]) {
+            queued[lit] = true;
+            heap.emplace_back(priority, static_cast<std::uint32_t>(lit));
+            std::push_heap(heap.begin(), heap.end(), std::greater<std::pair<std::size_t, std::uint32_t>>());
+        }
+    }
+
+    mini::Lit pop()
+    {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<std::pair<std::size_t, std::uint32_t>>());
+        auto lit = mini::Lit(heap.back().second);
+        heap.pop_back();
+        queued[lit] = false;
+        return lit;
+    }
+
+}; // LiteralQueue
+
+// Preprocessor of CNF formulas, with subsumption and bounded variable
+// elimination as in SatELite.
+//
+// Subsume() removes the clauses that are supersets of others, and
+// strengthens those that are supersets but for one negated literal (by
+// self-subsuming resolution). Every clause has a 64-bit signature, the
+// bits of its literals' hashes, so most candidate pairs are ruled out by a
+// single AND.
+//
+// Substitute_equivalences() finds the literals that imply each other
+// through binary clauses, the strongly connected components of the binary
+// implication graph, and replaces each by one representative.
+//
+// Eliminate_blocked() removes the blocked clauses: those with a literal l
+// such that all the resolvents on l are tautologies. Eliminate_covered()
+// also removes the covered clauses, which become blocked (or tautologies)
+// after covered literal addition: a clause C with a literal l gets the
+// literals common to all the clauses of ~l that do not resolve with C to
+// a tautology. Both take the candidate literals l from a queue ordered by
+// the occurrences of ~l (the fewer, the likelier and cheaper), and every
+// change of the formula queues the literals it may have unblocked, so the
+// reruns only visit those.
+//
+// A variable is eliminated by replacing all its clauses by their
+// resolvents on it, as long as that does not grow the formula (see
+// SimplifierOptions). Variables are tried in the order of the products of
+// their literals' occurrences, and those touched by an elimination are
+// tried again in the next round. Clauses are found through occurrence
+// lists of mini::Lit (which drop removed clauses lazily), units are
+// propagated as they appear.
+//
+// The removed clauses go to a ReconstructionStack, which extends the
+// models of the simplified formula to the original one:
+//
+//     Simplifier simplifier(cnf);
+//     simplifier.eliminate();
+//     Solver solver;
+//     solver.add_cnf(simplifier.formula());
+//     if (solver.solve() == Result::sat) {
+//         auto model = solver.model();
+//         simplifier.extend(model);
+//     }
+//
+// Variables of assumptions (or of clauses added later) must be frozen.
+class Simplifier {
+
+    struct ClauseInfo {
+        std::size_t start;      // in lits
+        std::uint32_t size;
+        bool removed;
+        std::uint64_t signature;
+    };
+
+    std::vector<mini::Lit> lits;
+    std::vector<ClauseInfo> clauses;
+    std::size_t live_clauses;
+    std::size_t dead_lits;
+    LitMap<std::vector<std::uint32_t>> occurs;  // may list removed clauses
+
+    Assignment values;
+    std::vector<mini::Lit> units;               // in the order of assignment
+    std::size_t units_head;
+    bool conflicting;
+
+    VarMap<bool> frozen;
+    VarMap<bool> eliminated;
+    VarMap<bool> touched_vars;
+    std::vector<Var> touched;
+    std::uint64_t declared_vars;
+
+    ReconstructionStack stack;
+    SimplifierOptions opts;
+    SimplifierStats counters;
+
+    // literals to try as blocking (by the occurrences of their negations),
+    // one queue for eliminate_blocked() and one for eliminate_covered()
+    LiteralQueue blocking_queue;
+    LiteralQueue covering_queue;
+    bool blocking_seeded;
+    bool covering_seeded;
+
+    LitMap<std::uint8_t> marks;
+    std::vector<mini::Lit> buffer;
+    std::vector<std::uint32_t> pos_ids;
+    std::vector<std::uint32_t> neg_ids;
+    std::vector<mini::Lit> resolvent_lits;
+    std::vector<std::size_t> resolvent_starts;
+    std::vector<mini::Lit> covered_lits;
+    std::vector<std::pair<mini::Lit, std::size_t>> covering;   // l_i and |C_i|
+
+public:
+
+    explicit Simplifier(SimplifierOptions options = SimplifierOptions())
+    : live_clauses(0), dead_lits(0), units_head(0), conflicting(false)
+    , declared_vars(0), opts(options), blocking_seeded(false), covering_seeded(false)
+    {
+        grow_to(Var(0));
+    }
+
+    template<class L>
+    explicit Simplifier(const CnfT<L>& cnf, SimplifierOptions options = SimplifierOptions())
+    : Simplifier(options)
+    {
+        add_cnf(cnf);
+    }
+
+    template<class U, U U_MAX>
+    void grow_to(VarT<U,U_MAX> max_var)
+    {
+        occurs.grow_to(max_var);
+        values.grow_to(max_var);
+        frozen.grow_to(max_var, false);
+        eliminated.grow_to(max_var, false);
+        touched_vars.grow_to(max_var, false);
+        blocking_queue.grow_to(max_var);
+        covering_queue.grow_to(max_var);
+        marks.grow_to(max_var, 0);
+        declared_vars = std::max<std::uint64_t>(declared_vars, static_cast<std::uint64_t>(max_var));
+    }
+
+    // The highest variable
+    std::uint64_t num_vars() const
+    {
+        return declared_vars;
+    }
+
+    // Adds a clause, returns false if the formula is now unsatisfiable
+    bool add_clause(tools::Span<const mini::Lit> clause)
+    {
+        if (conflicting) {
+            return false;
+        }
+        buffer.assign(clause.begin(), clause.end());
+        for (auto lit : buffer) {
+            grow_to(lit.var());
+            if (eliminated[lit.var()]) {
+                throw std::invalid_argument("Variable " + lit.var().to_string()
+                    + " is eliminated, freeze it before simplifying.");
+            }
+        }
+
+        // sort, drop duplicates and false literals, skip satisfied clauses
+        std::sort(buffer.begin(), buffer.end());
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < buffer.size(); ++i) {
+            auto lit = buffer[i];
+            if (values.is_true(lit) || (kept > 0 && buffer[kept - 1] == ~lit)) {
+                return true;
+            }
+            if (!values.is_false(lit) && (kept == 0 || buffer[kept - 1] != lit)) {
+                buffer[kept++] = lit;
+            }
+        }
+        buffer.resize(kept);
+
+        if (buffer.empty()) {
+            conflicting = true;
+        } else if (buffer.size() == 1) {
+            assign(buffer[0]);
+        } else {
+            store(buffer);
+        }
+        return !conflicting;
+    }
+
+    bool add_clause(std::initializer_list<mini::Lit> clause)
+    {
+        return add_clause(tools::Span<const mini::Lit>(clause.begin(), clause.end()));
+    }
+
+    template<class L>
+    bool add_cnf(const CnfT<L>& cnf)
+    {
+        if (cnf.num_vars() > 0) {
+            grow_to(Var(static_cast<unsigned>(cnf.num_vars())));
+        }
+        std::vector<mini::Lit> clause;
+        for (auto lits : cnf) {
+            clause.clear();
+            for (auto lit : lits) {
+                clause.push_back(mini::Lit(lit.var(), lit.sign()));
+            }
+            if (!add_clause(tools::Span<const mini::Lit>(clause.data(), clause.size()))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // The variable is never eliminated (e.g. it is assumed later)
+    template<class U, U U_MAX>
+    void freeze(VarT<U,U_MAX> var)
+    {
+        grow_to(var);
+        frozen[var] = true;
+    }
+
+    template<class U, U U_MAX>
+    bool is_eliminated(VarT<U,U_MAX> var) const
+    {
+        return eliminated.contains(var) && eliminated[var];
+    }
+
+    // Removes the subsumed clauses and strengthens the others by
+    // self-subsuming resolution, returns false if the formula turns out to
+    // be unsatisfiable.
+    //
+    // The clauses are visited from the shortest, each one is checked
+    // against the shorter ones, which are watched by one literal (the one
+    // of fewest occurrences). A clause D subsumes (or strengthens) a clause
+    // C only if the watched literal of D (or its negation) is in C, so the
+    // watches of C's literals and their negations are all it is checked
+    // against.
+    bool subsume()
+    {
+        auto start = std::chrono::steady_clock::now();
+        if (propagate()) {
+            std::vector<std::uint32_t> order;
+            order.reserve(live_clauses);
+            for (std::uint32_t id = 0; id < clauses.size(); ++id) {
+                if (!clauses[id].removed) {
+                    order.push_back(id);
+                }
+            }
+            std::stable_sort(order.begin(), order.end(), [this](std::uint32_t lhs, std::uint32_t rhs) {
+                return clauses[lhs].size < clauses[rhs].size;
+            });
+
+            LitMap<std::vector<std::uint32_t>> watches;
+            watches.grow_to(Var(static_cast<unsigned>(eliminated.size() - 1)));
+            for (auto id : order) {
+                if (subsumed(id, watches)) {
+                    remove(id);
+                    ++counters.subsumed_clauses;
+                } else if (!clauses[id].removed) {
+                    auto clause = clause_lits(id);
+                    auto rarest = *std::min_element(clause.begin(), clause.end(),
+                        [this](mini::Lit lhs, mini::Lit rhs) {
+                            return occurs[lhs].size() < occurs[rhs].size();
+                        });
+                    watches[rarest].push_back(id);
+                }
+            }
+            propagate();
+        }
+        counters.seconds += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        return !conflicting;
+    }
+
+    // Replaces the equivalent literals by their representatives, returns
+    // false if the formula turns out to be unsatisfiable (a literal is
+    // equivalent to its negation).
+    //
+    // The binary implication graph is not built: the successors of a
+    // literal l are the other literals of the binary clauses of ~l, read
+    // from the occurrence lists. Its components are found by Tarjan's
+    // algorithm with an explicit stack, so long chains of equivalences
+    // cannot overflow the call stack. The representative of a component is
+    // its lowest frozen variable, or the lowest one.
+    bool substitute_equivalences()
+    {
+        auto start = std::chrono::steady_clock::now();
+        if (propagate()) {
+            auto max_var = Var(static_cast<unsigned>(eliminated.size() - 1));
+            LitMap<mini::Lit> repr(max_var);
+            for (std::size_t v = 0; v < eliminated.size(); ++v) {
+                mini::Lit positive(Var(static_cast<unsigned>(v)), true);
+                repr[positive] = positive;
+                repr[~positive] = ~positive;
+            }
+            if (find_equivalences(repr)) {
+                substitute(repr);
+                propagate();
+            }
+        }
+        counters.seconds += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        return !conflicting;
+    }
+
+    // Removes the blocked clauses (with a non-frozen blocking literal),
+    // returns false if the formula turns out to be unsatisfiable
+    bool eliminate_blocked()
+    {
+        return eliminate_clauses(false);
+    }
+
+    // Removes the blocked and the covered clauses, returns false if the
+    // formula turns out to be unsatisfiable
+    bool eliminate_covered()
+    {
+        return eliminate_clauses(true);
+    }
+
+    // Bounded variable elimination, returns false if the formula turns out
+    // to be unsatisfiable
+    bool eliminate()
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<Var> candidates;
+        if (propagate()) {
+            for (std::size_t v = 1; v < eliminated.size(); ++v) {
+                candidates.push_back(Var(static_cast<unsigned>(v)));
+            }
+        }
+
+        while (!candidates.empty() && !conflicting && counters.steps < opts.step_limit) {
+            for (auto var : candidates) {
+                touched_vars[var] = false;
+            }
+            touched.clear();
+            candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [this](Var var) {
+                return frozen[var] || eliminated[var] || values.is_assigned(var);
+            }), candidates.end());
+            VarMap<std::uint64_t> costs(Var(static_cast<unsigned>(eliminated.size() - 1)), 0);
+            for (auto var : candidates) {
+                mini::Lit positive(var, true);
+                costs[var] = static_cast<std::uint64_t>(occurrences(positive).size())
+                    * occurrences(~positive).size();
+            }
+            std::stable_sort(candidates.begin(), candidates.end(), [&costs](Var lhs, Var rhs) {
+                return costs[lhs] < costs[rhs];
+            });
+
+            for (auto var : candidates) {
+                if (counters.steps >= opts.step_limit) {
+                    break;
+                }
+                if (!eliminated[var] && !values.is_assigned(var) && try_eliminate(var)
+                    && !propagate()) {
+                    break;
+                }
+            }
+            candidates.swap(touched);
+        }
+
+        if (dead_lits > lits.size() / 2) {
+            compact();
+        }
+        counters.seconds += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        return !conflicting;
+    }
+
+    bool inconsistent() const
+    {
+        return conflicting;
+    }
+
+    std::size_t num_clauses() const
+    {
+        return live_clauses;
+    }
+
+    // The simplified formula: the units, then the other clauses. The
+    // variables keep their numbers, the eliminated ones do not occur.
+    Cnf formula() const
+    {
+        Cnf cnf;
+        cnf.set_num_vars(declared_vars);
+        if (conflicting) {
+            cnf.add_clause(tools::Span<const mini::Lit>());
+            return cnf;
+        }
+        for (auto lit : units) {
+            cnf.add_clause(tools::Span<const mini::Lit>(&lit, 1));
+        }
+        for (const auto& info : clauses) {
+            if (!info.removed) {
+                cnf.add_clause(tools::Span<const mini::Lit>(lits.data() + info.start, info.size));
+            }
+        }
+        return cnf;
+    }
+
+    const ReconstructionStack& reconstruction() const
+    {
+        return stack;
+    }
+
+    // Extends a model of the simplified formula (see SolverT::model()) to
+    // the original one
+    void extend(std::vector<dimacs::Lit>& model) const
+    {
+        stack.extend(model);
+    }
+
+    void extend(Assignment& assignment) const
+    {
+        stack.extend(assignment);
+    }
+
+    SimplifierOptions& options()
+    {
+        return opts;
+    }
+
+    const SimplifierStats& stats() const
+    {
+        return counters;
+    }
+
+private:
+
+    tools::Span<mini::Lit> clause_lits(std::uint32_t id)
+    {
+        return tools::Span<mini::Lit>(lits.data() + clauses[id].start, clauses[id].size);
+    }
+
+    tools::Span<const mini::Lit> clause_lits(std::uint32_t id) const
+    {
+        return tools::Span<const mini::Lit>(lits.data() + clauses[id].start, clauses[id].size);
+    }
+
+    void touch(Var var)
+    {
+        if (!touched_vars[var]) {
+            touched_vars[var] = true;
+            touched.push_back(var);
+        }
+    }
+
+    void store(const std::vector<mini::Lit>& clause)
+    {
+        auto id = static_cast<std::uint32_t>(clauses.size());
+        clauses.push_back(ClauseInfo{lits.size(), static_cast<std::uint32_t>(clause.size()), false,
+            signature(tools::Span<const mini::Lit>(clause.data(), clause.size()))});
+        lits.insert(lits.end(), clause.begin(), clause.end());
+        ++live_clauses;
+        for (auto lit : clause) {
+            occurs[lit].push_back(id);
+            touch(Var(lit.var()));
+            enqueue(lit);
+        }
+    }
+
+    void remove(std::uint32_t id)
+    {
+        assert(!clauses[id].removed && "The clause is removed twice");
+        clauses[id].removed = true;
+        --live_clauses;
+        dead_lits += clauses[id].size;
+        for (auto lit : clause_lits(id)) {
+            touch(Var(lit.var()));
+            enqueue(~lit);
+        }
+    }
+
+    // The clauses of the literal may have become blocked on it
+    void enqueue(mini::Lit lit)
+    {
+        blocking_queue.push(lit, occurs[~lit].size());
+        covering_queue.push(lit, occurs[~lit].size());
+    }
+
+    // The live clauses of the literal
+    std::vector<std::uint32_t>& occurrences(mini::Lit lit)
+    {
+        auto& list = occurs[lit];
+        list.erase(std::remove_if(list.begin(), list.end(), [this](std::uint32_t id) {
+            return clauses[id].removed;
+        }), list.end());
+        return list;
+    }
+
+    void assign(mini::Lit lit)
+    {
+        if (values.is_false(lit)) {
+            conflicting = true;
+        } else if (!values.is_true(lit)) {
+            values.assign(lit);
+            units.push_back(lit);
+            ++counters.units;
+        }
+    }
+
+    // Removes the satisfied clauses and the false literals of the new
+    // units, returns false on a conflict
+    bool propagate()
+    {
+        while (units_head < units.size() && !conflicting) {
+            auto lit = units[units_head++];
+            for (auto id : occurrences(lit)) {
+                remove(id);
+                ++counters.satisfied_clauses;
+            }
+            occurs[lit].clear();
+
+            for (auto id : occurrences(~lit)) {
+                shorten(id, ~lit);
+            }
+            occurs[~lit].clear();
+        }
+        return !conflicting;
+    }
+
+    // The other literal of the binary clause, or mini::Lit() if it is not
+    // a live binary clause
+    mini::Lit binary_partner(std::uint32_t id, mini::Lit lit)
+    {
+        if (clauses[id].removed || clauses[id].size != 2) {
+            return mini::Lit();
+        }
+        auto clause = clause_lits(id);
+        return clause[0] == lit ? clause[1] : clause[0];
+    }
+
+    // Tarjan's algorithm over the binary implication graph, sets the
+    // representatives of the components, returns whether there are any
+    // (and false on a conflict)
+    bool find_equivalences(LitMap<mini::Lit>& repr)
+    {
+        const std::uint32_t unvisited = 0xFFFFFFFFu;
+        const std::uint32_t finished = 0xFFFFFFFEu; // lowlink of literals in a component
+        auto max_var = Var(static_cast<unsigned>(eliminated.size() - 1));
+        LitMap<std::uint32_t> order(max_var, unvisited);
+        LitMap<std::uint32_t> low(max_var, unvisited);
+
+        struct Frame {
+            mini::Lit lit;
+            std::size_t next;   // in the occurrences of ~lit
+        };
+        std::vector<Frame> frames;
+        std::vector<mini::Lit> component_stack;
+        std::vector<mini::Lit> component;
+        std::uint32_t counter = 0;
+        bool found = false;
+
+        for (std::size_t root_index = 2; root_index < order.size() && !conflicting; ++root_index) {
+            auto root = mini::Lit(static_cast<std::uint32_t>(root_index));
+            if (order[root] != unvisited || eliminated[root.var()] || values.is_assigned(root.var())) {
+                continue;
+            }
+            order[root] = low[root] = counter++;
+            component_stack.push_back(root);
+            frames.push_back(Frame{root, 0});
+
+            while (!frames.empty()) {
+                auto lit = frames.back().lit;
+                const auto& list = occurs[~lit];
+                if (frames.back().next < list.size()) {
+                    auto next = binary_partner(list[frames.back().next++], ~lit);
+                    if (next == mini::Lit()) {
+                        continue;
+                    } else if (order[next] == unvisited) {
+                        order[next] = low[next] = counter++;
+                        component_stack.push_back(next);
+                        frames.push_back(Frame{next, 0});
+                    } else if (low[next] != finished) {
+                        low[lit] = std::min(low[lit], order[next]);
+                    }
+                    continue;
+                }
+
+                frames.pop_back();
+                if (!frames.empty()) {
+                    auto parent = frames.back().lit;
+                    low[parent] = std::min(low[parent], low[lit]);
+                }
+                if (low[lit] != order[lit]) {
+                    continue;
+                }
+                component.clear();
+                mini::Lit member;
+                do {
+                    member = component_stack.back();
+                    component_stack.pop_back();
+                    low[member] = finished;
+                    component.push_back(member);
+                } while (member != lit);
+                if (component.size() > 1 && represent(component, repr)) {
+                    found = true;
+                }
+            }
+        }
+        return found && !conflicting;
+    }
+
+    // Picks the representative of the component, unless its mirror (of the
+    // negated literals) already has one; a literal together with its
+    // negation is a conflict
+    bool represent(const std::vector<mini::Lit>& component, LitMap<mini::Lit>& repr)
+    {
+        if (repr[component[0]] != component[0] || repr[component[1]] != component[1]) {
+            return false;
+        }
+        for (auto lit : component) {
+            marks[lit] = 1;
+        }
+        auto best = component[0];
+        for (auto lit : component) {
+            if (marks[~lit]) {
+                conflicting = true;
+            }
+            auto var = lit.var();
+            if (frozen[var] != frozen[best.var()] ? frozen[var] : lit < best) {
+                best = lit;
+            }
+        }
+        for (auto lit : component) {
+            marks[lit] = 0;
+        }
+        for (auto lit : component) {
+            repr[lit] = best;
+            repr[~lit] = ~best;
+        }
+        ++counters.equivalence_classes;
+        return !conflicting;
+    }
+
+    // Replaces the literals by their representatives in all the clauses,
+    // the equivalences go to the reconstruction stack
+    void substitute(const LitMap<mini::Lit>& repr)
+    {
+        std::vector<std::uint32_t> affected;
+        for (std::size_t v = 1; v < eliminated.size(); ++v) {
+            Var var(static_cast<unsigned>(v));
+            mini::Lit positive(var, true);
+            auto target = repr[positive];
+            if (target == positive || frozen[var]) {
+                continue;
+            }
+            stack.push(positive, {positive, ~target});
+            stack.push(~positive, {~positive, target});
+            for (auto lit : {positive, ~positive}) {
+                const auto& list = occurrences(lit);
+                affected.insert(affected.end(), list.begin(), list.end());
+                occurs[lit].clear();
+            }
+            eliminated[var] = true;
+            ++counters.substituted_vars;
+        }
+        std::sort(affected.begin(), affected.end());
+        affected.erase(std::unique(affected.begin(), affected.end()), affected.end());
+
+        std::vector<mini::Lit> mapped;
+        for (auto id : affected) {
+            mapped.clear();
+            for (auto lit : clause_lits(id)) {
+                mapped.push_back(frozen[lit.var()] ? lit : repr[lit]);
+            }
+            remove(id);
+            if (!add_clause(tools::Span<const mini::Lit>(mapped.data(), mapped.size()))) {
+                return;
+            }
+        }
+    }
+
+    // Removes the literal from the clause (but not from its occurrences),
+    // a unit is assigned instead
+    void shorten(std::uint32_t id, mini::Lit lit)
+    {
+        auto clause = clause_lits(id);
+        auto end = std::remove(clause.begin(), clause.end(), lit);
+        clauses[id].size = static_cast<std::uint32_t>(end - clause.begin());
+        clauses[id].signature = signature(clause_lits(id));
+        ++dead_lits;
+        touch(Var(lit.var()));
+        enqueue(~lit);
+        if (clauses[id].size == 1) {
+            auto unit = clause[0];
+            remove(id);
+            assign(unit);
+        }
+    }
+
+    static std::uint64_t lit_bit(mini::Lit lit)
+    {
+        auto hash = static_cast<std::uint32_t>(lit) * 0x9E3779B1u;
+        return std::uint64_t(1) << (hash >> 26);
+    }
+
+    static std::uint64_t signature(tools::Span<const mini::Lit> clause)
+    {
+        std::uint64_t bits = 0;
+        for (auto lit : clause) {
+            bits |= lit_bit(lit);
+        }
+        return bits;
+    }
+
+    // Whether a watched clause subsumes the clause, strengthens it by the
+    // watched clauses that subsume it but for one negated literal
+    bool subsumed(std::uint32_t id, const LitMap<std::vector<std::uint32_t>>& watches)
+    {
+        for (auto lit : clause_lits(id)) {
+            marks[lit] = 1;
+        }
+        bool result = false;
+        bool changed = true;
+        while (changed && !result && !clauses[id].removed) {
+            changed = false;
+            for (std::uint32_t i = 0; i < clauses[id].size && !changed && !result; ++i) {
+                auto lit = clause_lits(id)[i];
+                for (auto watched : {lit, ~lit}) {
+                    for (auto other : watches[watched]) {
+                        mini::Lit flipped;
+                        if (!subsumes(other, id, watched, flipped)) {
+                            continue;
+                        } else if (flipped == mini::Lit()) {
+                            result = true;
+                            break;
+                        }
+                        // the resolvent on the flipped literal is id without ~flipped
+                        marks[~flipped] = 0;
+                        occurs[~flipped].erase(std::find(
+                            occurs[~flipped].begin(), occurs[~flipped].end(), id));
+                        shorten(id, ~flipped);
+                        ++counters.strengthened_clauses;
+                        changed = true;
+                        break;
+                    }
+                    if (changed || result) {
+                        break;
+                    }
+                }
+            }
+        }
+        for (auto lit : clause_lits(id)) {
+            marks[lit] = 0;
+        }
+        return result;
+    }
+
+    // Whether the clause other (watched by the literal) is a subset of the
+    // marked clause id, or of id with one literal negated (flipped gets the
+    // literal of other then)
+    bool subsumes(std::uint32_t other, std::uint32_t id, mini::Lit watched, mini::Lit& flipped)
+    {
+        const auto& info = clauses[other];
+        if (info.size > clauses[id].size) {
+            return false;
+        }
+        // literals of other missing in id: none, or just the flipped one
+        // (the watched literal if it is not in id, one bit of any if it is)
+        auto missing = info.signature & ~clauses[id].signature;
+        if (!marks[watched]) {
+            missing &= ~lit_bit(watched);
+        } else {
+            missing &= missing - 1;
+        }
+        if (missing != 0) {
+            ++counters.signature_rejects;
+            return false;
+        }
+
+        ++counters.subsumption_checks;
+        counters.steps += info.size;
+        flipped = mini::Lit();
+        for (auto lit : clause_lits(other)) {
+            if (marks[lit]) {
+                continue;
+            } else if (flipped == mini::Lit() && marks[~lit]) {
+                flipped = lit;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool eliminate_clauses(bool covered)
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto& queue = covered ? covering_queue : blocking_queue;
+        auto& seeded = covered ? covering_seeded : blocking_seeded;
+        if (!seeded) {
+            seeded = true;
+            for (std::size_t code = 2; code < occurs.size(); ++code) {
+                mini::Lit lit(static_cast<std::uint32_t>(code));
+                queue.push(lit, occurs[~lit].size());
+            }
+        }
+
+        std::vector<std::uint32_t> ids;
+        while (propagate() && !queue.empty() && counters.steps < opts.step_limit) {
+            auto lit = queue.pop();
+            auto var = lit.var();
+            if (frozen[var] || eliminated[var] || values.is_assigned(var)) {
+                continue;
+            }
+
+            ids = occurrences(lit);
+            for (auto id : ids) {
+                if (clauses[id].removed) {
+                    continue;
+                }
+                if (blocked(id, lit)) {
+                    stack.push(lit, clause_lits(id));
+                    remove(id);
+                    ++counters.blocked_clauses;
+                } else if (covered && cover(id, lit)) {
+                    remove(id);
+                    ++counters.covered_clauses;
+                }
+            }
+        }
+
+        counters.seconds += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        return !conflicting;
+    }
+
+    // Whether all the resolvents of the clause on the literal are
+    // tautologies
+    bool blocked(std::uint32_t id, mini::Lit lit)
+    {
+        for (auto other : clause_lits(id)) {
+            marks[other] = 1;
+        }
+        bool result = true;
+        for (auto other : occurrences(~lit)) {
+            counters.steps += clauses[other].size;
+            if (!resolves_to_tautology(other, ~lit)) {
+                result = false;
+                break;
+            }
+        }
+        for (auto other : clause_lits(id)) {
+            marks[other] = 0;
+        }
+        return result;
+    }
+
+    // Whether the clause has the negation of a marked literal besides the
+    // pivot
+    bool resolves_to_tautology(std::uint32_t id, mini::Lit pivot) const
+    {
+        for (auto lit : clause_lits(id)) {
+            if (lit != pivot && (marks[~lit] & 1)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Extends the clause C_0 by covered literal addition, C_i+1 being C_i
+    // and the literals common to the clauses of ~l_i that do not resolve with
+    // C_i to a tautology. If some C_n is blocked on l_n, the clause is
+    // covered: (l_i, C_i) go to the reconstruction stack, and
+    // extending a model of the rest flips l_n, ..., l_0 as needed.
+    bool cover(std::uint32_t id, mini::Lit first)
+    {
+        covered_lits.assign(clause_lits(id).begin(), clause_lits(id).end());
+        covering.clear();
+        for (auto lit : covered_lits) {
+            marks[lit] = 1;
+        }
+        std::iter_swap(covered_lits.begin(), std::find(covered_lits.begin(), covered_lits.end(), first));
+
+        bool result = false;
+        bool changed = true;
+        while (changed && !result && covered_lits.size() <= opts.clause_size_limit) {
+            changed = false;
+            for (std::size_t i = 0; i < covered_lits.size() && !changed && !result; ++i) {
+                auto lit = covered_lits[i];
+                if (frozen[lit.var()]) {
+                    continue;
+                }
+                auto size = covered_lits.size();
+                bool any = false;
+                for (auto other : occurrences(~lit)) {
+                    counters.steps += clauses[other].size;
+                    if (resolves_to_tautology(other, ~lit)) {
+                        continue;
+                    }
+                    intersect(other, ~lit, size, any);
+                    any = true;
+                    if (covered_lits.size() == size) {
+                        break;
+                    }
+                }
+                if (!any) {
+                    // C_n is blocked on the literal
+                    covering.emplace_back(lit, covered_lits.size());
+                    result = true;
+                } else if (covered_lits.size() > size) {
+                    covering.emplace_back(lit, size);
+                    counters.covered_lits += covered_lits.size() - size;
+                    for (auto k = size; k < covered_lits.size(); ++k) {
+                        marks[covered_lits[k]] = 1;
+                    }
+                    changed = true;
+                }
+            }
+        }
+        for (auto lit : covered_lits) {
+            marks[lit] = 0;
+        }
+        if (result) {
+            for (const auto& step : covering) {
+                stack.push(step.first, tools::Span<const mini::Lit>(covered_lits.data(), step.second));
+            }
+        }
+        return result;
+    }
+
+    // Keeps the literals added to the covered clause (from size on) that
+    // are in the clause id too, or adds those of id but the pivot if none
+    // were added yet
+    void intersect(std::uint32_t id, mini::Lit pivot, std::size_t size, bool any)
+    {
+        if (!any) {
+            for (auto lit : clause_lits(id)) {
+                if (lit != pivot && !(marks[lit] & 1)) {
+                    covered_lits.push_back(lit);
+                }
+            }
+            return;
+        }
+        for (auto lit : clause_lits(id)) {
+            marks[lit] |= 2;
+        }
+        covered_lits.erase(std::remove_if(covered_lits.begin() + static_cast<std::ptrdiff_t>(size),
+            covered_lits.end(), [this](mini::Lit lit) {
+                return !(marks[lit] & 2);
+            }), covered_lits.end());
+        for (auto lit : clause_lits(id)) {
+            marks[lit] &= 1;
+        }
+    }
+
+    // Eliminates the variable if the bounds allow, returns whether it did
+    bool try_eliminate(Var var)
+    {
+        mini::Lit positive(var, true);
+        pos_ids = occurrences(positive);
+        neg_ids = occurrences(~positive);
+        if (pos_ids.empty() && neg_ids.empty()) {
+            return false;
+        }
+
+        if (!pos_ids.empty() && !neg_ids.empty()) {
+            if (pos_ids.size() + neg_ids.size() > opts.occurrence_limit) {
+                return false;
+            }
+            for (auto ids : {&pos_ids, &neg_ids}) {
+                for (auto id : *ids) {
+                    if (clauses[id].size > opts.clause_size_limit) {
+                        return false;
+                    }
+                }
+            }
+            if (!resolve(positive)) {
+                return false;
+            }
+        } else {
+            resolvent_starts.assign(1, 0);
+            resolvent_lits.clear();
+        }
+
+        // the smaller side with its literal as the witness, then the
+        // other literal as a default for the larger side
+        auto smaller = pos_ids.size() <= neg_ids.size() ? positive : ~positive;
+        for (auto id : smaller == positive ? pos_ids : neg_ids) {
+            stack.push(smaller, clause_lits(id));
+        }
+        stack.push(~smaller, {~smaller});
+
+        for (auto ids : {&pos_ids, &neg_ids}) {
+            for (auto id : *ids) {
+                remove(id);
+            }
+            counters.eliminated_clauses += ids->size();
+        }
+        occurs[positive].clear();
+        occurs[~positive].clear();
+        eliminated[var] = true;
+        ++counters.eliminated_vars;
+
+        for (std::size_t i = 0; i + 1 < resolvent_starts.size() && !conflicting; ++i) {
+            add_clause(tools::Span<const mini::Lit>(resolvent_lits.data() + resolvent_starts[i],
+                resolvent_starts[i + 1] - resolvent_starts[i]));
+            ++counters.resolvents;
+        }
+        return true;
+    }
+
+    // Collects the non-tautological resolvents of the clauses of pos_ids
+    // and neg_ids on the literal, returns false if they exceed the bounds
+    bool resolve(mini::Lit pivot)
+    {
+        resolvent_starts.assign(1, 0);
+        resolvent_lits.clear();
+        auto limit = pos_ids.size() + neg_ids.size() + opts.clause_growth;
+        bool within = true;
+
+        for (auto pos : pos_ids) {
+            auto outer = clause_lits(pos);
+            for (auto lit : outer) {
+                marks[lit] = 1;
+            }
+            for (std::size_t k = 0; k < neg_ids.size() && within; ++k) {
+                auto inner = clause_lits(neg_ids[k]);
+                counters.steps += outer.size() + inner.size();
+
+                auto start = resolvent_lits.size();
+                bool tautology = false;
+                for (auto lit : outer) {
+                    if (lit != pivot) {
+                        resolvent_lits.push_back(lit);
+                    }
+                }
+                for (auto lit : inner) {
+                    if (lit == ~pivot || marks[lit]) {
+                        continue;
+                    } else if (marks[~lit]) {
+                        tautology = true;
+                        break;
+                    }
+                    resolvent_lits.push_back(lit);
+                }
+
+                if (tautology) {
+                    resolvent_lits.resize(start);
+                } else if (resolvent_lits.size() - start > opts.resolvent_size_limit
+                    || resolvent_starts.size() > limit) {
+                    within = false;
+                } else {
+                    resolvent_starts.push_back(resolvent_lits.size());
+                }
+            }
+            for (auto lit : outer) {
+                marks[lit] = 0;
+            }
+            if (!within) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Drops the removed clauses and the literals cut off by strengthening
+    void compact()
+    {
+        std::vector<mini::Lit> kept_lits;
+        std::vector<ClauseInfo> kept;
+        kept_lits.reserve(lits.size() - dead_lits);
+        kept.reserve(live_clauses);
+        for (auto& list : occurs.storage()) {
+            list.clear();
+        }
+        for (std::uint32_t id = 0; id < clauses.size(); ++id) {
+            if (clauses[id].removed) {
+                continue;
+            }
+            auto clause = clause_lits(id);
+            auto new_id = static_cast<std::uint32_t>(kept.size());
+            kept.push_back(ClauseInfo{kept_lits.size(), clauses[id].size, false, clauses[id].signature});
+            kept_lits.insert(kept_lits.end(), clause.begin(), clause.end());
+            for (auto lit : clause) {
+                occurs[lit].push_back(new_id);
+            }
+        }
+        lits.swap(kept_lits);
+        clauses.swap(kept);
+        dead_lits = 0;
+    }
+
+}; // Simplifier
+
+} // hubero
+#endif // HUBERO_SIMPLIFIER_H_
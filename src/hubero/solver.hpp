@@ -0,0 +1,1467 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_SOLVER_H_
+#define HUBERO_SOLVER_H_
+
+#include <hubero/assignment.hpp>
+#include <hubero/clause_arena.hpp>
+#include <hubero/cnf.hpp>
+#include <hubero/core.hpp>
+#include <hubero/decision.hpp>
+#include <hubero/gauss.hpp>
+#include <hubero/maps.hpp>
+#include <hubero/prober.hpp>
+#include <hubero/propagator.hpp>
+#include <hubero/restart.hpp>
+#include <hubero/tools.hpp>
+#include <hubero/vivifier.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace hubero {
+
+enum class Result : std::uint8_t {
+    unknown,
+    sat,
+    unsat,
+};
+
+// The answer as in the "s" line of the SAT competition output
+inline const char* to_string(Result result)
+{
+    switch (result) {
+        case Result::sat: return "SATISFIABLE";
+        case Result::unsat: return "UNSATISFIABLE";
+        default: return "UNKNOWN";
+    }
+}
+
+struct SolverStats {
+    std::uint64_t decisions = 0;
+    std::uint64_t conflicts = 0;
+    std::uint64_t propagations = 0;
+    std::uint64_t learnt_lits = 0;      // after minimization
+    std::uint64_t minimized_lits = 0;   // removed by minimization
+
+    // clause database
+    std::uint64_t learnt_clauses = 0;   // currently kept
+    std::uint64_t reductions = 0;
+    std::uint64_t deleted_clauses = 0;
+    std::uint64_t collections = 0;      // arena compactions
+    std::uint64_t reclaimed_bytes = 0;
+    std::uint64_t arena_bytes = 0;      // currently allocated
+
+    std::uint64_t restarts = 0;
+    std::uint64_t rephases = 0;
+
+    // incremental solving
+    std::uint64_t solves = 0;
+    std::uint64_t simplified_clauses = 0; // satisfied at level 0, removed
+    std::uint64_t imported_clauses = 0;
+
+    // probing at level 0, see Prober
+    std::uint64_t probes = 0;
+    std::uint64_t failed_literals = 0;
+    std::uint64_t hyper_binaries = 0;
+
+    // vivification at level 0, see Vivifier
+    std::uint64_t vivified_clauses = 0; // shortened
+    std::uint64_t vivified_lits = 0;    // removed from them
+    double vivify_seconds = 0;
+
+    // Gaussian elimination, see GaussMatrix
+    std::uint64_t xors = 0;             // recovered from the clauses
+    std::uint64_t xor_matrices = 0;
+    std::uint64_t gauss_eliminations = 0;
+    std::uint64_t gauss_propagations = 0;
+    std::uint64_t gauss_conflicts = 0;
+};
+
+// One clause database reduction, with the propagation speed of the
+// interval before it (since the previous reduction or the start of solve())
+struct ReductionRecord {
+    std::uint64_t conflicts;
+    std::uint64_t kept;             // learnt clauses after the reduction
+    std::uint64_t deleted;
+    std::uint64_t reclaimed_bytes;  // 0 unless the arena got compacted
+    double propagations_per_second;
+};
+
+// One restart, recorded if SolverOptions::trace_restarts is set
+struct RestartRecord {
+    std::uint64_t conflicts;
+    std::uint64_t interval;         // conflicts since the previous restart
+    std::uint32_t level;            // the decision level left
+};
+
+// Tunables of SolverT
+struct SolverOptions {
+    // learnt clauses of LBD up to core_lbd are kept forever, those up to
+    // tier2_lbd until tier2_reductions reductions pass without them being
+    // used, the rest (local) only if used since the last reduction or among
+    // the better half of those not used
+    std::uint32_t core_lbd = 2;
+    std::uint32_t tier2_lbd = 6;
+    std::uint32_t tier2_reductions = 2;
+
+    // the first reduction after reduce_first conflicts, each next one
+    // reduce_increment conflicts later than the previous interval
+    std::uint64_t reduce_first = 2000;
+    std::uint64_t reduce_increment = 300;
+
+    // the arena is compacted when this fraction of it is garbage
+    double collect_fraction = 0.25;
+
+    double clause_decay = 0.999;
+
+    // decisions follow the target phases (of the longest conflict-free
+    // trail since the last restart) where known, the saved phases otherwise
+    bool target_phases = true;
+
+    // the saved phases are reset to the best ones, all false, the best,
+    // all true, ... after rephase_interval, 2 * rephase_interval, ...
+    // conflicts
+    std::uint64_t rephase_interval = 1000;
+
+    bool trace_restarts = false;
+
+    // the saved phase of new variables
+    bool initial_phase = false;
+
+    // failed literals are probed at level 0 every probe_interval conflicts
+    // (0 for never), propagating at most probe_effort times the literals
+    // the search propagated since the previous round
+    std::uint64_t probe_interval = 5000;
+    double probe_effort = 0.1;
+
+    // clauses are vivified at level 0 every vivify_interval conflicts (0
+    // for never): the irredundant ones and the learnt ones up to tier2_lbd
+    // not tried yet, propagating at most vivify_effort times the literals
+    // the search propagated since the previous round
+    std::uint64_t vivify_interval = 5000;
+    double vivify_effort = 0.1;
+
+    // XORs of 3 to xor_max_size variables (0 for none, at most 6) are
+    // recovered from the irredundant clauses at the first solve(), and the
+    // systems of two or more of them propagate by Gaussian elimination
+    std::uint32_t xor_max_size = 5;
+};
+
+// Clauses that are retracted together, see SolverT::new_group(). Its
+// clauses carry the negation of the activation literal, which solve()
+// assumes while the group is active. Activation variables are internal to
+// the solver, so they never clash with the formula's.
+struct ClauseGroup {
+    mini::Lit activation;
+};
+
+// Conflict-driven clause-learning SAT solver.
+//
+// Clauses are added as dimacs::Lit (or mini::Lit) and solve() answers with
+// a Result; after Result::sat, model() holds a satisfying assignment.
+// Conflicts are analysed to the first unique implication point, the learnt
+// clause is minimized recursively, and the search jumps back to the second
+// highest level of the learnt clause. The decision heuristic (Evsids or
+// Vmtf, see decision.hpp) and the restart policy (see restart.hpp) are
+// template parameters.
+//
+// Learnt clauses are kept in three tiers by their LBD (see SolverOptions)
+// and the database is reduced periodically, compacting the arena in place
+// when enough of it is garbage:
+//
+//     Solver solver;
+//     solver.add_clause({dimacs::Lit(1), dimacs::Lit(-2)});
+//     if (solver.solve() == Result::sat) {
+//         for (auto lit : solver.model()) ...
+//     }
+//
+// The solver is incremental: clauses may be added between the calls of
+// solve(), which keep the learnt clauses, activities and phases. Literals
+// passed to assume() hold for the next call only, they are decided first
+// (one per level) and if they make the formula unsatisfiable,
+// failed_assumptions() tells which of them were needed. Clause groups are
+// built on the same mechanism, so retracting one is a single unit clause.
+// Their activation variables are hidden from the formula's: it may still
+// use any new variables, and num_vars() and model() skip them:
+//
+//     auto group = solver.new_group();
+//     solver.add_clause(group, {dimacs::Lit(3)});
+//     solver.assume(dimacs::Lit(-3));
+//     solver.solve();                  // UNSAT, failed: -3 and the group
+//     solver.retract(group);
+//     solver.solve();                  // SAT
+template<class Heuristic = Evsids, class Restarts = GlucoseRestarts>
+class SolverT {
+
+    Propagator prop;
+    bool inconsistent; // the empty clause was derived
+    SolverStats counters;
+    std::uint64_t conflict_limit;
+    Heuristic heuristic;
+    Restarts restarts;
+    SolverOptions opts;
+
+    // phases, TwoBit maps hold Value (undef if unknown)
+    VarMap<bool> saved_phases;
+    VarMap<TwoBit> target_phases;
+    VarMap<TwoBit> best_phases;
+    std::size_t target_assigned;
+    std::size_t best_assigned;
+    std::uint64_t next_rephase;
+    std::uint64_t last_restart;
+    std::vector<RestartRecord> restart_records;
+
+    // probing
+    Prober prober;
+    std::uint64_t next_probe;
+    std::uint64_t probe_propagations;   // at the end of the previous round
+
+    // vivification
+    Vivifier vivifier;
+    std::uint64_t next_vivify;
+    std::uint64_t vivify_propagations;
+
+    // Gaussian elimination
+    std::vector<GaussMatrix> matrices;
+    bool xors_recovered;
+    std::vector<mini::Lit> xor_reasons;    // of the last round, one after another
+    std::vector<std::uint32_t> xor_reason_sizes;
+
+    // clause database
+    std::vector<ClauseRef> learnts;
+    float clause_increment;
+    std::uint64_t next_reduce;
+    std::uint64_t reduce_interval;
+    std::vector<ReductionRecord> reduction_records;
+    std::chrono::steady_clock::time_point interval_start;
+    std::uint64_t interval_propagations;
+
+    // conflict analysis
+    VarMap<std::uint8_t> seen;
+    std::vector<mini::Lit> learnt;
+    std::vector<mini::Lit> to_clear;
+    std::vector<mini::Lit> stack;
+    std::vector<std::uint64_t> level_stamps;
+    std::uint64_t stamp;
+
+    // incremental solving
+    std::vector<mini::Lit> assumptions;     // groups first, then assume()d
+    std::vector<mini::Lit> active_groups;   // activation literals
+    std::vector<mini::Lit> failed;
+    std::vector<mini::Lit> failed_lits;     // the assume()d ones of failed
+    std::size_t simplified_trail;           // level 0 trail at the last simplify()
+
+    // the formula's variables 1..num_vars() and the propagator's ones, which
+    // also include the activation variables (at 0 in external_vars)
+    std::vector<std::uint32_t> internal_vars;
+    std::vector<std::uint32_t> external_vars;
+
+    // clause sharing (e.g. in a Portfolio)
+    const std::atomic<bool>* terminate_flag;
+    std::function<void(tools::Span<const mini::Lit>, std::uint32_t)> exporter;
+    std::function<bool(std::vector<mini::Lit>&, std::uint32_t&)> importer;
+    std::uint32_t imported_lbd;
+
+    std::vector<mini::Lit> clause_buffer;
+    std::vector<mini::Lit> import_buffer;
+    std::vector<dimacs::Lit> model_lits;
+
+public:
+
+    explicit SolverT(Heuristic decisions = Heuristic(), Restarts policy = Restarts())
+    : inconsistent(false)
+    , conflict_limit(std::numeric_limits<std::uint64_t>::max())
+    , heuristic(std::move(decisions))
+    , restarts(std::move(policy))
+    , target_assigned(0)
+    , best_assigned(0)
+    , next_rephase(0)
+    , last_restart(0)
+    , next_probe(0)
+    , probe_propagations(0)
+    , next_vivify(0)
+    , vivify_propagations(0)
+    , xors_recovered(false)
+    , clause_increment(1.0f)
+    , next_reduce(0)
+    , reduce_interval(0)
+    , interval_propagations(0)
+    , stamp(0)
+    , simplified_trail(0)
+    , internal_vars(1, 0)
+    , external_vars(1, 0)
+    , terminate_flag(nullptr)
+    , imported_lbd(0)
+    {
+        grow_internal(Var(0));
+    }
+
+    // Makes room for the variables up to max_var (add_clause() does too)
+    template<class U, U U_MAX>
+    void grow_to(VarT<U,U_MAX> max_var)
+    {
+        auto max = static_cast<std::size_t>(static_cast<unsigned>(max_var));
+        if (max < internal_vars.size()) {
+            return;
+        }
+        auto first = prop.num_vars();
+        auto added = max + 1 - internal_vars.size();
+        external_vars.resize(first + added, 0);
+        for (std::size_t i = 0; i < added; ++i) {
+            external_vars[first + i] = static_cast<std::uint32_t>(internal_vars.size());
+            internal_vars.push_back(static_cast<std::uint32_t>(first + i));
+        }
+        grow_internal(Var(static_cast<unsigned>(first + added - 1)));
+    }
+
+    // The highest variable of the formula
+    std::uint64_t num_vars() const
+    {
+        return internal_vars.size() - 1;
+    }
+
+    // Adds a clause, returns false if the formula is now unsatisfiable
+    bool add_clause(tools::Span<const mini::Lit> lits)
+    {
+        import_buffer.clear();
+        for (auto lit : lits) {
+            import_buffer.push_back(internal(lit));
+        }
+        return add_internal(tools::Span<const mini::Lit>(
+            import_buffer.data(), import_buffer.size()));
+    }
+
+    bool add_clause(tools::Span<const dimacs::Lit> lits)
+    {
+        import(lits);
+        return add_internal(tools::Span<const mini::Lit>(
+            import_buffer.data(), import_buffer.size()));
+    }
+
+    bool add_clause(std::initializer_list<dimacs::Lit> lits)
+    {
+        return add_clause(tools::Span<const dimacs::Lit>(lits.begin(), lits.end()));
+    }
+
+    // A new active clause group, its activation literal is a fresh variable
+    // of the solver's own
+    ClauseGroup new_group()
+    {
+        mini::Lit activation(Var(static_cast<unsigned>(prop.num_vars())), true);
+        grow_internal(activation.var());
+        external_vars.push_back(0);
+        active_groups.push_back(activation);
+        return ClauseGroup{activation};
+    }
+
+    // Adds a clause to the group (an active one)
+    bool add_clause(ClauseGroup group, tools::Span<const mini::Lit> lits)
+    {
+        import_buffer.clear();
+        for (auto lit : lits) {
+            import_buffer.push_back(internal(lit));
+        }
+        import_buffer.push_back(~group.activation);
+        return add_internal(tools::Span<const mini::Lit>(
+            import_buffer.data(), import_buffer.size()));
+    }
+
+    bool add_clause(ClauseGroup group, tools::Span<const dimacs::Lit> lits)
+    {
+        import(lits);
+        import_buffer.push_back(~group.activation);
+        return add_internal(tools::Span<const mini::Lit>(
+            import_buffer.data(), import_buffer.size()));
+    }
+
+    bool add_clause(ClauseGroup group, std::initializer_list<dimacs::Lit> lits)
+    {
+        return add_clause(group, tools::Span<const dimacs::Lit>(lits.begin(), lits.end()));
+    }
+
+    // Drops the group's clauses for good: the activation literal becomes
+    // false, and the next solve() removes the clauses (and the learnt ones
+    // derived from them)
+    void retract(ClauseGroup group)
+    {
+        auto it = std::find(active_groups.begin(), active_groups.end(), group.activation);
+        if (it == active_groups.end()) {
+            throw std::invalid_argument("The clause group is not active.");
+        }
+        active_groups.erase(it);
+        mini::Lit unit = ~group.activation;
+        add_internal(tools::Span<const mini::Lit>(&unit, 1));
+    }
+
+    // The literal holds in the next solve() (only)
+    void assume(mini::Lit lit)
+    {
+        assumptions.push_back(internal(lit));
+    }
+
+    void assume(dimacs::Lit lit)
+    {
+        if (static_cast<int>(lit) == 0) {
+            throw std::invalid_argument("Literal 0 is not a valid DIMACS literal.");
+        }
+        assume(to_mini(lit));
+    }
+
+    // Adds all clauses of the formula
+    template<class L>
+    bool add_cnf(const CnfT<L>& cnf)
+    {
+        if (cnf.num_vars() > 0) {
+            grow_to(Var(static_cast<unsigned>(cnf.num_vars())));
+        }
+        for (auto clause : cnf) {
+            if (!add_clause(clause)) {
+                return false;
+            }
+        }
+        return !inconsistent;
+    }
+
+    // The options apply from the next solve() (or the next reduction)
+    SolverOptions& options()
+    {
+        return opts;
+    }
+
+    const SolverOptions& options() const
+    {
+        return opts;
+    }
+
+    // Solve() gives up with Result::unknown at the limit-th conflict of the call
+    void set_conflict_limit(std::uint64_t conflicts)
+    {
+        conflict_limit = conflicts;
+    }
+
+    // Solve() gives up with Result::unknown once the flag is set, from any
+    // thread (it is checked at conflicts and at level 0)
+    void set_terminate(const std::atomic<bool>* flag)
+    {
+        terminate_flag = flag;
+    }
+
+    // Calls f(lits, lbd) for every learnt clause, the literals are valid
+    // during the call only
+    void set_export(std::function<void(tools::Span<const mini::Lit>, std::uint32_t)> f)
+    {
+        exporter = std::move(f);
+    }
+
+    // At level 0, solve() imports clauses from f(lits, lbd) until it returns
+    // false. They must follow from the formula (e.g. learnt by another
+    // solver of the same formula), and they join the learnt clauses.
+    void set_import(std::function<bool(std::vector<mini::Lit>&, std::uint32_t&)> f)
+    {
+        importer = std::move(f);
+    }
+
+    Result solve()
+    {
+        model_lits.clear();
+        failed.clear();
+        failed_lits.clear();
+        ++counters.solves;
+        if (inconsistent) {
+            assumptions.clear();
+            return Result::unsat;
+        }
+        assumptions.insert(assumptions.begin(), active_groups.begin(), active_groups.end());
+        simplify();
+        if (!xors_recovered && opts.xor_max_size > 0) {
+            recover_xors();
+        }
+
+        auto limit = counters.conflicts + std::min(conflict_limit,
+            std::numeric_limits<std::uint64_t>::max() - counters.conflicts);
+        interval_start = std::chrono::steady_clock::now();
+        interval_propagations = prop.propagations();
+        if (reduce_interval == 0) {
+            reschedule();
+        }
+        if (next_rephase == 0) {
+            next_rephase = counters.conflicts + opts.rephase_interval;
+        }
+        if (next_probe == 0) {
+            next_probe = counters.conflicts + opts.probe_interval;
+        }
+        if (next_vivify == 0) {
+            next_vivify = counters.conflicts + opts.vivify_interval;
+        }
+
+        auto result = Result::unknown;
+        while (result == Result::unknown) {
+            auto conflict = prop.propagate();
+            if (!conflict.valid() && !matrices.empty() && propagate_xors(conflict)) {
+                if (inconsistent) {
+                    result = Result::unsat;
+                }
+                if (!conflict.valid()) {
+                    continue;
+                }
+            }
+            if (conflict.valid()) {
+                ++counters.conflicts;
+                if (prop.decision_level() == 0) {
+                    inconsistent = true;
+                    result = Result::unsat;
+                } else if (counters.conflicts >= limit || terminated()) {
+                    break;
+                } else {
+                    learn(conflict);
+                }
+                continue;
+            }
+
+            if (prop.decision_level() > 0 && restarts.restart()) {
+                restart();
+            }
+            if (counters.conflicts >= next_rephase) {
+                rephase();
+            }
+            if (counters.conflicts >= next_reduce) {
+                reduce();
+            }
+            if (prop.decision_level() == 0 && opts.probe_interval > 0
+                && counters.conflicts >= next_probe) {
+                if (!probe()) {
+                    inconsistent = true;
+                    result = Result::unsat;
+                }
+                continue;
+            }
+            if (prop.decision_level() == 0 && opts.vivify_interval > 0
+                && counters.conflicts >= next_vivify) {
+                if (!vivify()) {
+                    inconsistent = true;
+                    result = Result::unsat;
+                }
+                continue;
+            }
+            if (prop.decision_level() == 0 && importer) {
+                if (terminated()) {
+                    break;
+                }
+                if (import_clauses()) {
+                    if (inconsistent) {
+                        result = Result::unsat;
+                    }
+                    continue;
+                }
+            }
+            auto next = next_assumption();
+            if (next != mini::Lit()) {
+                if (prop.value(next) == Value::false_) {
+                    analyze_final(next);
+                    result = Result::unsat;
+                } else {
+                    prop.decide(next);
+                }
+                continue;
+            }
+            next = pick_branch();
+            if (next == mini::Lit()) {
+                save_model();
+                result = Result::sat;
+            } else {
+                ++counters.decisions;
+                prop.decide(next);
+            }
+        }
+
+        for (auto lit : failed) {
+            if (external(lit) != mini::Lit()) {
+                failed_lits.push_back(external(lit));
+            }
+        }
+        backtrack(0);
+        assumptions.clear();
+        update_stats();
+        return result;
+    }
+
+    // After Result::unsat, the assumptions that together with the active
+    // groups (see failed_assumption()) contradict the formula; empty if it
+    // is unsatisfiable without them. Not necessarily a minimal subset.
+    const std::vector<mini::Lit>& failed_assumptions() const
+    {
+        return failed_lits;
+    }
+
+    // Whether the assumption (or the group) is among the failed ones
+    bool failed_assumption(mini::Lit lit) const
+    {
+        return std::find(failed_lits.begin(), failed_lits.end(), lit) != failed_lits.end();
+    }
+
+    bool failed_assumption(dimacs::Lit lit) const
+    {
+        return failed_assumption(to_mini(lit));
+    }
+
+    bool failed_assumption(ClauseGroup group) const
+    {
+        return std::find(failed.begin(), failed.end(), group.activation) != failed.end();
+    }
+
+    // The satisfying assignment of variables 1..num_vars() after
+    // Result::sat, one literal per variable
+    const std::vector<dimacs::Lit>& model() const
+    {
+        return model_lits;
+    }
+
+    // Value of a literal in the model
+    Value model_value(dimacs::Lit lit) const
+    {
+        auto var = static_cast<std::size_t>(lit.var());
+        if (var == 0 || var > model_lits.size()) {
+            return Value::undef;
+        }
+        return model_lits[var - 1] == lit ? Value::true_ : Value::false_;
+    }
+
+    const SolverStats& stats() const
+    {
+        return counters;
+    }
+
+    const std::vector<ReductionRecord>& reduction_log() const
+    {
+        return reduction_records;
+    }
+
+    const std::vector<RestartRecord>& restart_log() const
+    {
+        return restart_records;
+    }
+
+    const Restarts& restart_policy() const
+    {
+        return restarts;
+    }
+
+    const Heuristic& decisions() const
+    {
+        return heuristic;
+    }
+
+    static mini::Lit to_mini(dimacs::Lit lit)
+    {
+        return mini::Lit(lit.var(), lit.sign());
+    }
+
+    static dimacs::Lit to_dimacs(mini::Lit lit)
+    {
+        return dimacs::Lit(lit.var(), lit.sign());
+    }
+
+private:
+
+    template<class U, U U_MAX>
+    void grow_internal(VarT<U,U_MAX> max_var)
+    {
+        prop.grow_to(max_var);
+        heuristic.grow_to(max_var);
+        saved_phases.grow_to(max_var, opts.initial_phase);
+        target_phases.grow_to(max_var, static_cast<std::uint8_t>(Value::undef));
+        best_phases.grow_to(max_var, static_cast<std::uint8_t>(Value::undef));
+        seen.grow_to(max_var, 0);
+        if (level_stamps.size() < prop.num_vars() + 1) {
+            level_stamps.resize(prop.num_vars() + 1, 0);
+        }
+    }
+
+    // The propagator's literal of the formula's one
+    mini::Lit internal(mini::Lit lit)
+    {
+        grow_to(lit.var());
+        auto var = internal_vars[static_cast<unsigned>(lit.var())];
+        return mini::Lit(Var(var), lit.sign());
+    }
+
+    // The formula's literal of the propagator's one, mini::Lit() for an
+    // activation literal
+    mini::Lit external(mini::Lit lit) const
+    {
+        auto var = external_vars[static_cast<unsigned>(lit.var())];
+        return var == 0 ? mini::Lit() : mini::Lit(Var(var), lit.sign());
+    }
+
+    // Adds a clause over the propagator's variables, returns false if the
+    // formula is now unsatisfiable
+    bool add_internal(tools::Span<const mini::Lit> lits)
+    {
+        backtrack(0);
+        if (inconsistent) {
+            return false;
+        }
+
+        clause_buffer.assign(lits.begin(), lits.end());
+
+        // sort, drop duplicates and false literals, skip satisfied clauses
+        std::sort(clause_buffer.begin(), clause_buffer.end());
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < clause_buffer.size(); ++i) {
+            auto lit = clause_buffer[i];
+            if (prop.value(lit) == Value::true_
+                || (kept > 0 && clause_buffer[kept - 1] == ~lit)) {
+                return true;
+            }
+            if (prop.value(lit) == Value::undef
+                && (kept == 0 || clause_buffer[kept - 1] != lit)) {
+                clause_buffer[kept++] = lit;
+            }
+        }
+        clause_buffer.resize(kept);
+
+        if (clause_buffer.empty()) {
+            inconsistent = true;
+        } else if (clause_buffer.size() == 1) {
+            prop.assign(clause_buffer[0], ClauseRef());
+            inconsistent = prop.propagate().valid();
+        } else {
+            prop.add_clause(tools::Span<const mini::Lit>(
+                clause_buffer.data(), clause_buffer.size()));
+        }
+        return !inconsistent;
+    }
+
+    bool terminated() const
+    {
+        return terminate_flag != nullptr && terminate_flag->load(std::memory_order_relaxed);
+    }
+
+    // Adds the clauses from the importer (at level 0), returns whether
+    // there were any
+    bool import_clauses()
+    {
+        bool any = false;
+        while (!inconsistent && importer(clause_buffer, imported_lbd)) {
+            any = true;
+            ++counters.imported_clauses;
+
+            std::size_t kept = 0;
+            bool satisfied = false;
+            for (auto lit : clause_buffer) {
+                if (static_cast<unsigned>(lit.var()) >= prop.num_vars()) {
+                    grow_to(lit.var()); // of a solver without groups, the same numbering
+                }
+                auto value = prop.value(lit);
+                satisfied = satisfied || value == Value::true_;
+                if (value == Value::undef) {
+                    clause_buffer[kept++] = lit;
+                }
+            }
+            clause_buffer.resize(kept);
+            if (satisfied) {
+                continue;
+            } else if (clause_buffer.empty()) {
+                inconsistent = true;
+            } else if (clause_buffer.size() == 1) {
+                prop.assign(clause_buffer[0], ClauseRef());
+            } else {
+                auto ref = prop.add_clause(tools::Span<const mini::Lit>(
+                    clause_buffer.data(), clause_buffer.size()), true);
+                auto clause = prop.arena()[ref];
+                clause.set_lbd(std::max<std::uint32_t>(1, std::min<std::uint32_t>(
+                    imported_lbd, static_cast<std::uint32_t>(kept))));
+                clause.set_activity(clause_increment);
+                learnts.push_back(ref);
+            }
+        }
+        return any;
+    }
+
+    void import(tools::Span<const dimacs::Lit> lits)
+    {
+        import_buffer.clear();
+        for (auto lit : lits) {
+            if (static_cast<int>(lit) == 0) {
+                throw std::invalid_argument("Literal 0 is not a valid DIMACS literal.");
+            }
+            import_buffer.push_back(internal(to_mini(lit)));
+        }
+    }
+
+    // The assumption of the next decision level, or mini::Lit() when all
+    // of them are decided. Opens empty levels for those true already, so
+    // the i-th assumption always belongs to level i + 1.
+    mini::Lit next_assumption()
+    {
+        while (prop.decision_level() < assumptions.size()) {
+            auto lit = assumptions[prop.decision_level()];
+            if (prop.value(lit) != Value::true_) {
+                return lit;
+            }
+            prop.new_level();
+        }
+        return mini::Lit();
+    }
+
+    // The assumption is false: collects the assumptions it follows from
+    // into failed, by walking the implication graph back from it
+    void analyze_final(mini::Lit assumption)
+    {
+        failed.assign(1, assumption);
+        if (prop.level(assumption.var()) == 0) {
+            return;
+        }
+
+        auto trail = prop.trail();
+        seen[assumption.var()] = 1;
+        for (auto i = trail.size(); i-- > prop.level_start(1);) {
+            auto lit = trail[i];
+            if (!seen[lit.var()]) {
+                continue;
+            }
+            seen[lit.var()] = 0;
+            auto reason = prop.reason(lit.var());
+            if (!reason.valid()) {
+                failed.push_back(lit); // all decisions are assumptions here
+                continue;
+            }
+            for (auto other : prop.arena()[reason]) {
+                if (other != lit && prop.level(other.var()) > 0) {
+                    seen[other.var()] = 1;
+                }
+            }
+        }
+    }
+
+    // Removes the clauses satisfied at level 0 if there are new units since
+    // the last call, e.g. those of retracted groups
+    void simplify()
+    {
+        assert(prop.decision_level() == 0 && "Only level 0 assignments are permanent");
+        if (prop.trail().size() == simplified_trail) {
+            return;
+        }
+        simplified_trail = prop.trail().size();
+
+        auto& arena = prop.arena();
+        std::vector<ClauseRef> satisfied;
+        arena.for_each_clause([this, &arena, &satisfied](ClauseRef ref) {
+            for (auto lit : arena[ref]) {
+                if (prop.value(lit) == Value::true_) {
+                    if (!prop.locked(ref)) {
+                        satisfied.push_back(ref);
+                    }
+                    return;
+                }
+            }
+        });
+        for (auto ref : satisfied) {
+            prop.remove_clause(ref);
+        }
+        learnts.erase(std::remove_if(learnts.begin(), learnts.end(), [&arena](ClauseRef ref) {
+            return arena[ref].garbage();
+        }), learnts.end());
+        counters.simplified_clauses += satisfied.size();
+        collect_if_wasteful();
+    }
+
+    // Probes with a budget proportional to the search since the previous
+    // round, returns false if the formula is unsatisfiable. The probes
+    // leave the heuristic alone: nothing is picked while they run.
+    bool probe()
+    {
+        auto searched = prop.propagations() - probe_propagations;
+        auto consistent = prober.probe(prop,
+            static_cast<std::uint64_t>(opts.probe_effort * static_cast<double>(searched)));
+        probe_propagations = prop.propagations();
+        next_probe = counters.conflicts + opts.probe_interval;
+
+        const auto& probed = prober.stats();
+        counters.probes = probed.probes;
+        counters.failed_literals = probed.failed_literals;
+        counters.hyper_binaries = probed.hyper_binaries;
+        return consistent;
+    }
+
+    // Vivifies the clauses not tried yet, with a budget proportional to the
+    // search since the previous round. Returns false if the formula is
+    // unsatisfiable.
+    bool vivify()
+    {
+        auto& arena = prop.arena();
+        std::vector<ClauseRef> candidates;
+        for (auto ref : learnts) {
+            auto clause = arena[ref];
+            if (clause.lbd() <= opts.tier2_lbd && !clause.vivified()) {
+                candidates.push_back(ref);
+            }
+        }
+        arena.for_each_clause([&arena, &candidates](ClauseRef ref) {
+            auto clause = arena[ref];
+            if (!clause.learnt() && !clause.vivified()) {
+                candidates.push_back(ref);
+            }
+        });
+
+        auto searched = prop.propagations() - vivify_propagations;
+        std::vector<ClauseRef> shortened;
+        auto consistent = vivifier.vivify(prop, candidates,
+            static_cast<std::uint64_t>(opts.vivify_effort * static_cast<double>(searched)),
+            [&arena, &shortened](ClauseRef, ClauseRef shorter) {
+                if (shorter.valid() && arena[shorter].learnt()) {
+                    shortened.push_back(shorter);
+                }
+            });
+        learnts.erase(std::remove_if(learnts.begin(), learnts.end(), [&arena](ClauseRef ref) {
+            return arena[ref].garbage();
+        }), learnts.end());
+        learnts.insert(learnts.end(), shortened.begin(), shortened.end());
+        vivify_propagations = prop.propagations();
+        next_vivify = counters.conflicts + opts.vivify_interval;
+
+        const auto& vivified = vivifier.stats();
+        counters.vivified_clauses = vivified.shortened;
+        counters.vivified_lits = vivified.removed_lits;
+        counters.vivify_seconds = vivified.seconds;
+        return consistent;
+    }
+
+    // Finds the XORs among the irredundant clauses (but those of the clause
+    // groups, which may be retracted), builds a matrix for each system
+    void recover_xors()
+    {
+        xors_recovered = true;
+        XorFinder finder(opts.xor_max_size);
+        auto& arena = prop.arena();
+        auto groups = active_groups;
+        arena.for_each_clause([&arena, &finder, &groups](ClauseRef ref) {
+            auto clause = arena[ref];
+            if (clause.learnt()) {
+                return;
+            }
+            for (auto lit : clause) {
+                for (auto activation : groups) {
+                    if (lit == ~activation) {
+                        return;
+                    }
+                }
+            }
+            finder.add_clause(tools::Span<const mini::Lit>(clause.begin(), clause.size()));
+        });
+
+        auto xors = finder.find();
+        counters.xors = xors.size();
+        for (const auto& system : split_xors(xors)) {
+            if (system.size() >= 2) {
+                matrices.emplace_back(system);
+            }
+        }
+        counters.xor_matrices = matrices.size();
+    }
+
+    // Eliminates the matrices under the current assignment: assigns the
+    // implied literals with their reasons as learnt clauses, or returns the
+    // conflict in the same way. Returns whether there was anything to do.
+    // A reason without literals above level 0 makes a unit, for which the
+    // search goes back to level 0. The reasons not applied (after a unit or
+    // a conflict) are found again, as the matrices report them until
+    // nothing is found.
+    bool propagate_xors(ClauseRef& conflict)
+    {
+        xor_reasons.clear();
+        xor_reason_sizes.clear();
+        auto& reasons = xor_reasons;
+        auto& sizes = xor_reason_sizes;
+        auto keep = [&reasons, &sizes](tools::Span<const mini::Lit> reason) {
+            reasons.insert(reasons.end(), reason.begin(), reason.end());
+            sizes.push_back(static_cast<std::uint32_t>(reason.size()));
+        };
+        bool consistent = true;
+        for (auto& matrix : matrices) {
+            consistent = matrix.propagate(prop.assignment(), keep);
+            if (!consistent) {
+                reasons.clear();
+                sizes.clear();
+                keep(matrix.conflict());
+                break;
+            }
+        }
+        update_gauss_stats();
+        if (sizes.empty()) {
+            return false;
+        }
+
+        std::size_t start = 0;
+        for (auto size : sizes) {
+            auto begin = reasons.begin() + static_cast<std::ptrdiff_t>(start);
+            start += size;
+
+            // the level 0 literals go, the false ones of the highest levels
+            // are watched
+            auto end = std::remove_if(begin + (consistent ? 1 : 0), begin + size,
+                [this](mini::Lit lit) { return prop.level(lit.var()) == 0; });
+            if (!consistent) {
+                move_highest(begin, end);
+            }
+            move_highest(begin + 1, end);
+            auto lits = tools::Span<const mini::Lit>(&*begin, static_cast<std::size_t>(end - begin));
+
+            if (lits.size() == 0) {
+                inconsistent = true;
+                return true;
+            } else if (lits.size() == 1) {
+                backtrack(0);
+                prop.assign(lits[0], ClauseRef());
+                return true;
+            } else if (!consistent) {
+                // the analysis needs the conflict at the current level
+                backtrack(prop.level(lits[0].var()));
+                conflict = add_reason(lits);
+                return true;
+            }
+            auto ref = add_reason(lits);
+            prop.assign(lits[0], ref);
+        }
+        return true;
+    }
+
+    // Moves the literal of the highest level in [begin, end) to begin
+    template<class It>
+    void move_highest(It begin, It end)
+    {
+        for (auto it = begin; it < end; ++it) {
+            if (prop.level(it->var()) > prop.level(begin->var())) {
+                std::swap(*begin, *it);
+            }
+        }
+    }
+
+    ClauseRef add_reason(tools::Span<const mini::Lit> lits)
+    {
+        auto ref = prop.add_clause(lits, true);
+        auto clause = prop.arena()[ref];
+        clause.set_lbd(compute_lbd(lits));
+        clause.set_activity(clause_increment);
+        learnts.push_back(ref);
+        return ref;
+    }
+
+    void update_gauss_stats()
+    {
+        counters.gauss_eliminations = 0;
+        counters.gauss_propagations = 0;
+        counters.gauss_conflicts = 0;
+        for (const auto& matrix : matrices) {
+            counters.gauss_eliminations += matrix.stats().eliminations;
+            counters.gauss_propagations += matrix.stats().propagations;
+            counters.gauss_conflicts += matrix.stats().conflicts;
+        }
+    }
+
+    // Unassigns everything above the level, saving the phases
+    void backtrack(std::uint32_t level)
+    {
+        prop.backtrack(level, [this](mini::Lit lit) {
+            Var var(lit.var());
+            saved_phases[var] = lit.sign();
+            heuristic.unassigned(var);
+        });
+    }
+
+    mini::Lit pick_branch()
+    {
+        auto var = heuristic.next(prop.assignment());
+        if (static_cast<unsigned>(var) == 0) {
+            return mini::Lit();
+        }
+        auto target = static_cast<Value>(static_cast<std::uint8_t>(target_phases[var]));
+        if (opts.target_phases && target != Value::undef) {
+            return mini::Lit(var, target == Value::true_);
+        }
+        return mini::Lit(var, saved_phases[var]);
+    }
+
+    // Remembers the trail up to the size as the target (and the best)
+    // phases if it is the longest one so far
+    void update_phases(std::size_t size)
+    {
+        auto trail = prop.trail();
+        if (size > target_assigned) {
+            for (std::size_t i = 0; i < size; ++i) {
+                target_phases[trail[i].var()] = static_cast<std::uint8_t>(trail[i].sign());
+            }
+            target_assigned = size;
+        }
+        if (size > best_assigned) {
+            for (std::size_t i = 0; i < size; ++i) {
+                best_phases[trail[i].var()] = static_cast<std::uint8_t>(trail[i].sign());
+            }
+            best_assigned = size;
+        }
+    }
+
+    void restart()
+    {
+        if (opts.trace_restarts) {
+            restart_records.push_back(RestartRecord{counters.conflicts,
+                counters.conflicts - last_restart, prop.decision_level()});
+        }
+        last_restart = counters.conflicts;
+        ++counters.restarts;
+        target_assigned = 0;
+        backtrack(0);
+    }
+
+    // Resets the saved phases, cycling through the best, all false, the
+    // best and all true
+    void rephase()
+    {
+        auto kind = counters.rephases % 4;
+        for (std::size_t v = 1; v < prop.num_vars(); ++v) {
+            Var var(static_cast<unsigned>(v));
+            if (kind == 1 || kind == 3) {
+                saved_phases[var] = kind == 3;
+            } else {
+                auto best = static_cast<Value>(static_cast<std::uint8_t>(best_phases[var]));
+                if (best != Value::undef) {
+                    saved_phases[var] = best == Value::true_;
+                }
+            }
+        }
+        target_phases.fill(static_cast<std::uint8_t>(Value::undef));
+        target_assigned = 0;
+        if (kind == 0 || kind == 2) {
+            best_assigned = 0;
+        }
+
+        ++counters.rephases;
+        next_rephase = counters.conflicts + opts.rephase_interval * (counters.rephases + 1);
+    }
+
+    void save_model()
+    {
+        model_lits.clear();
+        for (std::size_t v = 1; v < internal_vars.size(); ++v) {
+            Var var(internal_vars[v]);
+            model_lits.push_back(dimacs::Lit(Var(static_cast<unsigned>(v)),
+                prop.value(var) == Value::true_));
+        }
+    }
+
+    // Analyses the conflict, jumps back and asserts the learnt clause
+    void learn(ClauseRef conflict)
+    {
+        auto level = analyze(conflict);
+        auto lbd = compute_lbd(tools::Span<const mini::Lit>(learnt.data(), learnt.size()));
+        restarts.conflict(lbd);
+        if (exporter) {
+            exporter(tools::Span<const mini::Lit>(learnt.data(), learnt.size()), lbd);
+        }
+        update_phases(prop.level_start(prop.decision_level()));
+        backtrack(level);
+        heuristic.after_conflict(prop.assignment());
+
+        if (learnt.size() == 1) {
+            prop.assign(learnt[0], ClauseRef());
+        } else {
+            auto ref = prop.add_clause(
+                tools::Span<const mini::Lit>(learnt.data(), learnt.size()), true);
+            auto clause = prop.arena()[ref];
+            clause.set_lbd(lbd);
+            clause.set_activity(clause_increment);
+            protect(clause);
+            learnts.push_back(ref);
+            prop.assign(learnt[0], ref);
+        }
+        decay_clauses();
+    }
+
+    // Derives the first-UIP clause into learnt, with the asserting literal
+    // first and a literal of the backjump level second. Returns the level.
+    std::uint32_t analyze(ClauseRef conflict)
+    {
+        learnt.clear();
+        learnt.push_back(mini::Lit()); // the UIP goes here
+
+        auto trail = prop.trail();
+        auto index = trail.size();
+        auto current = prop.decision_level();
+        std::size_t open = 0; // literals of the current level to resolve
+        mini::Lit resolved;
+        bool first = true;
+        auto ref = conflict;
+
+        do {
+            assert(ref.valid() && "Only implied literals are resolved");
+            if (prop.arena()[ref].learnt()) {
+                note_use(ref);
+            }
+            for (auto lit : prop.arena()[ref]) {
+                auto var = lit.var();
+                if ((!first && lit == resolved) || seen[var]
+                    || prop.level(var) == 0) {
+                    continue;
+                }
+                seen[var] = 1;
+                heuristic.bump(Var(var));
+                if (prop.level(var) >= current) {
+                    ++open;
+                } else {
+                    learnt.push_back(lit);
+                }
+            }
+
+            // the latest assigned literal of the conflict
+            do {
+                --index;
+            } while (!seen[trail[index].var()]);
+            resolved = trail[index];
+            ref = prop.reason(resolved.var());
+            seen[resolved.var()] = 0;
+            first = false;
+        } while (--open > 0);
+        learnt[0] = ~resolved;
+
+        minimize();
+
+        // the highest level among the rest goes second
+        std::uint32_t level = 0;
+        for (std::size_t i = 1; i < learnt.size(); ++i) {
+            auto lit_level = prop.level(learnt[i].var());
+            if (lit_level > level) {
+                level = lit_level;
+                std::swap(learnt[1], learnt[i]);
+            }
+        }
+        counters.learnt_lits += learnt.size();
+        return level;
+    }
+
+    static std::uint32_t abstract_level(std::uint32_t level)
+    {
+        return 1u << (level & 31);
+    }
+
+    // Drops the literals implied by the others (recursive minimization)
+    void minimize()
+    {
+        to_clear.assign(learnt.begin(), learnt.end());
+        std::uint32_t levels = 0;
+        for (std::size_t i = 1; i < learnt.size(); ++i) {
+            levels |= abstract_level(prop.level(learnt[i].var()));
+        }
+
+        std::size_t kept = 1;
+        for (std::size_t i = 1; i < learnt.size(); ++i) {
+            auto lit = learnt[i];
+            if (!prop.reason(lit.var()).valid() || !redundant(lit, levels)) {
+                learnt[kept++] = lit;
+            }
+        }
+        counters.minimized_lits += learnt.size() - kept;
+        learnt.resize(kept);
+
+        for (auto lit : to_clear) {
+            seen[lit.var()] = 0;
+        }
+    }
+
+    // Whether the literal of the learnt clause follows from the others,
+    // levels is the abstraction of their levels
+    bool redundant(mini::Lit lit, std::uint32_t levels)
+    {
+        stack.assign(1, lit);
+        auto top = to_clear.size();
+        while (!stack.empty()) {
+            auto implied = stack.back();
+            stack.pop_back();
+            for (auto other : prop.arena()[prop.reason(implied.var())]) {
+                auto var = other.var();
+                if (other == ~implied || seen[var] || prop.level(var) == 0) {
+                    continue;
+                }
+                if (prop.reason(var).valid()
+                    && (abstract_level(prop.level(var)) & levels) != 0) {
+                    seen[var] = 1;
+                    stack.push_back(other);
+                    to_clear.push_back(other);
+                } else {
+                    for (auto i = top; i < to_clear.size(); ++i) {
+                        seen[to_clear[i].var()] = 0;
+                    }
+                    to_clear.resize(top);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Number of distinct decision levels of the (assigned) literals
+    std::uint32_t compute_lbd(tools::Span<const mini::Lit> lits)
+    {
+        ++stamp;
+        std::uint32_t lbd = 0;
+        for (auto lit : lits) {
+            auto level = prop.level(lit.var());
+            if (level_stamps[level] != stamp) {
+                level_stamps[level] = stamp;
+                ++lbd;
+            }
+        }
+        return lbd;
+    }
+
+    // A learnt clause took part in conflict analysis: its LBD may improve,
+    // it is protected from the next reductions and its activity grows
+    void note_use(ClauseRef ref)
+    {
+        auto clause = prop.arena()[ref];
+        if (clause.lbd() > opts.core_lbd) {
+            auto lbd = compute_lbd(tools::Span<const mini::Lit>(clause.begin(), clause.size()));
+            if (lbd < clause.lbd()) {
+                clause.set_lbd(lbd);
+            }
+        }
+        protect(clause);
+        if (clause.lbd() > opts.tier2_lbd) {
+            clause.set_activity(clause.activity() + clause_increment);
+            if (clause.activity() > 1e20f) {
+                rescale_clauses();
+            }
+        }
+    }
+
+    // A local clause survives the next reduction, a tier-2 one also the
+    // next tier2_reductions ones
+    void protect(Clause clause)
+    {
+        clause.set_used(clause.lbd() <= opts.tier2_lbd ? opts.tier2_reductions + 1 : 1);
+    }
+
+    void decay_clauses()
+    {
+        clause_increment /= static_cast<float>(opts.clause_decay);
+        if (clause_increment > 1e20f) {
+            rescale_clauses();
+        }
+    }
+
+    void rescale_clauses()
+    {
+        for (auto ref : learnts) {
+            auto clause = prop.arena()[ref];
+            clause.set_activity(clause.activity() * 1e-20f);
+        }
+        clause_increment *= 1e-20f;
+    }
+
+    void reschedule()
+    {
+        reduce_interval = reduce_interval == 0
+            ? opts.reduce_first : reduce_interval + opts.reduce_increment;
+        next_reduce = counters.conflicts + reduce_interval;
+    }
+
+    // Deletes the worse half of the clauses not protected by a recent use
+    // (local ones, and tier-2 ones unused for tier2_reductions reductions),
+    // then compacts the arena if worthwhile
+    void reduce()
+    {
+        auto& arena = prop.arena();
+        std::vector<ClauseRef> candidates;
+        std::size_t kept = 0;
+        for (auto ref : learnts) {
+            auto clause = arena[ref];
+            if (clause.lbd() <= opts.core_lbd || clause.size() == 2) {
+                learnts[kept++] = ref;
+            } else if (clause.used()) {
+                clause.set_used(clause.used() - 1);
+                learnts[kept++] = ref;
+            } else if (prop.locked(ref)) {
+                learnts[kept++] = ref;
+            } else {
+                candidates.push_back(ref);
+            }
+        }
+        learnts.resize(kept);
+
+        // the worst first: high LBD, then low activity
+        std::sort(candidates.begin(), candidates.end(), [&arena](ClauseRef lhs, ClauseRef rhs) {
+            auto a = arena[lhs];
+            auto b = arena[rhs];
+            return a.lbd() != b.lbd() ? a.lbd() > b.lbd() : a.activity() < b.activity();
+        });
+        auto deleted = candidates.size() / 2;
+        for (std::size_t i = 0; i < candidates.size(); ++i) {
+            if (i < deleted) {
+                prop.remove_clause(candidates[i]);
+            } else {
+                learnts.push_back(candidates[i]);
+            }
+        }
+
+        auto reclaimed = collect_if_wasteful();
+
+        auto now = std::chrono::steady_clock::now();
+        auto seconds = std::chrono::duration<double>(now - interval_start).count();
+        auto propagated = prop.propagations() - interval_propagations;
+        reduction_records.push_back(ReductionRecord{counters.conflicts,
+            static_cast<std::uint64_t>(learnts.size()), static_cast<std::uint64_t>(deleted),
+            reclaimed, seconds > 0 ? static_cast<double>(propagated) / seconds : 0.0});
+        interval_start = now;
+        interval_propagations = prop.propagations();
+
+        ++counters.reductions;
+        counters.deleted_clauses += deleted;
+        update_stats();
+        reschedule();
+    }
+
+    // Compacts the arena if enough of it is garbage, returns the bytes
+    // reclaimed
+    std::uint64_t collect_if_wasteful()
+    {
+        auto& arena = prop.arena();
+        if (arena.wasted_words() <= opts.collect_fraction * static_cast<double>(arena.size())) {
+            return 0;
+        }
+        auto before = arena.size();
+        auto moved = prop.collect_garbage();
+        for (auto& ref : learnts) {
+            moved.relocate(ref);
+        }
+        std::uint64_t reclaimed = (before - arena.size()) * sizeof(std::uint32_t);
+        ++counters.collections;
+        counters.reclaimed_bytes += reclaimed;
+        return reclaimed;
+    }
+
+    void update_stats()
+    {
+        counters.propagations = prop.propagations();
+        counters.learnt_clauses = learnts.size();
+        counters.arena_bytes = prop.arena().size() * sizeof(std::uint32_t);
+    }
+
+}; // SolverT
+
+using Solver = SolverT<>;
+
+} // hubero
+#endif // HUBERO_SOLVER_H_
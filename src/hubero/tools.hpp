@@ -6,8 +6,12 @@
 #ifndef HUBERO_TOOLS_H_
 #define HUBERO_TOOLS_H_
 
+#include <cstddef>
+#include <cstring>
+#include <limits>
 #include <stdexcept>
 #include <string>
+#include <system_error>
 #include <typeinfo>
 #include <type_traits>
 
@@ -66,6 +70,131 @@ namespace tools {
         }
 #endif
     } // type_to_string
+
+
+
+    // Non-owning view of a contiguous sequence (a poor man's std::span,
+    // which is not available in C++11).
+    template<class T>
+    class Span {
+
+        T* first;
+        std::size_t count;
+
+    public:
+
+        using value_type = typename std::remove_cv<T>::type;
+        using iterator = T*;
+
+        Span() : first(nullptr), count(0) {}
+
+        Span(T* data, std::size_t size) : first(data), count(size) {}
+
+        Span(T* begin, T* end)
+        : first(begin), count(static_cast<std::size_t>(end - begin))
+        {}
+
+        // Span<T> is implicitly convertible to Span<const T>
+        template<class U, class = typename std::enable_if<
+            std::is_convertible<U(*)[], T(*)[]>::value>::type>
+        Span(const Span<U>& other) : first(other.data()), count(other.size()) {}
+
+        T* data() const { return first; }
+        std::size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+
+        T* begin() const { return first; }
+        T* end() const { return first + count; }
+
+        T& operator [](std::size_t i) const { return first[i]; }
+        T& front() const { return first[0]; }
+        T& back() const { return first[count - 1]; }
+
+    }; // Span
+
+    template<class T>
+    Span<T> make_span(T* data, std::size_t size)
+    {
+        return Span<T>(data, size);
+    }
+
+
+
+    // Result of to_chars(), mirrors std::to_chars_result (C++17)
+    struct ToCharsResult {
+        char* ptr;
+        std::errc ec;
+    };
+
+    // Longest decimal representation of an integer type, including the sign
+    template<class U>
+    constexpr std::size_t max_chars()
+    {
+        return std::numeric_limits<U>::digits10 + 1 + (std::is_signed<U>::value ? 1 : 0);
+    }
+
+    template<class U>
+    unsigned count_digits(U value)
+    {
+        static_assert(std::is_unsigned<U>::value, "Digits are counted for unsigned types.");
+        unsigned digits = 1;
+        for (;;) {
+            if (value < 10) return digits;
+            if (value < 100) return digits + 1;
+            if (value < 1000) return digits + 2;
+            if (value < 10000) return digits + 3;
+            value /= 10000;
+            digits += 4;
+        }
+    }
+
+    // Formats an unsigned integer into [first, last) without allocating,
+    // two digits at a time. Fails with std::errc::value_too_large if the
+    // digits do not fit (and leaves the range in an unspecified state).
+    template<class U>
+    ToCharsResult to_chars(char* first, char* last, U value)
+    {
+        static_assert(std::is_unsigned<U>::value, "Only unsigned types are formatted.");
+        static const char pairs[] =
+            "0001020304050607080910111213141516171819"
+            "2021222324252627282930313233343536373839"
+            "4041424344454647484950515253545556575859"
+            "6061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
+
+        auto digits = count_digits(value);
+        if (static_cast<std::size_t>(last - first) < digits) {
+            return ToCharsResult{last, std::errc::value_too_large};
+        }
+
+        auto pos = first + digits;
+        while (value >= 100) {
+            auto pair = static_cast<std::size_t>(value % 100) * 2;
+            value /= 100;
+            pos -= 2;
+            std::memcpy(pos, pairs + pair, 2);
+        }
+        if (value >= 10) {
+            std::memcpy(pos - 2, pairs + static_cast<std::size_t>(value) * 2, 2);
+        } else {
+            pos[-1] = static_cast<char>('0' + value);
+        }
+        return ToCharsResult{first + digits, std::errc()};
+    }
+
+    // Formats a minus sign (if negative) and the digits of magnitude
+    template<class U>
+    ToCharsResult to_chars(char* first, char* last, bool negative, U magnitude)
+    {
+        if (negative) {
+            if (first == last) {
+                return ToCharsResult{last, std::errc::value_too_large};
+            }
+            *first++ = '-';
+        }
+        return to_chars(first, last, magnitude);
+    }
+
 } // tools
 } // hubero
 #endif // HUBERO_TOOLS_H_
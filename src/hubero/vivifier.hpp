@@ -0,0 +1,273 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_VIVIFIER_H_
+#define HUBERO_VIVIFIER_H_
+
+#include <hubero/clause_arena.hpp>
+#include <hubero/core.hpp>
+#include <hubero/maps.hpp>
+#include <hubero/propagator.hpp>
+#include <hubero/tools.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hubero {
+
+struct VivifyStats {
+    std::uint64_t rounds = 0;
+    std::uint64_t tried = 0;            // clauses
+    std::uint64_t shortened = 0;        // clauses
+    std::uint64_t removed_lits = 0;
+    std::uint64_t units = 0;            // clauses shortened to one literal
+    std::uint64_t reused_levels = 0;    // decisions kept from the previous clause
+    std::uint64_t ticks = 0;            // literals propagated while vivifying
+    double seconds = 0;
+
+    double removed_per_second() const
+    {
+        return seconds > 0 ? static_cast<double>(removed_lits) / seconds : 0.0;
+    }
+};
+
+// Clause vivification, at level 0 of a Propagator.
+//
+// The negations of a clause's literals are decided one by one. If the
+// propagation conflicts, the decided literals alone make a clause implied
+// by the formula; if a literal of the clause becomes true (not by the
+// clause itself), the decisions and that literal do; and the literals
+// implied false can be dropped. Either way the clause shrinks.
+//
+// The literals of each clause are ordered by their occurrences among the
+// candidates, and the candidates lexicographically by the ordered literals,
+// so consecutive clauses share prefixes: the decisions of the previous
+// clause are kept as long as they negate literals of the next one.
+//
+// A shortened clause is replaced by a new one (same learnt flag, LBD at
+// most its size, same activity), units are assigned at level 0. Every
+// tried clause is flagged as vivified, and the caller is told about the
+// replacements to update its references:
+//
+//     Vivifier vivifier;
+//     vivifier.vivify(prop, candidates, 100000, [](ClauseRef old, ClauseRef shorter) {
+//         ... shorter is invalid for units
+//     });
+class Vivifier {
+
+    struct Candidate {
+        ClauseRef ref;
+        std::uint32_t start;    // of the ordered literals
+        std::uint32_t size;
+    };
+
+    std::vector<Candidate> candidates;
+    std::vector<mini::Lit> ordered;
+    LitMap<std::uint32_t> counts;
+    LitMap<std::uint64_t> marks;
+    std::uint64_t stamp;
+    std::vector<mini::Lit> shorter;
+    VivifyStats counters;
+
+public:
+
+    Vivifier() : stamp(0) {}
+
+    // Vivifies the clauses (of 3+ literals) until ticks literals are
+    // propagated, calls replaced(old, shorter) for each shortened one. The
+    // propagator must be at level 0 and it stays there. Returns false if
+    // the formula is unsatisfiable.
+    template<class F>
+    bool vivify(Propagator& prop, const std::vector<ClauseRef>& clauses, std::uint64_t ticks,
+        F replaced)
+    {
+        assert(prop.decision_level() == 0 && "Vivification starts at level 0");
+        auto start_time = std::chrono::steady_clock::now();
+        auto start = prop.propagations();
+        ++counters.rounds;
+        if (prop.propagate().valid()) {
+            return false;
+        }
+        schedule(prop, clauses);
+
+        bool consistent = true;
+        for (const auto& candidate : candidates) {
+            if (prop.propagations() - start >= ticks) {
+                break;
+            }
+            if (prop.arena()[candidate.ref].garbage()) {
+                continue;
+            }
+            if (!vivify(prop, candidate, replaced)) {
+                consistent = false;
+                break;
+            }
+        }
+        prop.backtrack(0);
+
+        counters.ticks += prop.propagations() - start;
+        counters.seconds += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start_time).count();
+        return consistent;
+    }
+
+    const VivifyStats& stats() const
+    {
+        return counters;
+    }
+
+private:
+
+    // Orders the literals of the candidates, and the candidates
+    void schedule(const Propagator& prop, const std::vector<ClauseRef>& clauses)
+    {
+        auto max_var = Var(static_cast<unsigned>(prop.num_vars() - 1));
+        counts.grow_to(max_var, 0);
+        marks.grow_to(max_var, 0);
+        candidates.clear();
+        ordered.clear();
+
+        for (auto ref : clauses) {
+            auto clause = prop.arena()[ref];
+            if (clause.garbage() || clause.size() < 3) {
+                continue;
+            }
+            candidates.push_back(Candidate{ref, static_cast<std::uint32_t>(ordered.size()), clause.size()});
+            for (auto lit : clause) {
+                ordered.push_back(lit);
+                ++counts[lit];
+            }
+        }
+
+        auto& occurrences = counts;
+        auto more_frequent = [&occurrences](mini::Lit lhs, mini::Lit rhs) {
+            return occurrences[lhs] != occurrences[rhs]
+                ? occurrences[lhs] > occurrences[rhs] : lhs < rhs;
+        };
+        for (const auto& candidate : candidates) {
+            auto begin = ordered.begin() + candidate.start;
+            std::sort(begin, begin + candidate.size, more_frequent);
+        }
+        const auto& lits = ordered;
+        std::sort(candidates.begin(), candidates.end(),
+            [&lits, &more_frequent](const Candidate& lhs, const Candidate& rhs) {
+                auto a = lits.begin() + lhs.start;
+                auto b = lits.begin() + rhs.start;
+                return std::lexicographical_compare(a, a + lhs.size, b, b + rhs.size, more_frequent);
+            });
+
+        for (auto lit : ordered) {
+            counts[lit] = 0;
+        }
+    }
+
+    template<class F>
+    bool vivify(Propagator& prop, const Candidate& candidate, F replaced)
+    {
+        ++counters.tried;
+        auto ref = candidate.ref;
+        prop.arena()[ref].set_vivified(true);
+        auto lits = tools::Span<const mini::Lit>(ordered.data() + candidate.start, candidate.size);
+
+        // keep the decisions that negate literals of the clause
+        ++stamp;
+        for (auto lit : lits) {
+            marks[lit] = stamp;
+        }
+        std::uint32_t kept = 0;
+        while (kept < prop.decision_level()
+            && marks[~prop.trail()[prop.level_start(kept + 1)]] == stamp) {
+            ++kept;
+        }
+        counters.reused_levels += kept;
+        prop.backtrack(kept);
+
+        // decide the negations until a conflict or a true literal
+        shorter.clear();
+        bool done = false;
+        for (auto lit : lits) {
+            auto value = prop.value(lit);
+            if (value == Value::true_) {
+                if (prop.level(lit.var()) == 0) {
+                    return true; // satisfied, simplify() removes it
+                }
+                if (prop.reason(lit.var()) != ref) {
+                    collect_decisions(prop, lits);
+                    shorter.push_back(lit);
+                    done = true;
+                }
+                break;
+            } else if (value == Value::undef) {
+                prop.decide(~lit);
+                if (prop.propagate().valid()) {
+                    collect_decisions(prop, lits);
+                    prop.backtrack(prop.decision_level() - 1); // not a prefix to keep
+                    done = true;
+                    break;
+                }
+            }
+        }
+        if (!done) {
+            // the literals implied false go
+            for (auto lit : lits) {
+                if (prop.value(lit) != Value::false_ || (prop.level(lit.var()) > 0
+                    && !prop.reason(lit.var()).valid())) {
+                    shorter.push_back(lit);
+                }
+            }
+        }
+        if (shorter.size() == lits.size()) {
+            return true;
+        }
+
+        prop.backtrack(0);
+        if (prop.locked(ref)) {
+            return true;
+        }
+        ++counters.shortened;
+        counters.removed_lits += lits.size() - shorter.size();
+        if (shorter.size() == 1) {
+            ++counters.units;
+            prop.remove_clause(ref);
+            replaced(ref, ClauseRef());
+            prop.assign(shorter[0], ClauseRef());
+            return !prop.propagate().valid();
+        }
+
+        auto old = prop.arena()[ref];
+        auto learnt = old.learnt();
+        auto lbd = std::min(old.lbd(), static_cast<std::uint32_t>(shorter.size()));
+        auto activity = old.activity();
+        auto used = old.used();
+        prop.remove_clause(ref);
+        auto added = prop.add_clause(tools::Span<const mini::Lit>(shorter.data(), shorter.size()), learnt);
+        auto clause = prop.arena()[added];
+        clause.set_lbd(lbd);
+        clause.set_activity(activity);
+        clause.set_used(used);
+        clause.set_vivified(true);
+        replaced(ref, added);
+        return true;
+    }
+
+    // The clause's literals whose negations are decisions
+    void collect_decisions(const Propagator& prop, tools::Span<const mini::Lit> lits)
+    {
+        for (auto lit : lits) {
+            if (prop.value(lit) == Value::false_ && prop.level(lit.var()) > 0
+                && !prop.reason(lit.var()).valid()) {
+                shorter.push_back(lit);
+            }
+        }
+    }
+
+}; // Vivifier
+
+} // hubero
+#endif // HUBERO_VIVIFIER_H_
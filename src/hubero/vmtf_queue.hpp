@@ -0,0 +1,169 @@
+// Copyright (c) 2018 Radomír Černoch (radomir.cernoch@gmail.com)
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_VMTF_QUEUE_H_
+#define HUBERO_VMTF_QUEUE_H_
+
+#include <hubero/core.hpp>
+#include <hubero/maps.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace hubero {
+
+// Variable-move-to-front queue: a doubly-linked list of variables, the
+// most recently bumped one last.
+//
+// Every move stamps the variable with a growing timestamp, so the list is
+// sorted by stamps and "was moved after" is one comparison. The search
+// cursor points at the last variable which may be unassigned, everything
+// after it is assigned, so the next decision is found by walking back from
+// the cursor and the walk is amortized over the search.
+template<class V>
+class VmtfQueue {
+
+    static const std::uint32_t none = std::numeric_limits<std::uint32_t>::max();
+
+    struct Link {
+        std::uint32_t prev;
+        std::uint32_t next;
+        std::uint64_t stamp;
+    };
+
+    VarMap<Link> links;
+    std::uint32_t first;
+    std::uint32_t last;
+    std::uint32_t cursor;
+    std::uint64_t clock;
+
+public:
+
+    VmtfQueue() : first(none), last(none), cursor(none), clock(0) {}
+
+    // Makes room for the variables up to max_var (they are not enqueued)
+    void grow_to(V max_var)
+    {
+        links.grow_to(max_var, Link{none, none, 0});
+    }
+
+    bool empty() const
+    {
+        return first == none;
+    }
+
+    // Whether the variable is in the queue
+    bool contains(V var) const
+    {
+        return links.contains(var) && links[var].stamp != 0;
+    }
+
+    // The variable's timestamp, later moves have larger ones
+    std::uint64_t stamp(V var) const
+    {
+        return links[var].stamp;
+    }
+
+    // Appends a new variable to the end (as the most recent)
+    void enqueue(V var)
+    {
+        assert(!contains(var) && "The variable is queued already");
+        grow_to(var);
+        append(index(var));
+        cursor = index(var);
+    }
+
+    // Moves the variable to the end, the search cursor follows it if the
+    // variable is unassigned
+    void move_to_front(V var, bool unassigned)
+    {
+        auto i = index(var);
+        if (i != last) {
+            unlink(i);
+            append(i);
+        }
+        if (unassigned) {
+            cursor = i;
+        }
+    }
+
+    // A variable got unassigned, the cursor goes there if it is later
+    void unassigned(V var)
+    {
+        auto i = index(var);
+        if (cursor == none || links[var].stamp > links[V(cursor)].stamp) {
+            cursor = i;
+        }
+    }
+
+    // The most recent variable which the predicate accepts (e.g. is
+    // unassigned), or V(0), so variable 0 should not be queued. Variables
+    // passed by the walk must stay rejected until they are unassigned().
+    template<class F>
+    V next(F accept)
+    {
+        while (cursor != none && !accept(V(cursor))) {
+            cursor = links[V(cursor)].prev;
+        }
+        return cursor == none ? V(0) : V(cursor);
+    }
+
+    // Calls f(var) from the oldest variable to the most recent one
+    template<class F>
+    void for_each(F f) const
+    {
+        for (auto i = first; i != none; i = links[V(i)].next) {
+            f(V(i));
+        }
+    }
+
+private:
+
+    static std::uint32_t index(V var)
+    {
+        return static_cast<std::uint32_t>(var);
+    }
+
+    void append(std::uint32_t i)
+    {
+        auto& link = links[V(i)];
+        link.prev = last;
+        link.next = none;
+        link.stamp = ++clock;
+        if (last == none) {
+            first = i;
+        } else {
+            links[V(last)].next = i;
+        }
+        last = i;
+    }
+
+    void unlink(std::uint32_t i)
+    {
+        auto& link = links[V(i)];
+        if (link.prev == none) {
+            first = link.next;
+        } else {
+            links[V(link.prev)].next = link.next;
+        }
+        if (link.next == none) {
+            last = link.prev;
+        } else {
+            links[V(link.next)].prev = link.prev;
+        }
+        if (cursor == i) {
+            cursor = link.prev;
+        }
+    }
+
+}; // VmtfQueue
+
+template<class V>
+const std::uint32_t VmtfQueue<V>::none;
+
+} // hubero
+#endif // HUBERO_VMTF_QUEUE_H_
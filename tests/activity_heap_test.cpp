@@ -0,0 +1,95 @@
+// Copyright (c) 2018 radek
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#include <hubero/activity_heap.hpp>
+using namespace hubero;
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+TEST_CASE("ActivityHeap::order")
+{
+    ActivityHeap<Var> heap;
+    heap.grow_to(Var(10));
+    for (unsigned v = 1; v <= 10; ++v) {
+        heap.insert(Var(v));
+    }
+    heap.insert(Var(3)); // no duplicates
+    REQUIRE(heap.size() == 10);
+
+    heap.bump(Var(7));
+    heap.bump(Var(2));
+    heap.bump(Var(2));
+    REQUIRE(heap.top() == Var(2));
+    REQUIRE(heap.activity(Var(2)) == 2.0);
+
+    REQUIRE(heap.pop() == Var(2));
+    REQUIRE(!heap.contains(Var(2)));
+    REQUIRE(heap.pop() == Var(7));
+    REQUIRE(heap.size() == 8);
+
+    // bumps outside the heap count when the variable returns
+    heap.bump(Var(2));
+    heap.insert(Var(2));
+    REQUIRE(heap.top() == Var(2));
+}
+
+TEST_CASE("ActivityHeap::decay")
+{
+    ActivityHeap<Var> heap(0.5);
+    heap.grow_to(Var(2));
+    heap.insert(Var(1));
+    heap.insert(Var(2));
+
+    heap.bump(Var(1));
+    heap.bump(Var(1));
+    heap.decay();
+    heap.decay();
+    heap.bump(Var(2)); // worth 4 of the early bumps
+    REQUIRE(heap.top() == Var(2));
+
+    // the increment overflows into a rescale, the order stays
+    for (int i = 0; i < 400; ++i) {
+        heap.decay();
+    }
+    heap.bump(Var(1));
+    REQUIRE(heap.activity(Var(1)) < 1e100);
+    REQUIRE(heap.activity(Var(1)) > heap.activity(Var(2)));
+    REQUIRE(heap.top() == Var(1));
+}
+
+TEST_CASE("ActivityHeap::random")
+{
+    std::mt19937 rng(3);
+    ActivityHeap<Var, 2> binary;
+    ActivityHeap<Var, 8> wide;
+    binary.grow_to(Var(500));
+    wide.grow_to(Var(500));
+    for (unsigned v = 1; v <= 500; ++v) {
+        binary.insert(Var(v));
+        wide.insert(Var(v));
+    }
+    for (int i = 0; i < 5000; ++i) {
+        Var var(static_cast<unsigned>(rng() % 500 + 1));
+        binary.bump(var);
+        wide.bump(var);
+        if (i % 7 == 0) {
+            binary.decay();
+            wide.decay();
+        }
+    }
+
+    double previous = 1e300;
+    while (!binary.empty()) {
+        auto var = binary.pop();
+        REQUIRE(binary.activity(var) <= previous);
+        REQUIRE(wide.activity(wide.pop()) == binary.activity(var));
+        previous = binary.activity(var);
+    }
+    REQUIRE(wide.empty());
+}
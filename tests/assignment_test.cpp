@@ -0,0 +1,111 @@
+// Copyright (c) 2018 radek
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#include <hubero/assignment.hpp>
+using namespace hubero;
+using namespace hubero::mini;
+
+#include "catch.hpp"
+
+#include <random>
+#include <vector>
+
+TEST_CASE("Assignment")
+{
+    Assignment assignment(Var(10));
+    REQUIRE(assignment.size() == 11);
+    REQUIRE(assignment.value(Var(3)) == Value::undef);
+    REQUIRE(assignment.value(Lit(Var(3), true)) == Value::undef);
+    REQUIRE(assignment.value(Lit(Var(3), false)) == Value::undef);
+    REQUIRE(!assignment.is_true(Lit(Var(3), false)));
+    REQUIRE(!assignment.is_false(Lit(Var(3), false)));
+
+    assignment.assign(Lit(Var(3), false));
+    REQUIRE(assignment.value(Var(3)) == Value::false_);
+    REQUIRE(assignment.is_true(Lit(Var(3), false)));
+    REQUIRE(assignment.is_false(Lit(Var(3), true)));
+    REQUIRE(assignment.is_assigned(Var(3)));
+
+    assignment.set(Var(4), Value::true_);
+    REQUIRE(assignment.value(Lit(Var(4), true)) == Value::true_);
+    REQUIRE(assignment.value(Lit(Var(4), false)) == Value::false_);
+    REQUIRE(assignment.value(Var(5)) == Value::undef);
+
+    assignment.unassign(Var(3));
+    REQUIRE(!assignment.is_assigned(Var(3)));
+
+    assignment.grow_to(Var(100));
+    REQUIRE(assignment.value(Var(4)) == Value::true_);
+    REQUIRE(assignment.value(Var(100)) == Value::undef);
+
+    assignment.clear();
+    REQUIRE(assignment.value(Var(4)) == Value::undef);
+
+    REQUIRE(~Value::true_ == Value::false_);
+    REQUIRE(~Value::undef == Value::undef);
+}
+
+TEST_CASE("check_model")
+{
+    Cnf cnf;
+    cnf.add_clause({Lit(Var(1), true), Lit(Var(2), false)});
+    cnf.add_clause({Lit(Var(3), true)});
+
+    const simd::Isa isas[] = {simd::Isa::scalar, simd::Isa::avx2};
+    for (auto isa : isas) {
+        Assignment assignment(Var(3));
+        REQUIRE(find_unsatisfied(cnf, assignment, isa) == 0);
+
+        assignment.assign(Lit(Var(2), false));
+        REQUIRE(find_unsatisfied(cnf, assignment, isa) == 1);
+
+        assignment.assign(Lit(Var(3), true));
+        REQUIRE(check_model(cnf, assignment, isa));
+
+        // variables past the assignment are unassigned
+        cnf.add_clause({Lit(Var(1000), true)});
+        REQUIRE(find_unsatisfied(cnf, assignment, isa) == 2);
+        cnf.clear();
+        cnf.add_clause({Lit(Var(1), true), Lit(Var(2), false)});
+        cnf.add_clause({Lit(Var(3), true)});
+
+        REQUIRE(check_model(Cnf(), Assignment(), isa));
+    }
+}
+
+TEST_CASE("check_model::random")
+{
+    // the vectorized and the scalar version agree, on long and short clauses
+    std::mt19937 rng(7);
+    const unsigned vars = 500;
+
+    for (int round = 0; round < 20; ++round) {
+        Assignment model(Var(vars - 10)); // the last variables are unassigned
+        for (unsigned v = 1; v < vars - 10; ++v) {
+            if (rng() % 8 != 0) {
+                model.assign(Lit(Var(v), rng() % 2 == 0));
+            }
+        }
+
+        Cnf cnf;
+        std::vector<Lit> clause;
+        for (int c = 0; c < 3000; ++c) {
+            clause.clear();
+            auto size = c % 97 == 0 ? 5000 : rng() % 6;
+            for (unsigned i = 0; i < size; ++i) {
+                auto lit = Lit(Var(rng() % vars + 1), rng() % 2 == 0);
+                // mostly false literals, so that some clauses are unsatisfied
+                bool is_true = static_cast<std::size_t>(lit.var()) < model.size()
+                    && model.is_true(lit);
+                clause.push_back(is_true && rng() % 4 != 0 ? ~lit : lit);
+            }
+            cnf.add_clause(tools::Span<const Lit>(clause.data(), clause.size()));
+        }
+
+        auto expected = find_unsatisfied(cnf, model, simd::Isa::scalar);
+        REQUIRE(find_unsatisfied(cnf, model, simd::Isa::avx2) == expected);
+        REQUIRE(expected < cnf.num_clauses());
+    }
+}
@@ -0,0 +1,169 @@
+// Copyright (c) 2018 radek
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#include <hubero/binary_cnf.hpp>
+using namespace hubero;
+using namespace hubero::mini;
+
+#include "catch.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+Cnf sample_cnf()
+{
+    Cnf cnf;
+    cnf.set_num_vars(1000);
+    for (unsigned i = 0; i < 300; ++i) {
+        std::vector<Lit> clause;
+        for (unsigned j = 0; j < i % 5; ++j) {
+            // both increasing and decreasing codes, small and large
+            clause.push_back(Lit(Var((i * 37 + j * 501) % 1000 + 1), (i + j) % 2 == 0));
+        }
+        cnf.add_clause(tools::Span<const Lit>(clause.data(), clause.size()));
+    }
+    return cnf;
+}
+
+std::vector<Lit> to_vector(tools::Span<const Lit> clause)
+{
+    return std::vector<Lit>(clause.begin(), clause.end());
+}
+
+} // namespace
+
+TEST_CASE("binary::round_trip")
+{
+    const char* path = "binary_cnf_test.bin";
+    auto cnf = sample_cnf();
+
+    const binary::Encoding encodings[] = {binary::Encoding::raw, binary::Encoding::delta};
+    for (auto encoding : encodings) {
+        INFO("encoding = " << static_cast<int>(encoding));
+        binary::write_file(path, cnf, encoding);
+        REQUIRE(binary::is_binary_file(path));
+
+        binary::MappedCnf mapped(path);
+        REQUIRE(mapped.encoding() == encoding);
+        REQUIRE(mapped.num_vars() == 1000);
+        REQUIRE(mapped.num_clauses() == cnf.num_clauses());
+        REQUIRE(mapped.num_lits() == cnf.num_lits());
+
+        std::size_t i = 0;
+        mapped.for_each_clause([&](tools::Span<const Lit> clause) {
+            REQUIRE(to_vector(clause) == to_vector(cnf[i]));
+            ++i;
+        });
+        REQUIRE(i == cnf.num_clauses());
+
+        std::vector<Lit> buffer;
+        for (std::size_t j = 0; j < cnf.num_clauses(); j += 7) {
+            mapped.copy_clause(j, buffer);
+            REQUIRE(buffer == to_vector(cnf[j]));
+        }
+
+        auto copy = mapped.to_cnf();
+        REQUIRE(copy.num_lits() == cnf.num_lits());
+        REQUIRE(to_vector(copy[299]) == to_vector(cnf[299]));
+    }
+    std::remove(path);
+}
+
+TEST_CASE("binary::large_variables")
+{
+    // codes far apart, their differences need more than 32 bits
+    const unsigned max_var = (1u << 31) - 1;
+    Cnf cnf;
+    cnf.set_num_vars(max_var);
+    cnf.add_clause({Lit(Var(1), true), Lit(Var(max_var), false), Lit(Var(2), true)});
+    cnf.add_clause({Lit(Var(max_var), true), Lit(Var(1500000000), false), Lit(Var(1), false)});
+
+    const char* path = "binary_cnf_test_large.bin";
+    const binary::Encoding encodings[] = {binary::Encoding::raw, binary::Encoding::delta};
+    for (auto encoding : encodings) {
+        binary::write_file(path, cnf, encoding);
+        auto copy = binary::MappedCnf(path).to_cnf();
+        REQUIRE(copy.num_vars() == max_var);
+        REQUIRE(to_vector(copy[0]) == to_vector(cnf[0]));
+        REQUIRE(to_vector(copy[1]) == to_vector(cnf[1]));
+    }
+    std::remove(path);
+}
+
+TEST_CASE("binary::zero_copy")
+{
+    const char* path = "binary_cnf_test_raw.bin";
+    auto cnf = sample_cnf();
+    binary::write_file(path, cnf, binary::Encoding::raw);
+    {
+        binary::MappedCnf mapped(path);
+        auto first = mapped.clause(1);
+        auto second = mapped.clause(2);
+        REQUIRE(first.size() == 1);
+        REQUIRE(first.end() == second.begin()); // the literals are in place
+        REQUIRE(reinterpret_cast<std::uintptr_t>(first.data()) % alignof(Lit) == 0);
+    }
+    {
+        binary::write_file(path, cnf, binary::Encoding::delta);
+        binary::MappedCnf mapped(path);
+        REQUIRE_THROWS_AS(mapped.clause(1), std::logic_error);
+    }
+    std::remove(path);
+}
+
+TEST_CASE("binary::empty")
+{
+    const char* path = "binary_cnf_test_empty.bin";
+    binary::write_file(path, Cnf(), binary::Encoding::delta);
+    binary::MappedCnf mapped(path);
+    REQUIRE(mapped.num_clauses() == 0);
+    REQUIRE(mapped.to_cnf().empty());
+    std::remove(path);
+}
+
+TEST_CASE("binary::invalid_files")
+{
+    const char* path = "binary_cnf_test_invalid.bin";
+    {
+        std::ofstream out(path);
+        out << "p cnf 1 1\n1 0\n";
+    }
+    REQUIRE(!binary::is_binary_file(path));
+    REQUIRE_THROWS_AS(binary::MappedCnf(path), binary::FormatError);
+
+    // truncated
+    binary::write_file(path, sample_cnf(), binary::Encoding::raw);
+    std::string content;
+    {
+        std::ifstream in(path, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(content.data(), static_cast<std::streamsize>(content.size() - 4));
+    }
+    REQUIRE_THROWS_AS(binary::MappedCnf(path), binary::FormatError);
+
+    // the index reaches past the file, the data size wraps around to match
+    {
+        binary::Header hdr;
+        std::memcpy(&hdr, content.data(), sizeof(hdr));
+        hdr.num_clauses = content.size();
+        hdr.data_size = content.size() - binary::detail::data_offset(hdr);
+        std::string crafted = content;
+        std::memcpy(&crafted[0], &hdr, sizeof(hdr));
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(crafted.data(), static_cast<std::streamsize>(crafted.size()));
+    }
+    REQUIRE_THROWS_AS(binary::MappedCnf(path), binary::FormatError);
+
+    std::remove(path);
+}
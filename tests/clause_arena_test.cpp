@@ -0,0 +1,135 @@
+// Copyright (c) 2018 radek
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#include <hubero/clause_arena.hpp>
+#include "test_helpers.hpp"
+using namespace hubero;
+using namespace hubero::test;
+using namespace hubero::mini;
+
+#include "catch.hpp"
+
+#include <vector>
+
+namespace {
+
+std::vector<Lit> lits_of(const ClauseArena& arena, ClauseRef ref)
+{
+    auto clause = arena[ref];
+    return std::vector<Lit>(clause.begin(), clause.end());
+}
+
+} // namespace
+
+TEST_CASE("ClauseArena::alloc")
+{
+    ClauseArena arena;
+    auto a = arena.alloc({lit(1), lit(-2), lit(3)});
+    auto b = arena.alloc({lit(-4)}, true);
+    auto empty = arena.alloc({});
+
+    REQUIRE(a.index() == 0);
+    REQUIRE(b.index() == 6);
+    REQUIRE(arena.size() == 6 + 4 + 3);
+    REQUIRE(arena.num_clauses() == 3);
+
+    REQUIRE(lits_of(arena, a) == std::vector<Lit>{lit(1), lit(-2), lit(3)});
+    REQUIRE(arena[a][1] == lit(-2));
+    REQUIRE(!arena[a].learnt());
+    REQUIRE(arena[b].learnt());
+    REQUIRE(arena[empty].size() == 0);
+
+    REQUIRE(!ClauseRef().valid());
+    REQUIRE(a.valid());
+}
+
+TEST_CASE("ClauseArena::header")
+{
+    ClauseArena arena;
+    auto ref = arena.alloc({lit(1), lit(2)}, true);
+    auto clause = arena[ref];
+
+    REQUIRE(clause.lbd() == 0);
+    REQUIRE(clause.activity() == 0.0f);
+
+    clause.set_lbd(7);
+    clause.set_activity(2.5f);
+    clause.set_used(true);
+    REQUIRE(clause.lbd() == 7);
+    REQUIRE(clause.activity() == 2.5f);
+    REQUIRE(clause.used());
+    REQUIRE(clause.learnt());
+
+    clause.set_used(3);
+    REQUIRE(clause.used() == 3);
+    clause.set_used(100); // saturates
+    REQUIRE(clause.used() == 31);
+    REQUIRE(clause.learnt());
+    clause.set_used(0);
+    REQUIRE(!clause.used());
+    REQUIRE(clause.lbd() == 7);
+
+    clause.set_lbd(1u << 30); // saturates
+    REQUIRE(clause.lbd() == 0xFFFFFFu);
+    REQUIRE(clause.learnt());
+
+    clause[0] = lit(-5);
+    REQUIRE(arena[ref][0] == lit(-5));
+}
+
+TEST_CASE("ClauseArena::collect")
+{
+    ClauseArena arena;
+    std::vector<ClauseRef> refs;
+    for (int i = 1; i <= 100; ++i) {
+        refs.push_back(arena.alloc({lit(i), lit(-(i + 1)), lit(i + 2)}, i % 2 == 0));
+        arena[refs.back()].set_lbd(static_cast<std::uint32_t>(i));
+    }
+
+    // free every third clause, shrink every fifth one
+    for (int i = 0; i < 100; ++i) {
+        if (i % 3 == 0) {
+            arena.free(refs[i]);
+        } else if (i % 5 == 0) {
+            arena.shrink(refs[i], 1);
+        }
+    }
+    REQUIRE(arena.num_clauses() == 66);
+    REQUIRE(arena.wasted_words() == 34 * 6 + 13 * 2);
+
+    std::vector<ClauseRef> seen;
+    arena.for_each_clause([&](ClauseRef ref) { seen.push_back(ref); });
+    REQUIRE(seen.size() == 66);
+
+    auto old_size = arena.size();
+    auto moved = arena.collect();
+    REQUIRE(moved.size() == 66);
+    REQUIRE(arena.size() == old_size - 34 * 6 - 13 * 2);
+    REQUIRE(arena.wasted_words() == 0);
+
+    for (int i = 0; i < 100; ++i) {
+        auto ref = moved(refs[i]);
+        if (i % 3 == 0) {
+            REQUIRE(!ref.valid());
+            continue;
+        }
+        REQUIRE(ref.valid());
+        auto clause = arena[ref];
+        REQUIRE(clause.lbd() == static_cast<std::uint32_t>(i + 1));
+        REQUIRE(clause.learnt() == ((i + 1) % 2 == 0));
+        REQUIRE(clause[0] == lit(i + 1));
+        REQUIRE(clause.size() == (i % 5 == 0 ? 1u : 3u));
+    }
+
+    // the order is kept
+    seen.clear();
+    arena.for_each_clause([&](ClauseRef ref) { seen.push_back(ref); });
+    REQUIRE(seen.front() == ClauseRef(0));
+    REQUIRE(arena[seen[0]][0] == lit(2));
+
+    // allocation continues after the compacted clauses
+    auto ref = arena.alloc({lit(7)});
+    REQUIRE(ref.index() == old_size - 34 * 6 - 13 * 2);
+}
@@ -0,0 +1,131 @@
+// Copyright (c) 2018 radek
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#include <hubero/clause_ring.hpp>
+using namespace hubero;
+
+#include "catch.hpp"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::vector<mini::Lit> lits(std::initializer_list<unsigned> ids)
+{
+    std::vector<mini::Lit> result;
+    for (auto id : ids) {
+        result.push_back(mini::Lit(id));
+    }
+    return result;
+}
+
+bool push(ClauseRing& ring, std::uint32_t source, const std::vector<mini::Lit>& clause,
+    std::uint32_t lbd)
+{
+    return ring.push(source, tools::Span<const mini::Lit>(clause.data(), clause.size()), lbd);
+}
+
+} // namespace
+
+TEST_CASE("ClauseRing::broadcast")
+{
+    ClauseRing ring(100);
+    REQUIRE(ring.capacity() == 128);
+
+    auto early = ring.cursor();
+    REQUIRE(push(ring, 1, lits({2, 5, 7}), 2));
+    auto late = ring.cursor();
+    REQUIRE(push(ring, 3, lits({4, 9}), 300));
+    REQUIRE(ring.written() == 7);
+
+    SharedClause clause;
+    REQUIRE(ring.pop(early, clause));
+    REQUIRE(clause.source == 1);
+    REQUIRE(clause.lbd == 2);
+    REQUIRE(clause.lits == lits({2, 5, 7}));
+    REQUIRE(ring.pop(early, clause));
+    REQUIRE(clause.source == 3);
+    REQUIRE(clause.lbd == max_shared_lbd);
+    REQUIRE(!ring.pop(early, clause));
+
+    // every reader gets every clause published after its cursor
+    REQUIRE(ring.pop(late, clause));
+    REQUIRE(clause.lits == lits({4, 9}));
+    REQUIRE(!ring.pop(late, clause));
+
+    REQUIRE(!push(ring, 1, lits({}), 1));
+    REQUIRE(!push(ring, max_shared_source + 1, lits({2, 4}), 1));
+    REQUIRE(!push(ring, 1, std::vector<mini::Lit>(33, mini::Lit(2)), 1));
+}
+
+TEST_CASE("ClauseRing::overrun")
+{
+    ClauseRing ring(64);
+    auto slow = ring.cursor();
+    for (unsigned i = 0; i < 40; ++i) {
+        REQUIRE(push(ring, 0, lits({2 * i, 2 * i + 3}), 2));
+    }
+
+    // the slow reader lost the overwritten clauses and continues after them
+    SharedClause clause;
+    REQUIRE(!ring.pop(slow, clause));
+    REQUIRE(slow.skipped_words() == 120);
+    REQUIRE(push(ring, 0, lits({6, 8}), 2));
+    REQUIRE(ring.pop(slow, clause));
+    REQUIRE(clause.lits == lits({6, 8}));
+
+    // wrapping around the end of the ring several times
+    auto reader = ring.cursor();
+    for (unsigned i = 0; i < 100; ++i) {
+        REQUIRE(push(ring, 0, lits({i, i + 1, i + 2, i + 3, i + 4}), 3));
+        REQUIRE(ring.pop(reader, clause));
+        REQUIRE(clause.lits == lits({i, i + 1, i + 2, i + 3, i + 4}));
+    }
+    REQUIRE(reader.skipped_words() == 0);
+}
+
+TEST_CASE("ClauseRing::threads")
+{
+    // the readers see each producer's clauses intact and in order
+    const unsigned producers = 4;
+    const unsigned count = 5000;
+    ClauseRing ring(1 << 10);
+
+    std::vector<std::uint64_t> received(producers, 0);
+    std::vector<std::uint64_t> skipped(producers, 0);
+    std::vector<int> ordered(producers, 1);
+    std::vector<std::thread> threads;
+    for (unsigned p = 0; p < producers; ++p) {
+        threads.emplace_back([&ring, &received, &skipped, &ordered, p, producers, count]() {
+            auto cursor = ring.cursor();
+            std::vector<std::uint32_t> last(producers, 0);
+            SharedClause clause;
+            for (unsigned i = 1; i <= count; ++i) {
+                auto size = 1 + i % 5;
+                std::vector<mini::Lit> sent(size, mini::Lit(i));
+                ring.push(p, tools::Span<const mini::Lit>(sent.data(), sent.size()), i % 7);
+                while (ring.pop(cursor, clause)) {
+                    auto id = static_cast<std::uint32_t>(clause.lits[0]);
+                    ordered[p] = ordered[p] && id > last[clause.source]
+                        && clause.lits.size() == 1 + id % 5 && clause.lbd == id % 7
+                        && clause.lits == std::vector<mini::Lit>(clause.lits.size(), clause.lits[0]);
+                    last[clause.source] = id;
+                    ++received[p];
+                }
+            }
+            skipped[p] = cursor.skipped_words();
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    REQUIRE(ring.written() == producers * count * 4);
+    for (unsigned p = 0; p < producers; ++p) {
+        REQUIRE(ordered[p]);
+        REQUIRE(received[p] > 0);
+    }
+}
@@ -0,0 +1,64 @@
+// Copyright (c) 2018 radek
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#include <hubero/cnf.hpp>
+using namespace hubero;
+using namespace hubero::mini;
+
+#include "catch.hpp"
+
+TEST_CASE("Cnf::add_clause")
+{
+    Cnf cnf;
+    REQUIRE(cnf.empty());
+
+    cnf.add_clause({Lit(Var(1), true), Lit(Var(2), false)});
+    cnf.add_clause({});
+    cnf.add_clause({Lit(Var(3), true)});
+
+    REQUIRE(cnf.num_clauses() == 3);
+    REQUIRE(cnf.num_lits() == 3);
+    REQUIRE(cnf[0].size() == 2);
+    REQUIRE(cnf[0][1] == Lit(Var(2), false));
+    REQUIRE(cnf[1].empty());
+    REQUIRE(cnf[2].front() == Lit(Var(3), true));
+}
+
+TEST_CASE("Cnf::append")
+{
+    Cnf first;
+    first.set_num_vars(2);
+    first.add_clause({Lit(Var(1), true)});
+
+    Cnf second;
+    second.set_num_vars(5);
+    second.add_clause({Lit(Var(4), true), Lit(Var(5), true)});
+    second.add_clause({Lit(Var(2), false)});
+
+    first.append(second);
+    REQUIRE(first.num_clauses() == 3);
+    REQUIRE(first.num_vars() == 5);
+    REQUIRE(first[1].size() == 2);
+    REQUIRE(first[2][0] == Lit(Var(2), false));
+}
+
+TEST_CASE("Cnf::iteration")
+{
+    Cnf cnf;
+    cnf.add_clause({Lit(Var(1), true)});
+    cnf.add_clause({Lit(Var(1), false), Lit(Var(2), true)});
+
+    std::size_t clauses = 0;
+    std::size_t lits = 0;
+    for (auto clause : cnf) {
+        ++clauses;
+        lits += clause.size();
+    }
+    REQUIRE(clauses == 2);
+    REQUIRE(lits == 3);
+
+    cnf.clear();
+    REQUIRE(cnf.begin() == cnf.end());
+}
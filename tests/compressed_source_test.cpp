@@ -0,0 +1,241 @@
+// Copyright (c) 2018 radek
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#include <hubero/compressed_source.hpp>
+#include <hubero/dimacs_loader.hpp>
+using namespace hubero;
+using namespace hubero::dimacs;
+
+#include "catch.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string sample_cnf(int clauses)
+{
+    std::string text = "c generated\np cnf 1000 " + std::to_string(clauses) + "\n";
+    for (int i = 0; i < clauses; ++i) {
+        text += std::to_string(i % 1000 + 1) + " -" + std::to_string((i * 7) % 1000 + 1);
+        if (i % 100 == 0) {
+            // longer than a small block
+            for (int j = 1; j <= 200; ++j) {
+                text += " " + std::to_string(j);
+            }
+        }
+        text += i % 3 == 0 ? " 0\n" : " 0 ";
+    }
+    return text;
+}
+
+void write_file(const std::string& path, const std::string& content)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(content.data(), static_cast<std::streamsize>(content.size()));
+}
+
+#ifdef HUBERO_HAVE_ZLIB
+std::string gzip(const std::string& text)
+{
+    z_stream zs;
+    std::memset(&zs, 0, sizeof(zs));
+    deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+
+    std::string out(deflateBound(&zs, static_cast<uLong>(text.size())) + 32, '\0');
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(text.data()));
+    zs.avail_in = static_cast<uInt>(text.size());
+    zs.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    zs.avail_out = static_cast<uInt>(out.size());
+    deflate(&zs, Z_FINISH);
+    out.resize(zs.total_out);
+    deflateEnd(&zs);
+    return out;
+}
+#endif
+
+#ifdef HUBERO_HAVE_LZMA
+std::string xz(const std::string& text)
+{
+    std::string out(lzma_stream_buffer_bound(text.size()), '\0');
+    std::size_t size = 0;
+    lzma_easy_buffer_encode(6, LZMA_CHECK_CRC64, nullptr,
+        reinterpret_cast<const std::uint8_t*>(text.data()), text.size(),
+        reinterpret_cast<std::uint8_t*>(&out[0]), &size, out.size());
+    out.resize(size);
+    return out;
+}
+#endif
+
+std::vector<std::vector<int>> read_clauses(CompressedReader<LitT<int>>& reader)
+{
+    std::vector<std::vector<int>> clauses;
+    while (reader.next_clause()) {
+        std::vector<int> clause;
+        for (auto lit : reader.clause()) {
+            clause.push_back(static_cast<int>(lit));
+        }
+        clauses.push_back(clause);
+    }
+    return clauses;
+}
+
+std::vector<std::vector<int>> read_clauses(const std::string& text)
+{
+    BufferReader<LitT<int>> reader{BufferSource(text)};
+    std::vector<std::vector<int>> clauses;
+    while (reader.next_clause()) {
+        std::vector<int> clause;
+        for (auto lit : reader.clause()) {
+            clause.push_back(static_cast<int>(lit));
+        }
+        clauses.push_back(clause);
+    }
+    return clauses;
+}
+
+// Reads the compressed file with several block sizes
+void check_compressed(const std::string& path, const std::string& text)
+{
+    auto expected = read_clauses(text);
+    const std::size_t block_sizes[] = {1, 64, 4096, decompress_block_size};
+    for (auto block_size : block_sizes) {
+        INFO("block size " << block_size);
+        auto reader = open_compressed<LitT<int>>(path, block_size);
+        REQUIRE(reader.header().num_clauses == expected.size());
+        REQUIRE(read_clauses(reader) == expected);
+    }
+
+    auto cnf = read_file<mini::Lit>(path);
+    REQUIRE(cnf.num_clauses() == expected.size());
+}
+
+} // namespace
+
+TEST_CASE("dimacs::detect_compression")
+{
+    const unsigned char gz[] = {0x1F, 0x8B, 0x08};
+    const unsigned char xz[] = {0xFD, '7', 'z', 'X', 'Z', 0x00};
+    const unsigned char zst[] = {0x28, 0xB5, 0x2F, 0xFD};
+    const unsigned char text[] = {'p', ' ', 'c', 'n', 'f'};
+
+    REQUIRE(detect_compression(gz, sizeof(gz)) == Compression::gzip);
+    REQUIRE(detect_compression(xz, sizeof(xz)) == Compression::xz);
+    REQUIRE(detect_compression(xz, 3) == Compression::none);
+    REQUIRE(detect_compression(zst, sizeof(zst)) == Compression::zstd);
+    REQUIRE(detect_compression(text, sizeof(text)) == Compression::none);
+    REQUIRE(detect_compression(text, 0) == Compression::none);
+    REQUIRE(is_supported(Compression::none));
+
+    const char* path = "compressed_source_test_plain.cnf";
+    write_file(path, "p cnf 1 1\n1 0\n");
+    REQUIRE(detect_compression(path) == Compression::none);
+    std::remove(path);
+}
+
+TEST_CASE("dimacs::unsupported_compression")
+{
+    const char* path = "compressed_source_test_unsupported.cnf";
+    const Compression compressions[] = {Compression::gzip, Compression::xz, Compression::zstd};
+    const char* magics[] = {"\x1F\x8B", "\xFD" "7zXZ", "\x28\xB5\x2F\xFD"};
+
+    for (int i = 0; i < 3; ++i) {
+        if (!is_supported(compressions[i])) {
+            write_file(path, std::string(magics[i]) + "garbage");
+            REQUIRE_THROWS_AS(open_compressed<mini::Lit>(path), DecompressionError);
+        }
+    }
+    std::remove(path);
+}
+
+#ifdef HUBERO_HAVE_ZLIB
+TEST_CASE("dimacs::gzip_source")
+{
+    const char* path = "compressed_source_test.cnf.gz";
+    auto text = sample_cnf(3000);
+    write_file(path, gzip(text));
+    check_compressed(path, text);
+
+    // concatenated members
+    auto half = text.find('\n', text.size() / 2) + 1;
+    write_file(path, gzip(text.substr(0, half)) + gzip(text.substr(half)));
+    check_compressed(path, text);
+
+    // an empty file
+    write_file(path, gzip(""));
+    auto reader = open_compressed<mini::Lit>(path);
+    REQUIRE(!reader.next_clause());
+
+    std::remove(path);
+}
+
+TEST_CASE("dimacs::gzip_errors")
+{
+    const char* path = "compressed_source_test_broken.cnf.gz";
+    auto data = gzip(sample_cnf(3000));
+
+    write_file(path, data.substr(0, data.size() / 2));
+    {
+        auto reader = open_compressed<mini::Lit>(path, 256);
+        REQUIRE_THROWS_AS(read_all(reader), DecompressionError);
+    }
+
+    data[data.size() / 2] ^= 0x55;
+    write_file(path, data);
+    {
+        auto reader = open_compressed<mini::Lit>(path, 256);
+        REQUIRE_THROWS_AS(read_all(reader), DecompressionError);
+    }
+
+    // parse errors keep their line numbers
+    write_file(path, gzip("p cnf 2 2\n1 2 0\n\n1 x 0\n"));
+    {
+        auto reader = open_compressed<mini::Lit>(path, 1);
+        REQUIRE(reader.next_clause());
+        try {
+            reader.next_clause();
+            FAIL("no error");
+        } catch (const ParseError& error) {
+            REQUIRE(error.line() == 4);
+        }
+    }
+
+    std::remove(path);
+}
+
+TEST_CASE("dimacs::abandoned_source")
+{
+    // the worker thread must stop when the reader is destroyed early
+    const char* path = "compressed_source_test_abandoned.cnf.gz";
+    write_file(path, gzip(sample_cnf(20000)));
+    {
+        auto reader = open_compressed<mini::Lit>(path, 64);
+        REQUIRE(reader.next_clause());
+    }
+    {
+        auto reader = open_compressed<mini::Lit>(path, 64);
+    }
+    std::remove(path);
+}
+#endif
+
+#ifdef HUBERO_HAVE_LZMA
+TEST_CASE("dimacs::xz_source")
+{
+    const char* path = "compressed_source_test.cnf.xz";
+    auto text = sample_cnf(3000);
+    write_file(path, xz(text));
+    check_compressed(path, text);
+
+    auto data = xz(text);
+    write_file(path, data.substr(0, data.size() - 10));
+    auto reader = open_compressed<mini::Lit>(path, 256);
+    REQUIRE_THROWS_AS(read_all(reader), DecompressionError);
+
+    std::remove(path);
+}
+#endif
@@ -291,3 +291,22 @@ TEST_CASE("dimacs::Lit::to_string")
     REQUIRE(Lit(Var(31), true).to_string() == "31");
     REQUIRE(Lit(Var(31), false).to_string() == "-31");
 }
+
+TEST_CASE("dimacs::Lit::to_chars")
+{
+    char buffer[Lit::max_chars()];
+    auto end = buffer + sizeof(buffer);
+
+    auto result = Lit(-10203).to_chars(buffer, end);
+    REQUIRE(result.ec == std::errc());
+    REQUIRE(std::string(buffer, result.ptr) == "-10203");
+
+    result = Lit(7).to_chars(buffer, end);
+    REQUIRE(std::string(buffer, result.ptr) == "7");
+
+    auto max = std::numeric_limits<int>::max();
+    REQUIRE(Lit(max).to_string() == std::to_string(max));
+    REQUIRE(Lit(-max).to_string() == std::to_string(-max));
+
+    REQUIRE(Lit(-10203).to_chars(buffer, buffer + 5).ec == std::errc::value_too_large);
+}
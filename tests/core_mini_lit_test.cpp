@@ -290,3 +290,24 @@ TEST_CASE("mini::Lit::to_string")
     REQUIRE(Lit(Var(31), true).to_string() == "31");
     REQUIRE(Lit(Var(31), false).to_string() == "-31");
 }
+
+TEST_CASE("mini::Lit::to_chars")
+{
+    char buffer[Lit::max_chars()];
+    auto end = buffer + sizeof(buffer);
+
+    auto result = Lit(Var(905), false).to_chars(buffer, end);
+    REQUIRE(result.ec == std::errc());
+    REQUIRE(std::string(buffer, result.ptr) == "-905");
+
+    result = Lit(Var(905), true).to_chars(buffer, end);
+    REQUIRE(std::string(buffer, result.ptr) == "905");
+
+    auto max = std::numeric_limits<unsigned>::max() / 4;
+    REQUIRE(Lit(Var(max), false).to_string() == "-" + std::to_string(max));
+
+    REQUIRE(Lit(Var(905), false).to_chars(buffer, buffer + 3).ec
+        == std::errc::value_too_large);
+    REQUIRE(Lit(Var(905), false).to_chars(buffer, buffer).ec
+        == std::errc::value_too_large);
+}
@@ -264,3 +264,19 @@ TEST_CASE("Var::to_string")
     REQUIRE(Var(1).to_string() == "1");
     REQUIRE(Var(31).to_string() == "31");
 }
+
+TEST_CASE("Var::to_chars")
+{
+    char buffer[Var::max_chars()];
+    auto end = buffer + sizeof(buffer);
+
+    auto result = Var(1234567u).to_chars(buffer, end);
+    REQUIRE(result.ec == std::errc());
+    REQUIRE(std::string(buffer, result.ptr) == "1234567");
+
+    auto max = std::numeric_limits<unsigned>::max() / 2;
+    REQUIRE(Var(max).to_string() == std::to_string(max));
+
+    result = Var(1234567u).to_chars(buffer, buffer + 6);
+    REQUIRE(result.ec == std::errc::value_too_large);
+}
@@ -0,0 +1,92 @@
+// Copyright (c) 2018 radek
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#include <hubero/cube_and_conquer.hpp>
+#include "test_helpers.hpp"
+using namespace hubero;
+using namespace hubero::test;
+
+#include "catch.hpp"
+
+#include <cstdint>
+#include <vector>
+
+TEST_CASE("CubeQueue")
+{
+    CubeQueue queue;
+    queue.push(Cube{mini::Lit(2)}, 10);
+    queue.push(Cube{mini::Lit(3)}, 20);
+    REQUIRE(queue.size() == 2);
+
+    Cube cube;
+    std::uint64_t limit = 0;
+    REQUIRE(queue.steal(cube, limit));
+    REQUIRE(cube == Cube{mini::Lit(2)});
+    REQUIRE(limit == 10);
+    REQUIRE(queue.pop(cube, limit));
+    REQUIRE(cube == Cube{mini::Lit(3)});
+    REQUIRE(!queue.pop(cube, limit));
+    REQUIRE(!queue.steal(cube, limit));
+}
+
+TEST_CASE("CubeAndConquer::answers")
+{
+    for (unsigned threads : {1u, 3u}) {
+        int sat = 0;
+        for (std::uint32_t seed = 1; seed <= 10; ++seed) {
+            auto cnf = random_3sat(60, 256, seed);
+            Solver reference;
+            reference.add_cnf(cnf);
+            auto expected = reference.solve();
+
+            CubeOptions options;
+            options.threads = threads;
+            options.cube_conflicts = 20; // force re-splitting
+            CubeAndConquer solver(options);
+            auto result = solver.solve(cnf);
+            REQUIRE(result == expected);
+            if (result == Result::sat) {
+                REQUIRE(satisfies(solver.model(), cnf));
+                ++sat;
+            }
+
+            std::uint64_t cubes = 0;
+            std::uint64_t refuted = 0;
+            for (const auto& worker : solver.worker_stats()) {
+                cubes += worker.cubes;
+                refuted += worker.refuted;
+                REQUIRE(worker.splits <= worker.cubes);
+            }
+            REQUIRE(solver.worker_stats().size() == threads);
+            // lookahead may refute all the initial cubes by itself
+            if (result == Result::sat) {
+                REQUIRE(solver.num_initial_cubes() > 0);
+            } else {
+                // every initial cube ends in refuted ones
+                REQUIRE(refuted >= solver.num_initial_cubes());
+                REQUIRE(cubes >= solver.num_initial_cubes());
+            }
+            REQUIRE(solver.load_imbalance() >= 1.0);
+            REQUIRE(solver.load_imbalance() <= threads + 1e-9);
+        }
+        REQUIRE(sat > 0);
+        REQUIRE(sat < 10);
+    }
+}
+
+TEST_CASE("CubeAndConquer::trivial")
+{
+    Cnf contradiction;
+    contradiction.add_clause({mini::Lit(2)});
+    contradiction.add_clause({mini::Lit(3)});
+    CubeOptions options;
+    options.threads = 2;
+    CubeAndConquer solver(options);
+    REQUIRE(solver.solve(contradiction) == Result::unsat);
+    REQUIRE(solver.num_initial_cubes() == 0);
+
+    Cnf empty;
+    REQUIRE(solver.solve(empty) == Result::sat);
+}
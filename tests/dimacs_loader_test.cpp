@@ -0,0 +1,129 @@
+// Copyright (c) 2018 radek
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#include <hubero/dimacs_loader.hpp>
+using namespace hubero;
+
+#include "catch.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// clauses spanning lines, comments containing " 0 ", several clauses per line
+std::string tricky_cnf(int clauses)
+{
+    std::string text = "c generated\np cnf 50 " + std::to_string(clauses) + "\n";
+    for (int i = 0; i < clauses; ++i) {
+        auto a = i % 50 + 1;
+        auto b = (i * 3) % 50 + 1;
+        auto c = (i * 7) % 50 + 1;
+        switch (i % 4) {
+            case 0: text += std::to_string(a) + " -" + std::to_string(b) + " 0\n"; break;
+            case 1: text += std::to_string(-a) + "\n" + std::to_string(c) + " 0 "; break;
+            case 2: text += std::to_string(b) + " 0\nc a comment 1 0 2 0\n"; break;
+            case 3: text += "  " + std::to_string(c) + "\t-" + std::to_string(a)
+                + " " + std::to_string(b) + " 0\n"; break;
+        }
+    }
+    return text;
+}
+
+} // namespace
+
+TEST_CASE("dimacs::read_all")
+{
+    auto text = tricky_cnf(40);
+    dimacs::BufferReader<mini::Lit> reader{dimacs::BufferSource(text)};
+    auto cnf = dimacs::read_all(reader);
+    REQUIRE(cnf.num_clauses() == 40);
+    REQUIRE(cnf.num_vars() == 50);
+    REQUIRE(cnf[1].size() == 2);
+    REQUIRE(cnf[3].size() == 3);
+}
+
+TEST_CASE("dimacs::parse_parallel")
+{
+    auto text = tricky_cnf(997);
+    dimacs::BufferReader<mini::Lit> reader{dimacs::BufferSource(text)};
+    auto expected = dimacs::read_all(reader);
+
+    for (unsigned threads = 1; threads <= 16; ++threads) {
+        INFO("threads = " << threads);
+        auto cnf = dimacs::parse_parallel<mini::Lit>(
+            text.data(), text.data() + text.size(), threads, 64);
+        REQUIRE(cnf.num_vars() == 50);
+        REQUIRE(cnf.num_clauses() == expected.num_clauses());
+        for (std::size_t i = 0; i < cnf.num_clauses(); ++i) {
+            REQUIRE(std::vector<mini::Lit>(cnf[i].begin(), cnf[i].end())
+                == std::vector<mini::Lit>(expected[i].begin(), expected[i].end()));
+        }
+    }
+}
+
+TEST_CASE("dimacs::parse_parallel::end_marker")
+{
+    std::string text = "p cnf 2 3\n";
+    for (int i = 0; i < 100; ++i) {
+        text += "1 2 0\n";
+    }
+    text += "%\n0\n\n";
+
+    for (unsigned threads = 1; threads <= 8; ++threads) {
+        auto cnf = dimacs::parse_parallel<dimacs::Lit>(
+            text.data(), text.data() + text.size(), threads, 16);
+        REQUIRE(cnf.num_clauses() == 100);
+    }
+}
+
+TEST_CASE("dimacs::parse_parallel::errors")
+{
+    auto text = tricky_cnf(500) + "1 2 x 0\n";
+    auto last_line = static_cast<std::size_t>(
+        std::count(text.begin(), text.end(), '\n'));
+
+    for (unsigned threads = 1; threads <= 8; ++threads) {
+        INFO("threads = " << threads);
+        try {
+            dimacs::parse_parallel<mini::Lit>(
+                text.data(), text.data() + text.size(), threads, 64);
+            FAIL("ParseError expected");
+        } catch (const dimacs::ParseError& error) {
+            REQUIRE(error.line() == last_line);
+        }
+    }
+
+    auto late = tricky_cnf(500) + "p cnf 1 1\n";
+    REQUIRE_THROWS_AS(dimacs::parse_parallel<mini::Lit>(
+        late.data(), late.data() + late.size(), 4, 64), dimacs::ParseError);
+}
+
+TEST_CASE("dimacs::read_file")
+{
+    const char* path = "dimacs_loader_test.cnf";
+    {
+        std::ofstream out(path);
+        out << tricky_cnf(100);
+    }
+
+    auto sequential = dimacs::read_file<mini::Lit>(path);
+    auto parallel = dimacs::read_file<mini::Lit>(path, 4);
+    REQUIRE(sequential.num_clauses() == 100);
+    REQUIRE(parallel.num_clauses() == 100);
+    REQUIRE(sequential.num_lits() == parallel.num_lits());
+
+    // a wrong header reserves no more than the file can hold
+    {
+        std::ofstream out(path);
+        out << "p cnf 3 9000000000000\n1 -2 0\n3 0\n";
+    }
+    REQUIRE(dimacs::read_file<mini::Lit>(path).num_clauses() == 2);
+    REQUIRE(dimacs::read_file<mini::Lit>(path, 2).num_clauses() == 2);
+
+    std::remove(path);
+}
@@ -0,0 +1,228 @@
+// Copyright (c) 2018 radek
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#include <hubero/dimacs_reader.hpp>
+using namespace hubero;
+
+#include "catch.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+template<class L>
+std::vector<std::vector<L>> read_all(const std::string& text)
+{
+    dimacs::BufferReader<L> reader{dimacs::BufferSource(text)};
+    std::vector<std::vector<L>> clauses;
+    reader.for_each_clause([&](tools::Span<const L> clause) {
+        clauses.emplace_back(clause.begin(), clause.end());
+    });
+    return clauses;
+}
+
+} // namespace
+
+TEST_CASE("dimacs::Reader::header")
+{
+    SECTION("comments before the header are skipped")
+    {
+        std::string text = "c hello\nc world\np cnf 3 2\n1 -2 0\n2 3 0\n";
+        dimacs::BufferReader<dimacs::Lit> reader{dimacs::BufferSource(text)};
+        REQUIRE(reader.header().present);
+        REQUIRE(reader.header().num_vars == 3);
+        REQUIRE(reader.header().num_clauses == 2);
+        REQUIRE(reader.for_each_clause([](tools::Span<const dimacs::Lit>) {}) == 2);
+    }
+    SECTION("header is optional")
+    {
+        std::string text = "1 2 0\n";
+        dimacs::BufferReader<dimacs::Lit> reader{dimacs::BufferSource(text)};
+        REQUIRE(!reader.header().present);
+        REQUIRE(reader.next_clause());
+    }
+    SECTION("malformed headers are rejected")
+    {
+        std::string dnf = "p dnf 1 1\n";
+        dimacs::BufferReader<dimacs::Lit> r1{dimacs::BufferSource(dnf)};
+        REQUIRE_THROWS_AS(r1.header(), dimacs::ParseError);
+
+        std::string missing = "p cnf 1\n1 0\n";
+        dimacs::BufferReader<dimacs::Lit> r2{dimacs::BufferSource(missing)};
+        REQUIRE_THROWS_AS(r2.header(), dimacs::ParseError);
+
+        std::string twice = "p cnf 1 1\np cnf 1 1\n";
+        dimacs::BufferReader<dimacs::Lit> r3{dimacs::BufferSource(twice)};
+        REQUIRE_THROWS_AS(r3.header(), dimacs::ParseError);
+
+        std::string late = "1 0\np cnf 1 1\n";
+        dimacs::BufferReader<dimacs::Lit> r4{dimacs::BufferSource(late)};
+        REQUIRE(r4.next_clause());
+        REQUIRE_THROWS_AS(r4.next_clause(), dimacs::ParseError);
+    }
+}
+
+TEST_CASE("dimacs::Reader::next_clause")
+{
+    SECTION("dimacs literals")
+    {
+        auto clauses = read_all<dimacs::Lit>(
+            "p cnf 4 3\n1 -2 0\n-3\n 4 0\nc inner comment\n-1 0\n");
+        REQUIRE(clauses.size() == 3);
+        REQUIRE(clauses[0] == (std::vector<dimacs::Lit>{dimacs::Lit(1), dimacs::Lit(-2)}));
+        REQUIRE(clauses[1] == (std::vector<dimacs::Lit>{dimacs::Lit(-3), dimacs::Lit(4)}));
+        REQUIRE(clauses[2] == (std::vector<dimacs::Lit>{dimacs::Lit(-1)}));
+    }
+    SECTION("mini literals")
+    {
+        auto clauses = read_all<mini::Lit>("p cnf 2 1\n-1 2 0\n");
+        REQUIRE(clauses.size() == 1);
+        REQUIRE(clauses[0][0] == mini::Lit(Var(1), false));
+        REQUIRE(clauses[0][1] == mini::Lit(Var(2), true));
+    }
+    SECTION("empty clause")
+    {
+        auto clauses = read_all<dimacs::Lit>("p cnf 1 2\n0\n1 0\n");
+        REQUIRE(clauses.size() == 2);
+        REQUIRE(clauses[0].empty());
+        REQUIRE(clauses[1].size() == 1);
+    }
+    SECTION("missing terminator of the last clause")
+    {
+        auto clauses = read_all<dimacs::Lit>("1 2 0\n3 4");
+        REQUIRE(clauses.size() == 2);
+        REQUIRE(clauses[1].size() == 2);
+    }
+    SECTION("SATLIB end marker")
+    {
+        auto clauses = read_all<dimacs::Lit>("1 2 0\n%\n0\n\n");
+        REQUIRE(clauses.size() == 1);
+    }
+    SECTION("windows line endings")
+    {
+        auto clauses = read_all<dimacs::Lit>("p cnf 2 1\r\n1 2 0\r\n");
+        REQUIRE(clauses.size() == 1);
+        REQUIRE(clauses[0].size() == 2);
+    }
+    SECTION("empty input")
+    {
+        REQUIRE(read_all<dimacs::Lit>("").empty());
+        REQUIRE(read_all<dimacs::Lit>("c only a comment").empty());
+    }
+}
+
+TEST_CASE("dimacs::Reader::errors")
+{
+    SECTION("garbage")
+    {
+        REQUIRE_THROWS_AS(read_all<dimacs::Lit>("1 x 0\n"), dimacs::ParseError);
+        REQUIRE_THROWS_AS(read_all<dimacs::Lit>("1 2x 0\n"), dimacs::ParseError);
+        REQUIRE_THROWS_AS(read_all<dimacs::Lit>("1 - 0\n"), dimacs::ParseError);
+    }
+    SECTION("errors report the line")
+    {
+        try {
+            read_all<dimacs::Lit>("p cnf 1 1\n\n1 ? 0\n");
+            FAIL("ParseError expected");
+        } catch (const dimacs::ParseError& error) {
+            REQUIRE(error.line() == 3);
+        }
+    }
+    SECTION("literals out of the literal's range")
+    {
+        REQUIRE_THROWS_AS(read_all<dimacs::LitT<int8_t>>("127 0\n128 0\n"),
+            dimacs::ParseError);
+        REQUIRE_THROWS_AS(read_all<mini::LitT<uint8_t>>("127 0\n128 0\n"),
+            dimacs::ParseError);
+        REQUIRE_THROWS_AS(read_all<dimacs::Lit>("12345678901234567890 0\n"),
+            dimacs::ParseError);
+    }
+}
+
+TEST_CASE("dimacs::open_file")
+{
+    const char* path = "dimacs_reader_test.cnf";
+    {
+        std::ofstream out(path);
+        out << "c test\np cnf 3 2\n1 2 3 0\n-1 -2 -3 0\n";
+    }
+
+    auto reader = dimacs::open_file<mini::Lit>(path);
+    REQUIRE(reader.header().num_clauses == 2);
+    REQUIRE(reader.next_clause());
+    REQUIRE(reader.clause().size() == 3);
+    REQUIRE(reader.clause()[2] == mini::Lit(Var(3), true));
+    REQUIRE(reader.next_clause());
+    REQUIRE(reader.clause()[0] == mini::Lit(Var(1), false));
+    REQUIRE(!reader.next_clause());
+    REQUIRE(reader.clauses_read() == 2);
+
+    std::remove(path);
+
+    REQUIRE_THROWS_AS(dimacs::open_file<mini::Lit>("does/not/exist.cnf"),
+        std::system_error);
+}
+
+namespace {
+
+std::string generated_cnf()
+{
+    std::string text = "p cnf 100 300\n";
+    for (int i = 0; i < 300; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            auto var = (i * 7 + j * 13) % 100 + 1;
+            text += std::to_string((i + j) % 2 ? var : -var) + " ";
+        }
+        text += i % 10 == 0 ? "0\nc comment\n" : "0\n";
+    }
+    return text;
+}
+
+const simd::Isa all_isas[] = {simd::Isa::scalar, simd::Isa::sse42, simd::Isa::avx2};
+
+} // namespace
+
+TEST_CASE("dimacs::Reader::instruction_sets")
+{
+    auto text = generated_cnf();
+    for (auto isa : all_isas) {
+        INFO("isa = " << simd::to_string(isa));
+
+        dimacs::BufferReader<mini::Lit> reader{dimacs::BufferSource(text)};
+        reader.set_isa(isa);
+
+        std::size_t i = 0;
+        while (reader.next_clause()) {
+            REQUIRE(reader.clause().size() == 3);
+            auto var = (i * 7 + 1 * 13) % 100 + 1;
+            REQUIRE(reader.clause()[1] == mini::Lit(Var(var), (i + 1) % 2 == 1));
+            ++i;
+        }
+        REQUIRE(i == 300);
+        REQUIRE(reader.line() == 300 + 30 + 2);
+    }
+}
+
+TEST_CASE("dimacs::Reader::batched_bounds_check")
+{
+    // out-of-range literals are reported on their line
+    auto text = generated_cnf() + "1 2 0\n3 300 0\n";
+    for (auto isa : all_isas) {
+        INFO("isa = " << simd::to_string(isa));
+
+        dimacs::BufferReader<mini::LitT<uint8_t>> reader{dimacs::BufferSource(text)};
+        reader.set_isa(isa);
+        try {
+            while (reader.next_clause()) {}
+            FAIL("ParseError expected");
+        } catch (const dimacs::ParseError& error) {
+            REQUIRE(error.line() == 300 + 30 + 3);
+            REQUIRE(reader.clauses_read() == 301);
+        }
+    }
+}
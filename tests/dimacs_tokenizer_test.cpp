@@ -0,0 +1,142 @@
+// Copyright (c) 2018 radek
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#include <hubero/dimacs_tokenizer.hpp>
+using namespace hubero;
+using namespace hubero::dimacs;
+
+#include "catch.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const simd::Isa all_isas[] = {simd::Isa::scalar, simd::Isa::sse42, simd::Isa::avx2};
+
+std::vector<std::int64_t> tokenize_all(const std::string& text, simd::Isa isa,
+    std::size_t* stopped_at = nullptr, std::size_t* newlines = nullptr)
+{
+    std::vector<std::int64_t> values;
+    auto p = text.data();
+    auto end = text.data() + text.size();
+    std::size_t lines = 0;
+    for (;;) {
+        TokenBatch batch;
+        p = tokenize(p, end, batch, isa);
+        values.insert(values.end(), batch.values, batch.values + batch.size);
+        lines += batch.newlines;
+        if (batch.size < TokenBatch::capacity) {
+            break;
+        }
+    }
+    if (stopped_at != nullptr) {
+        *stopped_at = static_cast<std::size_t>(p - text.data());
+    }
+    if (newlines != nullptr) {
+        *newlines = lines;
+    }
+    return values;
+}
+
+} // namespace
+
+TEST_CASE("dimacs::tokenize::short_inputs")
+{
+    for (auto isa : all_isas) {
+        INFO("isa = " << simd::to_string(isa));
+
+        std::size_t stop;
+        std::size_t lines;
+        auto values = tokenize_all("1 -2 0\n-3\t4 0\n", isa, &stop, &lines);
+        REQUIRE(values == (std::vector<std::int64_t>{1, -2, 0, -3, 4, 0}));
+        REQUIRE(stop == 14);
+        REQUIRE(lines == 2);
+
+        REQUIRE(tokenize_all("", isa).empty());
+        REQUIRE(tokenize_all("123456789012345678", isa)
+            == std::vector<std::int64_t>{123456789012345678});
+    }
+}
+
+TEST_CASE("dimacs::tokenize::stops_at_non_integers")
+{
+    for (auto isa : all_isas) {
+        INFO("isa = " << simd::to_string(isa));
+
+        // long enough for the SIMD windows
+        std::string prefix;
+        for (int i = 1; i <= 40; ++i) {
+            prefix += std::to_string(i) + " ";
+        }
+
+        const char* tails[] = {"c comment", "12x", "1-2", "--3", "- 1", "p cnf",
+            "1234567890123456789"};
+        for (auto tail : tails) {
+            INFO("tail = " << tail);
+            std::size_t stop;
+            auto values = tokenize_all(prefix + tail + " 5 0\n", isa, &stop);
+            REQUIRE(values.size() == 40);
+            REQUIRE(values.back() == 40);
+            REQUIRE(stop == prefix.size());
+        }
+    }
+}
+
+TEST_CASE("dimacs::tokenize::long_random_inputs")
+{
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> magnitude(0, 2000000);
+    std::uniform_int_distribution<int> ws(0, 9);
+
+    std::string text;
+    std::vector<std::int64_t> expected;
+    std::size_t expected_lines = 0;
+    for (int i = 0; i < 5000; ++i) {
+        // variable-length integers, including very long ones
+        std::int64_t value = magnitude(rng);
+        if (i % 97 == 0) {
+            value = value * 1000000000 + 123456789;
+        }
+        if (i % 3 == 0) {
+            value = -value;
+        }
+        expected.push_back(value);
+        text += std::to_string(value);
+
+        auto sep = ws(rng);
+        if (sep == 0) {
+            text += "\n";
+            ++expected_lines;
+        } else if (sep == 1) {
+            text += " \t\r\n  ";
+            ++expected_lines;
+        } else {
+            text += " ";
+        }
+    }
+
+    for (auto isa : all_isas) {
+        INFO("isa = " << simd::to_string(isa));
+        std::size_t stop;
+        std::size_t lines;
+        auto values = tokenize_all(text, isa, &stop, &lines);
+        REQUIRE(values == expected);
+        REQUIRE(stop == text.size());
+        REQUIRE(lines == expected_lines);
+    }
+}
+
+TEST_CASE("dimacs::tokenize::max_magnitude")
+{
+    for (auto isa : all_isas) {
+        TokenBatch batch;
+        std::string text = "3 -700 12 0";
+        tokenize(text.data(), text.data() + text.size(), batch, isa);
+        REQUIRE(batch.size == 4);
+        REQUIRE(batch.max_magnitude == 700);
+    }
+}
@@ -0,0 +1,119 @@
+// Copyright (c) 2018 radek
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#include <hubero/dimacs_loader.hpp>
+#include <hubero/dimacs_writer.hpp>
+using namespace hubero;
+using namespace hubero::dimacs;
+
+#include "catch.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST_CASE("dimacs::Writer::formula")
+{
+    Cnf cnf;
+    cnf.set_num_vars(12);
+    cnf.add_clause({mini::Lit(Var(1), true), mini::Lit(Var(12), false)});
+    cnf.add_clause({});
+    cnf.add_clause({mini::Lit(Var(3), false)});
+
+    std::ostringstream out;
+    {
+        StreamWriter writer{StreamSink(out)};
+        writer.comment("written by hubero");
+        writer.write(cnf);
+        writer.clause({dimacs::Lit(-5), dimacs::Lit(6)});
+    }
+    REQUIRE(out.str() ==
+        "c written by hubero\n"
+        "p cnf 12 3\n"
+        "1 -12 0\n"
+        "0\n"
+        "-3 0\n"
+        "-5 6 0\n");
+}
+
+TEST_CASE("dimacs::Writer::small_buffer")
+{
+    // everything is flushed in pieces, and reads back the same
+    Cnf cnf;
+    cnf.set_num_vars(100000);
+    for (unsigned i = 1; i < 3000; ++i) {
+        cnf.add_clause({mini::Lit(Var(i * 31 % 100000 + 1), i % 2 == 0),
+            mini::Lit(Var(i), i % 3 == 0)});
+    }
+
+    std::ostringstream out;
+    StreamWriter writer(StreamSink(out), 16);
+    writer.comment(std::string(100, 'x'));
+    writer.write(cnf);
+    writer.flush();
+
+    auto text = out.str();
+    auto copy = parse_parallel<mini::Lit>(text.data(), text.data() + text.size(), 1);
+    REQUIRE(copy.num_vars() == cnf.num_vars());
+    REQUIRE(copy.num_clauses() == cnf.num_clauses());
+    for (std::size_t i = 0; i < cnf.num_clauses(); ++i) {
+        REQUIRE(std::vector<mini::Lit>(copy[i].begin(), copy[i].end())
+            == std::vector<mini::Lit>(cnf[i].begin(), cnf[i].end()));
+    }
+}
+
+TEST_CASE("dimacs::Writer::model")
+{
+    std::vector<dimacs::Lit> model;
+    for (int i = 1; i <= 40; ++i) {
+        model.push_back(dimacs::Lit(i % 3 == 0 ? -i : i));
+    }
+
+    std::ostringstream out;
+    {
+        StreamWriter writer(StreamSink(out), 64);
+        writer.status("SATISFIABLE");
+        writer.model(tools::Span<const dimacs::Lit>(model.data(), model.size()));
+    }
+
+    std::istringstream in(out.str());
+    std::string line;
+    std::getline(in, line);
+    REQUIRE(line == "s SATISFIABLE");
+
+    std::vector<int> values;
+    while (std::getline(in, line)) {
+        REQUIRE(line.size() <= 78);
+        REQUIRE(line.compare(0, 2, "v ") == 0);
+        std::istringstream fields(line.substr(2));
+        int value;
+        while (fields >> value) {
+            values.push_back(value);
+        }
+    }
+    REQUIRE(values.size() == model.size() + 1);
+    REQUIRE(values.back() == 0);
+    REQUIRE(values[2] == -3);
+    REQUIRE(values[39] == 40);
+}
+
+TEST_CASE("dimacs::Writer::file")
+{
+    const char* path = "dimacs_writer_test.cnf";
+    {
+        FileWriter writer{FileSink(path)};
+        writer.header(2, 1);
+        writer.clause({dimacs::Lit(1), dimacs::Lit(-2)});
+        writer.flush();
+    }
+    std::ifstream in(path);
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    REQUIRE(content == "p cnf 2 1\n1 -2 0\n");
+    std::remove(path);
+
+    REQUIRE_THROWS_AS(FileSink("no/such/directory/file.cnf"), std::system_error);
+}
@@ -0,0 +1,253 @@
+// Copyright (c) 2018 radek
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#include <hubero/gauss.hpp>
+#include "test_helpers.hpp"
+using namespace hubero;
+using namespace hubero::test;
+using namespace hubero::mini;
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+Xor make_xor(std::vector<unsigned> vars, bool parity)
+{
+    Xor x;
+    for (auto v : vars) {
+        x.vars.push_back(Var(v));
+    }
+    x.parity = parity;
+    return x;
+}
+
+// The clauses of the XOR's direct encoding
+std::vector<std::vector<Lit>> encode(const Xor& x)
+{
+    std::vector<std::vector<Lit>> clauses;
+    auto size = x.vars.size();
+    for (std::uint32_t pattern = 0; pattern < (1u << size); ++pattern) {
+        // the clause excludes the assignment with the pattern's true variables
+        if ((simd::popcount(pattern) % 2 == 1) == x.parity) {
+            continue;
+        }
+        std::vector<Lit> clause;
+        for (std::size_t i = 0; i < size; ++i) {
+            clause.push_back(Lit(x.vars[i], (pattern >> i & 1) == 0));
+        }
+        clauses.push_back(clause);
+    }
+    return clauses;
+}
+
+std::vector<unsigned> vars_of(const Xor& x)
+{
+    std::vector<unsigned> vars;
+    for (auto var : x.vars) {
+        vars.push_back(static_cast<unsigned>(var));
+    }
+    return vars;
+}
+
+} // namespace
+
+TEST_CASE("XorFinder::find")
+{
+    XorFinder finder(4);
+    auto even = make_xor({1, 2, 3}, false);
+    auto odd = make_xor({2, 4, 5, 7}, true);
+    for (const auto& x : {even, odd}) {
+        for (auto clause : encode(x)) {
+            std::reverse(clause.begin(), clause.end());
+            finder.add_clause(tools::Span<const Lit>(clause.data(), clause.size()));
+        }
+    }
+
+    // an incomplete encoding, too long and tautological clauses
+    auto partial = encode(make_xor({6, 8, 9}, true));
+    for (std::size_t i = 1; i < partial.size(); ++i) {
+        finder.add_clause(tools::Span<const Lit>(partial[i].data(), partial[i].size()));
+    }
+    finder.add_clause({lit(1), lit(2), lit(3), lit(4), lit(5)});
+    finder.add_clause({lit(1), lit(-1), lit(3)});
+    finder.add_clause({lit(-1), lit(-2), lit(-3)}); // an extra clause of the wrong parity
+
+    auto xors = finder.find();
+    REQUIRE(xors.size() == 2);
+    REQUIRE(vars_of(xors[0]) == (std::vector<unsigned>{1, 2, 3}));
+    REQUIRE(!xors[0].parity);
+    REQUIRE(vars_of(xors[1]) == (std::vector<unsigned>{2, 4, 5, 7}));
+    REQUIRE(xors[1].parity);
+}
+
+TEST_CASE("split_xors")
+{
+    auto systems = split_xors({make_xor({1, 2, 3}, true), make_xor({4, 5, 6}, false),
+        make_xor({3, 7, 8}, false), make_xor({9, 10, 11}, true), make_xor({6, 10, 12}, true)});
+    REQUIRE(systems.size() == 2);
+    REQUIRE(systems[0].size() == 2);
+    REQUIRE(systems[1].size() == 3);
+    REQUIRE(vars_of(systems[1][1]) == (std::vector<unsigned>{9, 10, 11}));
+}
+
+TEST_CASE("GaussMatrix::propagate")
+{
+    // x1 ^ x2 ^ x3 = 1, x2 ^ x3 ^ x4 = 0: together x1 ^ x4 = 1
+    for (auto isa : {simd::Isa::scalar, simd::Isa::avx2}) {
+        GaussMatrix matrix({make_xor({1, 2, 3}, true), make_xor({2, 3, 4}, false)}, isa);
+        REQUIRE(matrix.size() == 2);
+        REQUIRE(matrix.vars().size() == 4);
+
+        Assignment values(Var(4));
+        std::vector<std::vector<Lit>> reasons;
+        auto collect = [&reasons](tools::Span<const Lit> reason) {
+            reasons.emplace_back(reason.begin(), reason.end());
+        };
+        REQUIRE(matrix.propagate(values, collect));
+        REQUIRE(reasons.empty());
+
+        // the same values and nothing found, nothing to eliminate
+        REQUIRE(matrix.propagate(values, collect));
+        REQUIRE(matrix.stats().skipped == 1);
+
+        values.assign(lit(1));
+        REQUIRE(matrix.propagate(values, collect));
+        REQUIRE(reasons.size() == 1);
+        REQUIRE(reasons[0][0] == lit(-4));
+        REQUIRE(reasons[0].size() == 2);
+        REQUIRE(reasons[0][1] == lit(-1));
+
+        // the implication is found again, the caller may have dropped it
+        REQUIRE(matrix.propagate(values, collect));
+        REQUIRE(matrix.stats().skipped == 1);
+        REQUIRE(reasons.size() == 2);
+        REQUIRE(reasons[1] == reasons[0]);
+
+        values.assign(lit(4));
+        REQUIRE(!matrix.propagate(values, collect));
+        auto conflict = matrix.conflict();
+        std::vector<Lit> sorted(conflict.begin(), conflict.end());
+        std::sort(sorted.begin(), sorted.end());
+        REQUIRE(sorted == (std::vector<Lit>{lit(-1), lit(-4)}));
+        REQUIRE(matrix.stats().conflicts == 1);
+        REQUIRE(matrix.stats().propagations == 2);
+    }
+}
+
+TEST_CASE("GaussMatrix::dropped implications")
+{
+    // x1 ^ x2 ^ x3 = 1, x2 ^ x3 ^ x4 = 0 and, apart, x5 ^ x6 = 0, x6 ^ x7 = 1
+    GaussMatrix first({make_xor({1, 2, 3}, true), make_xor({2, 3, 4}, false)});
+    GaussMatrix second({make_xor({5, 6}, false), make_xor({6, 7}, true)});
+    Assignment values(Var(7));
+    values.assign(lit(1));
+    values.assign(lit(5));
+    values.assign(lit(7));
+
+    // the first one implies -x4, the second conflicts, so the caller drops
+    // the implication and backjumps past x7 only
+    std::size_t implied = 0;
+    auto count = [&implied](tools::Span<const Lit>) { ++implied; };
+    REQUIRE(first.propagate(values, count));
+    REQUIRE(implied == 1);
+    REQUIRE(!second.propagate(values, count));
+    values.unassign(Var(7));
+
+    REQUIRE(first.propagate(values, count));
+    REQUIRE(implied == 2);
+    REQUIRE(second.propagate(values, count));
+    REQUIRE(implied == 4); // x6 and then x7
+}
+
+TEST_CASE("GaussMatrix::inconsistent system")
+{
+    // the sum of the rows is 0 = 1, with no variables
+    GaussMatrix matrix({make_xor({1, 2, 3}, true), make_xor({1, 2}, false), make_xor({3}, false)});
+    Assignment values(Var(3));
+    REQUIRE(!matrix.propagate(values, [](tools::Span<const Lit>) {}));
+    REQUIRE(matrix.conflict().size() == 0);
+}
+
+TEST_CASE("GaussMatrix::random systems")
+{
+    // the reasons are implied by the XORs and match the assignment
+    std::mt19937 rng(24);
+    for (int round = 0; round < 200; ++round) {
+        const unsigned num_vars = 80 + rng() % 120; // past a word and a stride
+        std::vector<Xor> xors;
+        std::vector<bool> solution(num_vars + 1);
+        for (unsigned v = 1; v <= num_vars; ++v) {
+            solution[v] = rng() % 2 == 0;
+        }
+        for (unsigned r = 0; r < num_vars / 2; ++r) {
+            std::vector<unsigned> vars;
+            while (vars.size() < 4) {
+                auto v = 1 + static_cast<unsigned>(rng() % num_vars);
+                if (std::find(vars.begin(), vars.end(), v) == vars.end()) {
+                    vars.push_back(v);
+                }
+            }
+            std::sort(vars.begin(), vars.end());
+            bool parity = false;
+            for (auto v : vars) {
+                parity = parity != solution[v];
+            }
+            xors.push_back(make_xor(vars, parity));
+        }
+
+        auto isa = round % 2 == 0 ? simd::Isa::scalar : simd::Isa::avx2;
+        GaussMatrix matrix(xors, isa);
+        Assignment values{Var(num_vars)};
+        bool consistent = true;
+        for (unsigned step = 0; step < num_vars && consistent; ++step) {
+            // a random (maybe wrong) value, then the implied ones
+            auto v = 1 + static_cast<unsigned>(rng() % num_vars);
+            if (values.value(Var(v)) == Value::undef) {
+                values.assign(Lit(Var(v), rng() % 4 != 0 ? solution[v] : !solution[v]));
+            }
+            auto satisfies = [&solution](tools::Span<const Lit> clause) {
+                return std::any_of(clause.begin(), clause.end(), [&solution](Lit l) {
+                    return solution[static_cast<unsigned>(l.var())] == l.sign();
+                });
+            };
+            std::vector<Lit> implied;
+            consistent = matrix.propagate(values, [&](tools::Span<const Lit> reason) {
+                REQUIRE(satisfies(reason));
+                REQUIRE(values.value(reason[0]) == Value::undef);
+                for (std::size_t i = 1; i < reason.size(); ++i) {
+                    REQUIRE(values.value(reason[i]) == Value::false_);
+                }
+                implied.push_back(reason[0]);
+            });
+            for (auto l : implied) {
+                values.assign(l);
+            }
+
+            bool matches = true;
+            for (unsigned u = 1; u <= num_vars; ++u) {
+                matches = matches && (values.value(Var(u)) == Value::undef
+                    || values.value(Var(u)) == (solution[u] ? Value::true_ : Value::false_));
+            }
+            if (matches) {
+                // the solution extends the assignment, nothing may conflict
+                REQUIRE(consistent);
+            }
+        }
+        if (!consistent) {
+            auto conflict = matrix.conflict();
+            REQUIRE(std::any_of(conflict.begin(), conflict.end(), [&solution](Lit l) {
+                return solution[static_cast<unsigned>(l.var())] == l.sign();
+            }));
+            for (auto l : conflict) {
+                REQUIRE(values.value(l) == Value::false_);
+            }
+        }
+    }
+}
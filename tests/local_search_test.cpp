@@ -0,0 +1,152 @@
+// Copyright (c) 2018 radek
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#include <hubero/local_search.hpp>
+#include "test_helpers.hpp"
+using namespace hubero;
+using namespace hubero::test;
+using namespace hubero::mini;
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Random k-CNF with a planted solution, so it is satisfiable
+Cnf planted_cnf(unsigned vars, unsigned clauses, unsigned k, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<bool> solution(vars + 1);
+    for (unsigned v = 1; v <= vars; ++v) {
+        solution[v] = rng() % 2 == 0;
+    }
+    Cnf cnf;
+    cnf.set_num_vars(vars);
+    std::vector<Lit> clause;
+    while (cnf.num_clauses() < clauses) {
+        clause.clear();
+        bool satisfied = false;
+        for (unsigned i = 0; i < k; ++i) {
+            auto v = 1 + static_cast<unsigned>(rng() % vars);
+            auto l = Lit(Var(v), rng() % 2 == 0);
+            satisfied = satisfied || l.sign() == solution[v];
+            clause.push_back(l);
+        }
+        if (satisfied) {
+            cnf.add_clause(tools::Span<const Lit>(clause.data(), clause.size()));
+        }
+    }
+    return cnf;
+}
+
+// The break counts and unsatisfied clauses computed from scratch
+void check_counts(const LocalSearch& sls, const Cnf& cnf)
+{
+    const auto& values = sls.assignment();
+    std::vector<std::uint32_t> breaks(cnf.num_vars() + 1, 0);
+    std::size_t unsatisfied = 0;
+    for (auto clause : cnf) {
+        std::uint32_t true_lits = 0;
+        std::size_t last = 0;
+        bool tautology = false;
+        for (auto l : clause) {
+            tautology = tautology || std::find(clause.begin(), clause.end(), ~l) != clause.end();
+        }
+        std::vector<Lit> distinct(clause.begin(), clause.end());
+        std::sort(distinct.begin(), distinct.end());
+        distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+        for (auto l : distinct) {
+            if (values.is_true(l)) {
+                ++true_lits;
+                last = static_cast<unsigned>(l.var());
+            }
+        }
+        if (tautology) {
+            continue;
+        }
+        unsatisfied += true_lits == 0 ? 1 : 0;
+        breaks[last] += true_lits == 1 ? 1 : 0;
+    }
+    REQUIRE(sls.num_unsatisfied() == unsatisfied);
+    for (unsigned v = 1; v <= cnf.num_vars(); ++v) {
+        REQUIRE(sls.break_count(Var(v)) == breaks[v]);
+    }
+}
+
+} // namespace
+
+TEST_CASE("LocalSearch::trivial")
+{
+    LocalSearch sls;
+    sls.add_clause({lit(1), lit(2)});
+    sls.add_clause({lit(-1)});
+    sls.add_clause({lit(-2), lit(3), lit(-2)});
+    sls.add_clause({lit(4), lit(-4)});
+    REQUIRE(sls.solve(1000) == Result::sat);
+    REQUIRE(sls.num_unsatisfied() == 0);
+    REQUIRE(sls.assignment().value(lit(-1)) == Value::true_);
+    REQUIRE(sls.assignment().value(lit(2)) == Value::true_);
+    REQUIRE(sls.assignment().value(lit(3)) == Value::true_);
+    REQUIRE_THROWS_AS(sls.add_clause({lit(5)}), std::logic_error);
+
+    LocalSearch empty;
+    empty.add_clause(tools::Span<const Lit>());
+    REQUIRE(empty.solve(1000) == Result::unsat);
+
+    // no flips for a formula with no clauses
+    LocalSearch none;
+    REQUIRE(none.solve(1000) == Result::sat);
+    REQUIRE(none.stats().flips == 0);
+}
+
+TEST_CASE("LocalSearch::break counts")
+{
+    // the incremental counts agree with the recomputed ones
+    auto cnf = planted_cnf(60, 250, 3, 25);
+    cnf.add_clause({lit(1), lit(1), lit(2)});
+    cnf.add_clause({lit(3), lit(-3), lit(4)});
+    for (auto walksat : {false, true}) {
+        LocalSearchOptions options;
+        options.walksat = walksat;
+        LocalSearch sls(options);
+        sls.add_cnf(cnf);
+        sls.solve(0);
+        check_counts(sls, cnf);
+        for (int round = 0; round < 20 && sls.num_unsatisfied() > 0; ++round) {
+            sls.solve(5);
+            check_counts(sls, cnf);
+        }
+        REQUIRE(sls.stats().best_unsatisfied <= sls.num_unsatisfied());
+    }
+}
+
+TEST_CASE("LocalSearch::random formulas")
+{
+    // planted 3-, 5- and 9-SAT (two AVX2 steps), by both heuristics
+    std::uint32_t seed = 0;
+    std::uint64_t flips = 0;
+    for (auto isa : {simd::Isa::scalar, simd::Isa::avx2}) {
+        for (auto walksat : {false, true}) {
+            for (auto k : {3u, 5u, 9u}) {
+                auto cnf = planted_cnf(300, k == 3 ? 1200 : 3000, k, ++seed);
+                LocalSearchOptions options;
+                options.walksat = walksat;
+                options.seed = seed + 1000; // not the planted assignment
+                LocalSearch sls(options, isa);
+                sls.add_cnf(cnf);
+                REQUIRE(sls.solve(10000000) == Result::sat);
+                REQUIRE(check_model(cnf, sls.assignment()));
+                REQUIRE(sls.stats().best_unsatisfied == 0);
+                flips += sls.stats().flips;
+            }
+        }
+    }
+    REQUIRE(flips > 0);
+}
@@ -0,0 +1,109 @@
+// Copyright (c) 2018 radek
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#include <hubero/lookahead.hpp>
+#include <hubero/solver.hpp>
+#include "test_helpers.hpp"
+using namespace hubero;
+using namespace hubero::test;
+
+#include "catch.hpp"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+Cnf make_cnf(std::initializer_list<std::initializer_list<int>> clauses)
+{
+    Cnf cnf;
+    for (const auto& clause : clauses) {
+        std::vector<mini::Lit> lits;
+        for (auto l : clause) {
+            lits.push_back(lit(l));
+        }
+        cnf.add_clause(tools::Span<const mini::Lit>(lits.data(), lits.size()));
+    }
+    return cnf;
+}
+
+} // namespace
+
+TEST_CASE("Lookahead::split")
+{
+    // x1 implies most, both ways
+    auto cnf = make_cnf({
+        {-1, 2}, {-1, 3}, {-1, 4}, {1, 5}, {1, 6}, {1, 7},
+        {-2, -5, 8}, {3, 6, 9},
+    });
+    Lookahead cuber(cnf);
+    REQUIRE(!cuber.inconsistent());
+
+    auto split = cuber.split(Cube());
+    REQUIRE(!split.refuted);
+    REQUIRE(split.children.size() == 2);
+    REQUIRE(split.children[0] == Cube{lit(1)});
+    REQUIRE(split.children[1] == Cube{lit(-1)});
+    REQUIRE(cuber.lookahead_count() > 0);
+
+    // the cube is extended, and refuted if it conflicts
+    split = cuber.split(Cube{lit(1), lit(2)});
+    REQUIRE(split.children.size() == 2);
+    REQUIRE(split.children[0][0] == lit(1));
+    REQUIRE(split.children[0].size() == 2); // x2 followed from x1
+    REQUIRE(cuber.split(Cube{lit(1), lit(-4)}).refuted);
+}
+
+TEST_CASE("Lookahead::failed literals")
+{
+    // x1 fails: it implies x2 and -x2
+    auto cnf = make_cnf({{-1, 2}, {-1, -2}, {3, 4}, {-3, 4}, {5, 6, 7}});
+    Lookahead cuber(cnf, 1);
+    auto split = cuber.split(Cube());
+    REQUIRE(!split.refuted);
+    REQUIRE(!split.children.empty());
+    REQUIRE(split.children[0][0] == lit(-1));
+
+    // both literals of x3 fail under -x4
+    REQUIRE(cuber.split(Cube{lit(-4)}).refuted);
+
+    auto unsat = make_cnf({{1}, {-1, 2}, {-2}});
+    REQUIRE(Lookahead(unsat).inconsistent());
+    REQUIRE(Lookahead(unsat).cubes(3).empty());
+}
+
+TEST_CASE("Lookahead::cubes")
+{
+    // the cubes cover all the models: the formula is satisfiable iff one is
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> var(1, 20);
+    for (int round = 0; round < 20; ++round) {
+        Cnf cnf;
+        for (int i = 0; i < 85; ++i) {
+            cnf.add_clause({lit(rng() % 2 ? var(rng) : -var(rng)),
+                lit(rng() % 2 ? var(rng) : -var(rng)), lit(rng() % 2 ? var(rng) : -var(rng))});
+        }
+        Solver whole;
+        whole.add_cnf(cnf);
+        auto expected = whole.solve();
+
+        Lookahead cuber(cnf, 8);
+        auto cubes = cuber.cubes(4);
+        REQUIRE(cubes.size() <= 16);
+        Solver parts;
+        parts.add_cnf(cnf);
+        auto result = Result::unsat;
+        for (const auto& cube : cubes) {
+            for (auto l : cube) {
+                parts.assume(l);
+            }
+            if (parts.solve() == Result::sat) {
+                result = Result::sat;
+            }
+        }
+        REQUIRE(result == expected);
+    }
+}
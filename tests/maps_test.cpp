@@ -0,0 +1,116 @@
+// Copyright (c) 2018 radek
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#include <hubero/maps.hpp>
+using namespace hubero;
+using namespace hubero::mini;
+
+#include "catch.hpp"
+
+#include <string>
+
+TEST_CASE("VarMap")
+{
+    VarMap<std::string> names(Var(3), "?");
+    REQUIRE(names.size() == 4);
+    REQUIRE(names[Var(3)] == "?");
+
+    names[Var(1)] = "x";
+    names.grow_to(Var(10), "new");
+    REQUIRE(names.size() == 11);
+    REQUIRE(names[Var(1)] == "x");
+    REQUIRE(names[Var(3)] == "?");
+    REQUIRE(names[Var(10)] == "new");
+
+    names.grow_to(Var(2)); // never shrinks
+    REQUIRE(names.size() == 11);
+
+    REQUIRE(names.contains(Var(10)));
+    REQUIRE(!names.contains(Var(11)));
+    REQUIRE_THROWS_AS(names.at(Var(11)), std::out_of_range);
+
+    names.fill("");
+    REQUIRE(names[Var(1)].empty());
+}
+
+TEST_CASE("LitMap")
+{
+    LitMap<int> counts(Var(5));
+    REQUIRE(counts.size() == 12);
+
+    counts[Lit(Var(5), true)] = 1;
+    counts[Lit(Var(5), false)] = -1;
+    REQUIRE(counts[Lit(Var(5), true)] == 1);
+    REQUIRE(counts[~Lit(Var(5), true)] == -1);
+    REQUIRE(counts[Lit(Var(4), true)] == 0);
+
+    REQUIRE(counts.contains(Lit(Var(5), true)));
+    REQUIRE(!counts.contains(Lit(Var(6), false)));
+    REQUIRE_THROWS_AS(counts.at(Lit(Var(6), false)), std::out_of_range);
+}
+
+TEST_CASE("VarMap<bool>")
+{
+    VarMap<bool> seen(Var(99));
+    REQUIRE(seen.size() == 100);
+    REQUIRE(seen.storage().words().size() == 2);
+
+    for (unsigned i = 0; i < 100; i += 3) {
+        seen[Var(i)] = true;
+    }
+    for (unsigned i = 0; i < 100; ++i) {
+        REQUIRE(seen[Var(i)] == (i % 3 == 0));
+    }
+
+    // growing fills the partial word and the new words
+    seen.grow_to(Var(200), true);
+    REQUIRE(seen[Var(98)] == false);
+    REQUIRE(seen[Var(99)] == true);
+    REQUIRE(seen[Var(100)] == true);
+    REQUIRE(seen[Var(200)] == true);
+    // bits past the end are zero
+    REQUIRE((seen.storage().words().back() >> (201 % 64)) == 0);
+
+    seen.fill(false);
+    for (auto word : seen.storage().words()) {
+        REQUIRE(word == 0);
+    }
+
+    const auto& read_only = seen;
+    REQUIRE(read_only.at(Var(7)) == false);
+}
+
+TEST_CASE("LitMap<TwoBit>")
+{
+    LitMap<TwoBit> values(Var(40), 2);
+    REQUIRE(values.size() == 82);
+    REQUIRE(values.storage().words().size() == 3);
+    REQUIRE(values[Lit(Var(40), true)] == 2);
+    REQUIRE((values.storage().words().back() >> (82 % 32 * 2)) == 0);
+
+    for (unsigned v = 0; v <= 40; ++v) {
+        values[Lit(Var(v), true)] = static_cast<std::uint8_t>(v % 4);
+        values[Lit(Var(v), false)] = static_cast<std::uint8_t>(3 - v % 4);
+    }
+    for (unsigned v = 0; v <= 40; ++v) {
+        REQUIRE(values[Lit(Var(v), true)] == v % 4);
+        REQUIRE(values[Lit(Var(v), false)] == 3 - v % 4);
+    }
+
+    // copying through the proxy
+    values[Lit(Var(0), true)] = values[Lit(Var(3), true)];
+    REQUIRE(values[Lit(Var(0), true)] == 3);
+
+    values.fill(1);
+    REQUIRE(values[Lit(Var(17), false)] == 1);
+}
+
+TEST_CASE("VarMap::variables_of_literals")
+{
+    VarMap<int> levels(Var(8));
+    auto lit = Lit(Var(8), false);
+    levels[lit.var()] = 3;
+    REQUIRE(levels[Var(8)] == 3);
+}
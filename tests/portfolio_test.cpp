@@ -0,0 +1,100 @@
+// Copyright (c) 2018 radek
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#include <hubero/portfolio.hpp>
+#include "test_helpers.hpp"
+using namespace hubero;
+using namespace hubero::test;
+
+#include "catch.hpp"
+
+#include <cstdint>
+#include <vector>
+
+TEST_CASE("ImportFilter")
+{
+    ImportFilter filter(1, 3, 4);
+    SharedClause clause{2, 2, {mini::Lit(4), mini::Lit(7)}};
+    REQUIRE(filter.accept(clause));
+    REQUIRE(!filter.accept(clause));
+
+    // the same clause from another thread, in another order
+    SharedClause reordered{3, 2, {mini::Lit(7), mini::Lit(4)}};
+    REQUIRE(!filter.accept(reordered));
+
+    SharedClause own{1, 2, {mini::Lit(4), mini::Lit(9)}};
+    REQUIRE(!filter.accept(own));
+    SharedClause high_lbd{2, 4, {mini::Lit(4), mini::Lit(9)}};
+    REQUIRE(!filter.accept(high_lbd));
+    SharedClause long_clause{2, 2, std::vector<mini::Lit>(5, mini::Lit(6))};
+    REQUIRE(!filter.accept(long_clause));
+}
+
+TEST_CASE("Portfolio::answers")
+{
+    for (unsigned threads : {1u, 4u}) {
+        int sat = 0;
+        for (std::uint32_t seed = 1; seed <= 12; ++seed) {
+            auto cnf = random_3sat(60, 256, seed);
+            Solver reference;
+            reference.add_cnf(cnf);
+            auto expected = reference.solve();
+
+            PortfolioOptions options;
+            options.threads = threads;
+            Portfolio portfolio(options);
+            auto result = portfolio.solve(cnf);
+            REQUIRE(result == expected);
+            REQUIRE(portfolio.winner() >= 0);
+            REQUIRE(portfolio.worker_stats().size() == threads);
+            if (result == Result::sat) {
+                REQUIRE(portfolio.model().size() == 60);
+                REQUIRE(satisfies(portfolio.model(), cnf));
+                ++sat;
+            }
+        }
+        REQUIRE(sat > 0);
+        REQUIRE(sat < 12);
+    }
+}
+
+TEST_CASE("Portfolio::sharing")
+{
+    // 8 pigeons in 7 holes keep 4 threads busy long enough to share
+    Cnf cnf;
+    const int holes = 7;
+    for (int p = 0; p <= holes; ++p) {
+        std::vector<mini::Lit> clause;
+        for (int h = 0; h < holes; ++h) {
+            clause.push_back(mini::Lit(Var(static_cast<unsigned>(p * holes + h + 1)), true));
+        }
+        cnf.add_clause(tools::Span<const mini::Lit>(clause.data(), clause.size()));
+    }
+    for (int h = 0; h < holes; ++h) {
+        for (int p = 0; p < holes; ++p) {
+            for (int q = p + 1; q <= holes; ++q) {
+                cnf.add_clause({mini::Lit(Var(static_cast<unsigned>(p * holes + h + 1)), false),
+                    mini::Lit(Var(static_cast<unsigned>(q * holes + h + 1)), false)});
+            }
+        }
+    }
+
+    PortfolioOptions options;
+    options.threads = 4;
+    options.export_lbd = 8;
+    options.import_lbd = 8;
+    options.export_size = 30;
+    options.import_size = 30;
+    Portfolio portfolio(options);
+    REQUIRE(portfolio.solve(cnf) == Result::unsat);
+
+    std::uint64_t exported = 0;
+    for (const auto& worker : portfolio.worker_stats()) {
+        exported += worker.exported;
+        REQUIRE(worker.imported == worker.solver.imported_clauses);
+    }
+    REQUIRE(exported > 0);
+    REQUIRE(std::string(portfolio.worker_stats()[1].config) == "vmtf, luby");
+}
@@ -0,0 +1,186 @@
+// Copyright (c) 2018 radek
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#include <hubero/prober.hpp>
+#include "test_helpers.hpp"
+using namespace hubero;
+using namespace hubero::test;
+using namespace hubero::mini;
+
+#include "catch.hpp"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+bool implies(const Propagator& prop, Lit from, Lit to)
+{
+    for (const auto& edge : prop.implications(from)) {
+        if (edge.other == to) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+TEST_CASE("Prober::failed literals")
+{
+    // x1 implies x2 and x3, which clash; x4 is a root that does not fail
+    Propagator prop;
+    prop.grow_to(Var(6));
+    prop.add_clause({lit(-1), lit(2)});
+    prop.add_clause({lit(-1), lit(3)});
+    prop.add_clause({lit(-2), lit(-3)});
+    prop.add_clause({lit(-4), lit(5)});
+    prop.add_clause({lit(5), lit(6), lit(-2)});
+
+    Prober prober;
+    REQUIRE(prober.probe(prop, 1000));
+    REQUIRE(prop.decision_level() == 0);
+    REQUIRE(prop.value(lit(-1)) == Value::true_);
+    REQUIRE(prober.stats().failed_literals == 1);
+    REQUIRE(prober.stats().probes >= 2);
+    REQUIRE(prober.stats().ticks > 0);
+
+    // nothing new: the roots are cached
+    auto probes = prober.stats().probes;
+    REQUIRE(prober.probe(prop, 1000));
+    REQUIRE(prober.stats().probes == probes);
+    REQUIRE(prober.stats().cached > 0);
+
+    // x1 fails, and -x1 implies x5 (as x6 is false), which conflicts
+    Propagator unsat;
+    unsat.grow_to(Var(7));
+    unsat.add_clause({lit(-1), lit(2)});
+    unsat.add_clause({lit(-1), lit(-2)});
+    unsat.add_clause({lit(-5), lit(7)});
+    unsat.add_clause({lit(-5), lit(-7)});
+    unsat.add_clause({lit(1), lit(5), lit(6)});
+    unsat.assign(lit(-6), ClauseRef());
+    REQUIRE(!Prober().probe(unsat, 1000));
+}
+
+TEST_CASE("Prober::hyper-binary resolution")
+{
+    // x1 implies x2 and x3, and through them x4 by a long clause; the
+    // dominator of x2 and x3 is x1, so (-x1 x4) is learnt
+    Propagator prop;
+    prop.grow_to(Var(8));
+    prop.add_clause({lit(-1), lit(2)});
+    prop.add_clause({lit(-1), lit(3)});
+    prop.add_clause({lit(-2), lit(-3), lit(4)});
+
+    // x5 implies x6, which alone implies x4 (the rest false at level 0)
+    prop.add_clause({lit(-5), lit(6)});
+    prop.add_clause({lit(-6), lit(7), lit(4)});
+    prop.assign(lit(-7), ClauseRef());
+
+    Prober prober;
+    REQUIRE(prober.probe(prop, 1000));
+    REQUIRE(prober.stats().failed_literals == 0);
+    REQUIRE(prober.stats().hyper_binaries == 2);
+    REQUIRE(implies(prop, lit(1), lit(4)));
+    REQUIRE(implies(prop, lit(6), lit(4)));
+
+    // a new unit clears the cache, but the resolvents are not learnt twice
+    prop.assign(lit(8), ClauseRef());
+    auto probes = prober.stats().probes;
+    REQUIRE(prober.probe(prop, 1000));
+    REQUIRE(prober.stats().probes > probes);
+    REQUIRE(prober.stats().hyper_binaries == 2);
+}
+
+TEST_CASE("Prober::ticks")
+{
+    // a chain of roots, each probe propagates two literals
+    Propagator prop;
+    prop.grow_to(Var(200));
+    for (int i = 1; i < 200; i += 2) {
+        prop.add_clause({lit(-i), lit(i + 1)});
+    }
+
+    Prober prober;
+    REQUIRE(prober.probe(prop, 0));
+    REQUIRE(prober.stats().probes == 0);
+    REQUIRE(prober.probe(prop, 20));
+    REQUIRE(prober.stats().probes == 10);
+
+    // the next round goes on with the rest
+    REQUIRE(prober.probe(prop, 1000000));
+    REQUIRE(prober.stats().probes == 200);
+    REQUIRE(prober.stats().cached == 10);
+    REQUIRE(prop.trail().empty());
+}
+
+TEST_CASE("Prober::random formulas")
+{
+    // probing keeps the formula equisatisfiable: its units and resolvents
+    // are implied, so every model of the formula satisfies them
+    std::mt19937 rng(21);
+    std::uniform_int_distribution<int> var(1, 12);
+    for (int round = 0; round < 200; ++round) {
+        std::vector<std::vector<Lit>> clauses(30);
+        for (std::size_t i = 0; i < clauses.size(); ++i) {
+            auto size = i < 18 ? 2 : 3;
+            while (clauses[i].size() < static_cast<std::size_t>(size)) {
+                auto l = lit(rng() % 2 ? var(rng) : -var(rng));
+                bool fresh = true;
+                for (auto other : clauses[i]) {
+                    fresh = fresh && other != l && other != ~l;
+                }
+                if (fresh) {
+                    clauses[i].push_back(l);
+                }
+            }
+        }
+
+        Propagator prop;
+        prop.grow_to(Var(12));
+        for (const auto& clause : clauses) {
+            prop.add_clause(tools::Span<const Lit>(clause.data(), clause.size()));
+        }
+        Prober prober;
+        auto consistent = prober.probe(prop, 100000);
+
+        bool any_model = false;
+        bool implied = true;
+        for (std::uint32_t bits = 0; bits < (1u << 12); ++bits) {
+            auto is_true = [bits](Lit l) {
+                return ((bits >> (static_cast<unsigned>(l.var()) - 1)) & 1) == (l.sign() ? 1u : 0u);
+            };
+            bool model = true;
+            for (const auto& clause : clauses) {
+                bool satisfied = false;
+                for (auto l : clause) {
+                    satisfied = satisfied || is_true(l);
+                }
+                model = model && satisfied;
+            }
+            if (!model || !consistent) {
+                any_model = any_model || model;
+                continue;
+            }
+            any_model = true;
+            for (auto l : prop.trail()) {
+                implied = implied && is_true(l);
+            }
+            prop.arena().for_each_clause([&](ClauseRef ref) {
+                bool satisfied = false;
+                for (auto l : prop.arena()[ref]) {
+                    satisfied = satisfied || is_true(l);
+                }
+                implied = implied && satisfied;
+            });
+        }
+        REQUIRE(implied);
+        if (any_model) {
+            REQUIRE(consistent);
+        }
+    }
+}
@@ -0,0 +1,183 @@
+// Copyright (c) 2018 radek
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#include <hubero/propagator.hpp>
+#include "test_helpers.hpp"
+using namespace hubero;
+using namespace hubero::test;
+using namespace hubero::mini;
+
+#include "catch.hpp"
+
+#include <vector>
+
+namespace {
+
+std::vector<Lit> trail_of(const Propagator& prop)
+{
+    auto trail = prop.trail();
+    return std::vector<Lit>(trail.begin(), trail.end());
+}
+
+} // namespace
+
+TEST_CASE("Propagator::binary")
+{
+    Propagator prop;
+    prop.grow_to(Var(4));
+    auto ab = prop.add_clause({lit(-1), lit(2)});
+    auto bc = prop.add_clause({lit(-2), lit(3)});
+
+    prop.decide(lit(1));
+    REQUIRE(!prop.propagate().valid());
+    REQUIRE(trail_of(prop) == std::vector<Lit>{lit(1), lit(2), lit(3)});
+
+    REQUIRE(prop.decision_level() == 1);
+    REQUIRE(prop.level(Var(3)) == 1);
+    REQUIRE(prop.reason(Var(2)) == ab);
+    REQUIRE(prop.reason(Var(3)) == bc);
+    REQUIRE(!prop.reason(Var(1)).valid());
+    REQUIRE(prop.value(Var(4)) == Value::undef);
+    REQUIRE(prop.locked(ab));
+}
+
+TEST_CASE("Propagator::long")
+{
+    Propagator prop;
+    prop.grow_to(Var(5));
+    auto ref = prop.add_clause({lit(1), lit(2), lit(3), lit(4)});
+
+    prop.decide(lit(-1));
+    REQUIRE(!prop.propagate().valid());
+    prop.decide(lit(-2));
+    REQUIRE(!prop.propagate().valid());
+    prop.decide(lit(-3));
+    REQUIRE(!prop.propagate().valid());
+
+    REQUIRE(prop.value(lit(4)) == Value::true_);
+    REQUIRE(prop.reason(Var(4)) == ref);
+    REQUIRE(prop.level(Var(4)) == 3);
+    REQUIRE(prop.level_start(3) == 2);
+
+    // the watches moved with the assignments, and they still work
+    prop.backtrack(1);
+    REQUIRE(trail_of(prop) == std::vector<Lit>{lit(-1)});
+    REQUIRE(prop.value(Var(4)) == Value::undef);
+
+    prop.decide(lit(-4));
+    prop.decide(lit(-3));
+    REQUIRE(!prop.propagate().valid());
+    REQUIRE(prop.value(lit(2)) == Value::true_);
+}
+
+TEST_CASE("Propagator::conflict")
+{
+    Propagator prop;
+    prop.grow_to(Var(3));
+    prop.add_clause({lit(-1), lit(2), lit(3)});
+    auto other = prop.add_clause({lit(-1), lit(2), lit(-3)});
+
+    prop.decide(lit(-2));
+    REQUIRE(!prop.propagate().valid());
+    prop.decide(lit(1));
+    auto conflict = prop.propagate();
+    REQUIRE(conflict.valid());
+
+    // every literal of the conflict is false
+    for (auto l : prop.arena()[conflict]) {
+        REQUIRE(prop.value(l) == Value::false_);
+    }
+
+    std::vector<Lit> unassigned;
+    prop.backtrack(0, [&](Lit l) { unassigned.push_back(l); });
+    REQUIRE(prop.trail().empty());
+    REQUIRE(unassigned.size() == 3);
+    REQUIRE(unassigned.back() == lit(-2));
+
+    // no watch got lost in the conflict
+    prop.decide(lit(1));
+    prop.decide(lit(3));
+    REQUIRE(!prop.propagate().valid());
+    REQUIRE(prop.value(lit(2)) == Value::true_);
+    REQUIRE(prop.reason(Var(2)) == other);
+}
+
+TEST_CASE("Propagator::binary conflict")
+{
+    Propagator prop;
+    prop.grow_to(Var(2));
+    prop.add_clause({lit(-1), lit(2)});
+    auto ref = prop.add_clause({lit(-1), lit(-2)});
+
+    prop.decide(lit(1));
+    REQUIRE(prop.propagate() == ref);
+}
+
+TEST_CASE("Propagator::collect_garbage")
+{
+    Propagator prop;
+    prop.grow_to(Var(4));
+    auto dropped = prop.add_clause({lit(1), lit(2), lit(3)});
+    prop.add_clause({lit(-1), lit(3), lit(4)}, true);
+    prop.add_clause({lit(-1), lit(-4)});
+
+    prop.remove_clause(dropped);
+    auto moved = prop.collect_garbage();
+    REQUIRE(moved.size() == 2);
+    REQUIRE(prop.arena().num_clauses() == 2);
+    REQUIRE(prop.arena().wasted_words() == 0);
+
+    // the dropped clause no longer propagates, the moved ones still do
+    prop.decide(lit(-2));
+    prop.decide(lit(-3));
+    REQUIRE(!prop.propagate().valid());
+    REQUIRE(prop.value(Var(1)) == Value::undef);
+
+    prop.decide(lit(1));
+    auto conflict = prop.propagate();
+    REQUIRE(conflict.valid());
+    REQUIRE(prop.arena()[conflict].size() == 3);
+    REQUIRE(prop.arena()[conflict].learnt());
+}
+
+TEST_CASE("Propagator::freed clauses")
+{
+    // freed clauses stop propagating before they are collected
+    Propagator prop;
+    prop.grow_to(Var(4));
+    auto dropped = prop.add_clause({lit(1), lit(2), lit(3)}, true);
+    prop.remove_clause(dropped);
+
+    prop.decide(lit(-2));
+    prop.decide(lit(-3));
+    REQUIRE(!prop.propagate().valid());
+    REQUIRE(prop.value(Var(1)) == Value::undef);
+
+    prop.decide(lit(-1));
+    REQUIRE(!prop.propagate().valid());
+    auto moved = prop.collect_garbage();
+    REQUIRE(moved.size() == 0);
+    REQUIRE(prop.trail().size() == 3);
+}
+
+TEST_CASE("Propagator::freed binary clauses")
+{
+    Propagator prop;
+    prop.grow_to(Var(3));
+    auto dropped = prop.add_clause({lit(1), lit(2)});
+    auto kept = prop.add_clause({lit(1), lit(3)});
+    prop.remove_clause(dropped);
+    REQUIRE(prop.implications(lit(-1)).size() == 1);
+
+    prop.decide(lit(-1));
+    REQUIRE(!prop.propagate().valid());
+    REQUIRE(prop.value(Var(2)) == Value::undef);
+    REQUIRE(prop.reason(Var(3)) == kept);
+
+    auto moved = prop.collect_garbage();
+    auto reason = prop.reason(Var(3));
+    REQUIRE(prop.arena()[reason].size() == 2);
+    REQUIRE(moved.size() == 1);
+}
@@ -0,0 +1,71 @@
+// Copyright (c) 2018 radek
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#include <hubero/reconstruction.hpp>
+#include "test_helpers.hpp"
+using namespace hubero;
+using namespace hubero::test;
+
+#include "catch.hpp"
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("ReconstructionStack::extend")
+{
+    // x3 was eliminated from (x3 | x1) & (-x3 | x2): the smaller side went
+    // first, then the default of -x3
+    ReconstructionStack stack;
+    REQUIRE(stack.empty());
+    stack.push(lit(3), {lit(3), lit(1)});
+    stack.push(lit(-3), {lit(-3)});
+    REQUIRE(stack.size() == 2);
+    REQUIRE(stack.max_variable() == Var(3));
+    REQUIRE(stack.witness(0) == lit(3));
+    REQUIRE(stack.clause(0).size() == 2);
+
+    SECTION("Assignment") {
+        Assignment model(Var(2));
+        model.assign(lit(1));
+        model.assign(lit(2));
+        stack.extend(model);
+        REQUIRE(model.value(lit(-3)) == Value::true_);
+
+        model.assign(lit(-1));
+        stack.extend(model);
+        REQUIRE(model.value(lit(3)) == Value::true_);
+    }
+
+    SECTION("dimacs model") {
+        std::vector<dimacs::Lit> model{dimacs::Lit(-1), dimacs::Lit(2)};
+        stack.extend(model);
+        REQUIRE(model.size() == 3);
+        REQUIRE(model[2] == dimacs::Lit(3));
+
+        model[0] = dimacs::Lit(1);
+        stack.extend(model);
+        REQUIRE(model[2] == dimacs::Lit(-3));
+    }
+
+    // written with the witnesses first and read back
+    stack.push(lit(2), {lit(1), lit(2), lit(-3)});
+    auto cnf = stack.to_cnf();
+    REQUIRE(cnf.num_clauses() == 3);
+    REQUIRE(cnf[2][0] == lit(2));
+    REQUIRE(cnf[2].size() == 3);
+    ReconstructionStack copy(cnf);
+    REQUIRE(copy.size() == 3);
+    for (std::size_t i = 0; i < copy.size(); ++i) {
+        REQUIRE(copy.witness(i) == stack.witness(i));
+        REQUIRE(copy.clause(i).size() == stack.clause(i).size());
+    }
+    cnf.add_clause(tools::Span<const mini::Lit>());
+    REQUIRE_THROWS_AS(ReconstructionStack(cnf), std::invalid_argument);
+
+    stack.clear();
+    REQUIRE(stack.empty());
+    REQUIRE(stack.max_variable() == Var(0));
+}
@@ -0,0 +1,92 @@
+// Copyright (c) 2018 radek
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#include <hubero/restart.hpp>
+using namespace hubero;
+
+#include "catch.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+// Conflicts between the restarts of a policy, under constant LBDs
+template<class Policy>
+std::vector<std::uint64_t> intervals(Policy policy, std::size_t count, std::uint32_t lbd = 5)
+{
+    std::vector<std::uint64_t> result;
+    std::uint64_t conflicts = 0;
+    while (result.size() < count) {
+        policy.conflict(lbd);
+        ++conflicts;
+        if (policy.restart()) {
+            result.push_back(conflicts);
+            conflicts = 0;
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("restart::luby")
+{
+    std::vector<std::uint64_t> sequence;
+    for (std::uint64_t i = 0; i < 15; ++i) {
+        sequence.push_back(luby(i));
+    }
+    REQUIRE(sequence == std::vector<std::uint64_t>{1, 1, 2, 1, 1, 2, 4, 1, 1, 2, 1, 1, 2, 4, 8});
+
+    REQUIRE(intervals(LubyRestarts(10), 7)
+        == std::vector<std::uint64_t>{10, 10, 20, 10, 10, 20, 40});
+}
+
+TEST_CASE("restart::geometric")
+{
+    REQUIRE(intervals(GeometricRestarts(10, 2), 4)
+        == std::vector<std::uint64_t>{10, 20, 40, 80});
+}
+
+TEST_CASE("restart::ema")
+{
+    // the bias correction makes the first samples count fully
+    Ema ema(0.01);
+    REQUIRE(ema.value() == 0);
+    ema.update(10);
+    REQUIRE(ema.value() == Approx(10));
+    ema.update(10);
+    REQUIRE(ema.value() == Approx(10));
+    for (int i = 0; i < 1000; ++i) {
+        ema.update(20);
+    }
+    REQUIRE(ema.value() == Approx(20).epsilon(0.01));
+}
+
+TEST_CASE("restart::glucose")
+{
+    GlucoseRestarts policy(1.2, 2);
+
+    // steady LBDs, no restarts
+    for (int i = 0; i < 1000; ++i) {
+        policy.conflict(5);
+        REQUIRE(!policy.restart());
+    }
+
+    // the recent LBDs get worse
+    bool restarted = false;
+    for (int i = 0; i < 100 && !restarted; ++i) {
+        policy.conflict(20);
+        restarted = policy.restart();
+    }
+    REQUIRE(restarted);
+    REQUIRE(policy.fast_lbd() > 1.2 * policy.slow_lbd());
+
+    // not again before the minimal interval
+    REQUIRE(!policy.restart());
+    policy.conflict(20);
+    policy.conflict(20);
+    REQUIRE(policy.restart());
+}
@@ -0,0 +1,433 @@
+// Copyright (c) 2018 radek
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#include <hubero/simplifier.hpp>
+#include <hubero/solver.hpp>
+#include "test_helpers.hpp"
+using namespace hubero;
+using namespace hubero::test;
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+Cnf random_cnf(std::mt19937& rng, int vars, int clauses, int max_size)
+{
+    std::uniform_int_distribution<int> var(1, vars);
+    std::uniform_int_distribution<int> size(1, max_size);
+    Cnf cnf;
+    cnf.set_num_vars(static_cast<std::uint64_t>(vars));
+    std::vector<mini::Lit> clause;
+    for (int i = 0; i < clauses; ++i) {
+        clause.clear();
+        for (int k = size(rng); k > 0; --k) {
+            clause.push_back(lit(rng() % 2 ? var(rng) : -var(rng)));
+        }
+        cnf.add_clause(tools::Span<const mini::Lit>(clause.data(), clause.size()));
+    }
+    return cnf;
+}
+
+} // namespace
+
+TEST_CASE("Simplifier::eliminate")
+{
+    Simplifier simplifier;
+    simplifier.add_clause({lit(1), lit(2)});
+    simplifier.add_clause({lit(-1), lit(3)});
+    simplifier.add_clause({lit(2), lit(3), lit(4)});
+    simplifier.add_clause({lit(-2), lit(-4)});
+    simplifier.freeze(Var(2));
+    simplifier.freeze(Var(3));
+    REQUIRE(simplifier.num_clauses() == 4);
+
+    REQUIRE(simplifier.eliminate());
+    REQUIRE(simplifier.is_eliminated(Var(1)));
+    REQUIRE(!simplifier.is_eliminated(Var(2)));
+    REQUIRE(!simplifier.is_eliminated(Var(3)));
+    REQUIRE(simplifier.is_eliminated(Var(4)));
+    REQUIRE(simplifier.stats().eliminated_vars == 2);
+
+    // (x2 | x3) is all that is left, x4 resolved to a tautology
+    auto cnf = simplifier.formula();
+    REQUIRE(cnf.num_vars() == 4);
+    REQUIRE(cnf.num_clauses() == 1);
+    REQUIRE(cnf[0].size() == 2);
+    REQUIRE(cnf[0][0] == lit(2));
+    REQUIRE(cnf[0][1] == lit(3));
+
+    std::vector<dimacs::Lit> model{dimacs::Lit(-1), dimacs::Lit(-2), dimacs::Lit(3)};
+    simplifier.extend(model);
+    REQUIRE(model.size() == 4);
+    REQUIRE(model[0] == dimacs::Lit(1));
+    REQUIRE(model[3] == dimacs::Lit(-4));
+
+    REQUIRE_THROWS_AS(simplifier.add_clause({lit(1), lit(5)}), std::invalid_argument);
+}
+
+TEST_CASE("Simplifier::units")
+{
+    Simplifier simplifier;
+    simplifier.add_clause({lit(1)});
+    simplifier.add_clause({lit(-1), lit(2)});
+    simplifier.add_clause({lit(-2), lit(3), lit(4)});
+    simplifier.add_clause({lit(1), lit(5)});
+    for (unsigned v = 1; v <= 5; ++v) {
+        simplifier.freeze(Var(v));
+    }
+    REQUIRE(simplifier.eliminate());
+    REQUIRE(simplifier.stats().units == 2);
+    REQUIRE(simplifier.num_clauses() == 1);
+
+    auto cnf = simplifier.formula();
+    REQUIRE(cnf.num_clauses() == 3);
+    REQUIRE(cnf[0][0] == lit(1));
+    REQUIRE(cnf[1][0] == lit(2));
+
+    simplifier.add_clause({lit(-3)});
+    simplifier.add_clause({lit(-4)});
+    REQUIRE(!simplifier.eliminate());
+    REQUIRE(simplifier.inconsistent());
+    REQUIRE(simplifier.formula().num_clauses() == 1);
+    REQUIRE(simplifier.formula()[0].size() == 0);
+}
+
+TEST_CASE("Simplifier::subsume")
+{
+    Simplifier simplifier;
+    simplifier.add_clause({lit(1), lit(2), lit(3)});
+    simplifier.add_clause({lit(1), lit(2)});
+    simplifier.add_clause({lit(-1), lit(2), lit(4)});
+    simplifier.add_clause({lit(5), lit(6)});
+    simplifier.add_clause({lit(6), lit(5)});
+    REQUIRE(simplifier.subsume());
+    REQUIRE(simplifier.stats().subsumed_clauses == 2);
+    REQUIRE(simplifier.stats().strengthened_clauses == 1);
+    REQUIRE(simplifier.stats().subsumption_checks >= 3);
+
+    auto cnf = simplifier.formula();
+    REQUIRE(cnf.num_clauses() == 3);
+    REQUIRE(cnf[1].size() == 2); // (-x1 | x2 | x4) resolved with (x1 | x2)
+    REQUIRE(cnf[1][0] == lit(2));
+    REQUIRE(cnf[1][1] == lit(4));
+
+    // (x1 | x2) is watched by x2, the rarer literal, x1 is negated in the
+    // strengthened clause
+    Simplifier flipped;
+    flipped.add_clause({lit(1), lit(2)});
+    flipped.add_clause({lit(1), lit(7)});
+    flipped.add_clause({lit(1), lit(8)});
+    flipped.add_clause({lit(-1), lit(2), lit(9)});
+    REQUIRE(flipped.subsume());
+    REQUIRE(flipped.stats().strengthened_clauses == 1);
+    REQUIRE(flipped.formula()[3].size() == 2);
+
+    // strengthened to a unit, which satisfies the other clause
+    Simplifier units;
+    units.add_clause({lit(1), lit(2)});
+    units.add_clause({lit(1), lit(-2)});
+    units.add_clause({lit(-1), lit(3), lit(4)});
+    REQUIRE(units.subsume());
+    REQUIRE(units.stats().units == 1);
+    REQUIRE(units.num_clauses() == 1);
+}
+
+TEST_CASE("Simplifier::subsume random formulas")
+{
+    std::mt19937 rng(7);
+    for (int round = 0; round < 50; ++round) {
+        auto cnf = random_cnf(rng, 8, 40, 5);
+        Solver original;
+        original.add_cnf(cnf);
+        auto expected = original.solve();
+
+        Simplifier simplifier(cnf);
+        simplifier.subsume();
+        auto simplified = simplifier.formula();
+        Solver solver;
+        solver.add_cnf(simplified);
+        REQUIRE(solver.solve() == expected);
+        if (simplifier.inconsistent() || simplifier.stats().strengthened_clauses > 0) {
+            continue;
+        }
+
+        // without strengthening, no clause is left that another subsumes
+        for (std::size_t i = 0; i < simplified.num_clauses(); ++i) {
+            for (std::size_t j = 0; j < simplified.num_clauses(); ++j) {
+                auto small = simplified[i];
+                auto large = simplified[j];
+                if (i == j || small.size() > large.size()) {
+                    continue;
+                }
+                bool subset = true;
+                for (auto l : small) {
+                    subset = subset && std::find(large.begin(), large.end(), l) != large.end();
+                }
+                REQUIRE(!subset);
+            }
+        }
+    }
+}
+
+TEST_CASE("Simplifier::random formulas")
+{
+    // the simplified formula is equisatisfiable and its models extend to
+    // models of the original one
+    std::mt19937 rng(11);
+    int eliminated = 0;
+    for (int round = 0; round < 100; ++round) {
+        auto cnf = random_cnf(rng, 30, 60 + round, 4);
+        Solver original;
+        original.add_cnf(cnf);
+        auto expected = original.solve();
+
+        SimplifierOptions options;
+        options.clause_growth = static_cast<std::size_t>(round % 3);
+        Simplifier simplifier(cnf, options);
+        if (round % 2 == 0) {
+            simplifier.subsume();
+        }
+        simplifier.eliminate();
+        eliminated += static_cast<int>(simplifier.stats().eliminated_vars);
+
+        Solver solver;
+        solver.add_cnf(simplifier.formula());
+        REQUIRE(solver.solve() == expected);
+        if (expected == Result::sat) {
+            auto model = solver.model();
+            simplifier.extend(model);
+            Assignment assignment(Var(30));
+            for (auto l : model) {
+                assignment.assign(Solver::to_mini(l));
+            }
+            REQUIRE(check_model(cnf, assignment));
+        }
+    }
+    REQUIRE(eliminated > 0);
+}
+
+TEST_CASE("Simplifier::substitute_equivalences")
+{
+    // x1 -> x2 -> x3 -> x1, and -x4 <-> x5
+    Simplifier simplifier;
+    simplifier.add_clause({lit(-1), lit(2)});
+    simplifier.add_clause({lit(-2), lit(3)});
+    simplifier.add_clause({lit(-3), lit(1)});
+    simplifier.add_clause({lit(4), lit(5)});
+    simplifier.add_clause({lit(-4), lit(-5)});
+    simplifier.add_clause({lit(3), lit(5), lit(6)});
+    simplifier.add_clause({lit(-2), lit(-6)});
+    simplifier.freeze(Var(5));
+    REQUIRE(simplifier.substitute_equivalences());
+    REQUIRE(simplifier.stats().equivalence_classes == 2);
+    REQUIRE(simplifier.stats().substituted_vars == 3);
+    REQUIRE(simplifier.is_eliminated(Var(2)));
+    REQUIRE(simplifier.is_eliminated(Var(3)));
+    REQUIRE(simplifier.is_eliminated(Var(4)));
+    REQUIRE(!simplifier.is_eliminated(Var(5)));
+
+    // (x1 | x5 | x6) & (-x1 | -x6)
+    auto cnf = simplifier.formula();
+    REQUIRE(cnf.num_clauses() == 2);
+    REQUIRE(cnf[0].size() == 3);
+    REQUIRE(cnf[0][0] == lit(1));
+    REQUIRE(cnf[1][0] == lit(-1));
+
+    std::vector<dimacs::Lit> model{dimacs::Lit(1), dimacs::Lit(-2), dimacs::Lit(-3),
+        dimacs::Lit(4), dimacs::Lit(5), dimacs::Lit(-6)};
+    simplifier.extend(model);
+    REQUIRE(model[1] == dimacs::Lit(2));
+    REQUIRE(model[2] == dimacs::Lit(3));
+    REQUIRE(model[3] == dimacs::Lit(-4));
+
+    // x1 <-> -x1
+    Simplifier contradiction;
+    contradiction.add_clause({lit(-1), lit(2)});
+    contradiction.add_clause({lit(-2), lit(-1)});
+    contradiction.add_clause({lit(1), lit(3)});
+    contradiction.add_clause({lit(-3), lit(1)});
+    REQUIRE(!contradiction.substitute_equivalences());
+}
+
+TEST_CASE("Simplifier::long equivalence chains")
+{
+    // deep enough to overflow a recursive search
+    const unsigned length = 200000;
+    Simplifier simplifier;
+    for (unsigned v = 1; v < length; ++v) {
+        simplifier.add_clause({mini::Lit(Var(v), false), mini::Lit(Var(v + 1), true)});
+    }
+    simplifier.add_clause({mini::Lit(Var(length), false), mini::Lit(Var(1), true)});
+    simplifier.add_clause({mini::Lit(Var(length / 2), true), mini::Lit(Var(length + 1), true)});
+    REQUIRE(simplifier.substitute_equivalences());
+    REQUIRE(simplifier.stats().substituted_vars == length - 1);
+    REQUIRE(simplifier.num_clauses() == 1);
+    REQUIRE(simplifier.formula()[0][0] == lit(1));
+}
+
+TEST_CASE("Simplifier::equivalences in random formulas")
+{
+    std::mt19937 rng(3);
+    std::uint64_t substituted = 0;
+    for (int round = 0; round < 100; ++round) {
+        // binary clauses make cycles of implications
+        Cnf cnf;
+        std::uniform_int_distribution<int> var(1, 20);
+        auto random_lit = [&]() { return lit(rng() % 2 ? var(rng) : -var(rng)); };
+        for (int i = 0; i < 20 + round % 10; ++i) {
+            cnf.add_clause({random_lit(), random_lit()});
+        }
+        for (int i = 0; i < 20; ++i) {
+            cnf.add_clause({random_lit(), random_lit(), random_lit()});
+        }
+        Solver original;
+        original.add_cnf(cnf);
+        auto expected = original.solve();
+
+        Simplifier simplifier(cnf);
+        simplifier.substitute_equivalences();
+        substituted += simplifier.stats().substituted_vars;
+        if (round % 2 == 0) {
+            simplifier.eliminate();
+        }
+
+        Solver solver;
+        solver.add_cnf(simplifier.formula());
+        REQUIRE(solver.solve() == expected);
+        if (expected == Result::sat) {
+            auto model = solver.model();
+            simplifier.extend(model);
+            Assignment assignment(Var(20));
+            for (auto l : model) {
+                assignment.assign(Solver::to_mini(l));
+            }
+            REQUIRE(check_model(cnf, assignment));
+        }
+    }
+    REQUIRE(substituted > 0);
+}
+
+TEST_CASE("Simplifier::eliminate_blocked")
+{
+    // (1 2 3) is blocked on 1, then (-1 -2) and (-1 -3) are pure
+    auto core = {
+        std::vector<int>{4, 5}, std::vector<int>{-4, 5},
+        std::vector<int>{4, -5}, std::vector<int>{-4, -5},
+    };
+    Simplifier simplifier;
+    simplifier.add_clause({lit(1), lit(2), lit(3)});
+    simplifier.add_clause({lit(-1), lit(-2)});
+    simplifier.add_clause({lit(-1), lit(-3)});
+    for (const auto& clause : core) {
+        simplifier.add_clause({lit(clause[0]), lit(clause[1])});
+    }
+    REQUIRE(simplifier.eliminate_blocked());
+    REQUIRE(simplifier.stats().blocked_clauses == 3);
+    REQUIRE(simplifier.num_clauses() == 4);
+    REQUIRE(simplifier.reconstruction().size() == 3);
+
+    // nothing changed, nothing to visit
+    auto steps = simplifier.stats().steps;
+    REQUIRE(simplifier.eliminate_blocked());
+    REQUIRE(simplifier.stats().steps == steps);
+
+    // frozen literals do not block
+    Simplifier frozen;
+    for (int var = 1; var <= 3; ++var) {
+        frozen.freeze(Var(static_cast<unsigned>(var)));
+    }
+    frozen.add_clause({lit(1), lit(2), lit(3)});
+    frozen.add_clause({lit(-1), lit(-2)});
+    frozen.add_clause({lit(-1), lit(-3)});
+    REQUIRE(frozen.eliminate_blocked());
+    REQUIRE(frozen.stats().blocked_clauses == 0);
+}
+
+TEST_CASE("Simplifier::eliminate_covered")
+{
+    // (1 2) is not blocked, but with 3 added (common to the clauses of -1)
+    // it is blocked on 2
+    Simplifier simplifier;
+    simplifier.add_clause({lit(1), lit(2)});
+    simplifier.add_clause({lit(-1), lit(3)});
+    simplifier.add_clause({lit(-2), lit(-3)});
+    REQUIRE(simplifier.eliminate_blocked());
+    REQUIRE(simplifier.stats().blocked_clauses == 0);
+
+    REQUIRE(simplifier.eliminate_covered());
+    REQUIRE(simplifier.stats().covered_clauses >= 1);
+    REQUIRE(simplifier.stats().covered_lits >= 1);
+    REQUIRE(simplifier.num_clauses() == 0);
+
+    // any model of the rest extends to the formula
+    for (int bits = 0; bits < 8; ++bits) {
+        Assignment assignment(Var(3));
+        for (int var = 1; var <= 3; ++var) {
+            assignment.assign(lit((bits >> (var - 1)) & 1 ? var : -var));
+        }
+        simplifier.extend(assignment);
+        REQUIRE((assignment.is_true(lit(1)) || assignment.is_true(lit(2))));
+        REQUIRE((assignment.is_true(lit(-1)) || assignment.is_true(lit(3))));
+        REQUIRE((assignment.is_true(lit(-2)) || assignment.is_true(lit(-3))));
+    }
+}
+
+TEST_CASE("Simplifier::clause elimination in random formulas")
+{
+    std::mt19937 rng(23);
+    std::uint64_t blocked = 0;
+    std::uint64_t covered = 0;
+    for (int round = 0; round < 100; ++round) {
+        auto cnf = random_cnf(rng, 30, 40 + round, 4);
+        Solver original;
+        original.add_cnf(cnf);
+        auto expected = original.solve();
+
+        // the frozen variables get more clauses later
+        Simplifier simplifier(cnf);
+        for (int var = 1; var <= 10; ++var) {
+            simplifier.freeze(Var(static_cast<unsigned>(var)));
+        }
+        if (round % 2 == 0) {
+            simplifier.eliminate_blocked();
+        } else {
+            simplifier.eliminate_covered();
+        }
+        auto more = random_cnf(rng, 10, 5, 3);
+        simplifier.add_cnf(more);
+        simplifier.eliminate_covered();
+        if (round % 3 == 0) {
+            simplifier.eliminate();
+        }
+        blocked += simplifier.stats().blocked_clauses;
+        covered += simplifier.stats().covered_clauses;
+
+        Solver reference;
+        reference.add_cnf(cnf);
+        reference.add_cnf(more);
+        expected = reference.solve();
+
+        Solver solver;
+        solver.add_cnf(simplifier.formula());
+        REQUIRE(solver.solve() == expected);
+        if (expected == Result::sat) {
+            auto model = solver.model();
+            simplifier.extend(model);
+            Assignment assignment(Var(30));
+            for (auto l : model) {
+                assignment.assign(Solver::to_mini(l));
+            }
+            REQUIRE(check_model(cnf, assignment));
+            REQUIRE(check_model(more, assignment));
+        }
+    }
+    REQUIRE(blocked > 0);
+    REQUIRE(covered > 0);
+}
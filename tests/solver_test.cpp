@@ -0,0 +1,618 @@
+// Copyright (c) 2018 radek
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#include <hubero/solver.hpp>
+using namespace hubero;
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Clauses = std::vector<std::vector<int>>;
+
+template<class S>
+void add_all(S& solver, const Clauses& clauses)
+{
+    for (const auto& clause : clauses) {
+        std::vector<dimacs::Lit> lits;
+        for (auto lit : clause) {
+            lits.push_back(dimacs::Lit(lit));
+        }
+        solver.add_clause(tools::Span<const dimacs::Lit>(lits.data(), lits.size()));
+    }
+}
+
+template<class S>
+bool satisfies(const S& solver, const Clauses& clauses)
+{
+    for (const auto& clause : clauses) {
+        bool satisfied = false;
+        for (auto lit : clause) {
+            satisfied = satisfied || solver.model_value(dimacs::Lit(lit)) == Value::true_;
+        }
+        if (!satisfied) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool brute_force(const Clauses& clauses, unsigned vars)
+{
+    for (std::uint32_t bits = 0; bits < (1u << vars); ++bits) {
+        bool all = true;
+        for (const auto& clause : clauses) {
+            bool satisfied = false;
+            for (auto lit : clause) {
+                auto value = (bits >> ((lit < 0 ? -lit : lit) - 1)) & 1;
+                satisfied = satisfied || (value == 1) == (lit > 0);
+            }
+            if (!satisfied) {
+                all = false;
+                break;
+            }
+        }
+        if (all) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// n + 1 pigeons in n holes, variable p * n + h + 1 puts pigeon p in hole h
+Clauses pigeonhole(int holes)
+{
+    Clauses clauses;
+    for (int p = 0; p <= holes; ++p) {
+        std::vector<int> some_hole;
+        for (int h = 0; h < holes; ++h) {
+            some_hole.push_back(p * holes + h + 1);
+        }
+        clauses.push_back(some_hole);
+    }
+    for (int h = 0; h < holes; ++h) {
+        for (int p = 0; p < holes; ++p) {
+            for (int q = p + 1; q <= holes; ++q) {
+                clauses.push_back({-(p * holes + h + 1), -(q * holes + h + 1)});
+            }
+        }
+    }
+    return clauses;
+}
+
+// Random instances near the threshold, checked by brute force
+template<class S>
+void random_3sat(std::uint32_t seed)
+{
+    const unsigned vars = 14;
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> var(1, vars);
+
+    int sat = 0;
+    for (int round = 0; round < 200; ++round) {
+        Clauses clauses(60);
+        for (auto& clause : clauses) {
+            for (int k = 0; k < 3; ++k) {
+                clause.push_back(rng() % 2 ? var(rng) : -var(rng));
+            }
+        }
+
+        S solver;
+        add_all(solver, clauses);
+        auto result = solver.solve();
+        REQUIRE(result == (brute_force(clauses, vars) ? Result::sat : Result::unsat));
+        if (result == Result::sat) {
+            REQUIRE(satisfies(solver, clauses));
+            ++sat;
+        }
+    }
+    // both answers are covered
+    REQUIRE(sat > 10);
+    REQUIRE(sat < 190);
+}
+
+} // namespace
+
+TEST_CASE("Solver::trivial")
+{
+    Solver empty;
+    REQUIRE(empty.solve() == Result::sat);
+    REQUIRE(empty.model().empty());
+
+    Solver contradiction;
+    contradiction.add_clause({dimacs::Lit(1)});
+    REQUIRE(!contradiction.add_clause({dimacs::Lit(-1)}));
+    REQUIRE(contradiction.solve() == Result::unsat);
+
+    Solver tautology;
+    tautology.add_clause({dimacs::Lit(1), dimacs::Lit(-1), dimacs::Lit(1)});
+    REQUIRE(tautology.solve() == Result::sat);
+    REQUIRE(tautology.model().size() == 1);
+
+    REQUIRE_THROWS_AS(tautology.add_clause({dimacs::Lit(0)}), std::invalid_argument);
+    REQUIRE(std::string(to_string(Result::unsat)) == "UNSATISFIABLE");
+}
+
+TEST_CASE("Solver::sat")
+{
+    Clauses clauses = {
+        {1, 2, 3}, {-1, -2}, {-1, -3}, {-2, -3},
+        {1, 4}, {-4, 5, 6}, {-5, -6}, {-1, 5},
+    };
+    Solver solver;
+    add_all(solver, clauses);
+    REQUIRE(solver.solve() == Result::sat);
+    REQUIRE(solver.model().size() == 6);
+    REQUIRE(satisfies(solver, clauses));
+    REQUIRE(solver.model()[0].var() == dimacs::Lit(1).var());
+
+    // clauses can be added after solving
+    solver.add_clause({dimacs::Lit(-5)});
+    REQUIRE(solver.solve() == Result::sat);
+    REQUIRE(solver.model_value(dimacs::Lit(-1)) == Value::true_);
+}
+
+TEST_CASE("Solver::pigeonhole")
+{
+    Solver solver;
+    add_all(solver, pigeonhole(5));
+    REQUIRE(solver.solve() == Result::unsat);
+    REQUIRE(solver.stats().conflicts > 0);
+    REQUIRE(solver.stats().learnt_lits > 0);
+    REQUIRE(solver.solve() == Result::unsat);
+}
+
+TEST_CASE("Solver::conflict limit")
+{
+    Solver solver;
+    add_all(solver, pigeonhole(7));
+    solver.set_conflict_limit(10);
+    REQUIRE(solver.solve() == Result::unknown);
+    REQUIRE(solver.stats().conflicts == 10);
+    REQUIRE(solver.model().empty());
+}
+
+TEST_CASE("Solver::random 3-SAT")
+{
+    random_3sat<SolverT<Evsids>>(7);
+    random_3sat<SolverT<Vmtf>>(8);
+}
+
+TEST_CASE("Solver::pigeonhole with VMTF")
+{
+    SolverT<Vmtf> solver;
+    add_all(solver, pigeonhole(5));
+    REQUIRE(solver.solve() == Result::unsat);
+    REQUIRE(!solver.decisions().queue().empty());
+}
+
+TEST_CASE("Solver::reduction")
+{
+    // frequent reductions, compacting the arena every time
+    Solver aggressive;
+    aggressive.options().reduce_first = 20;
+    aggressive.options().reduce_increment = 5;
+    aggressive.options().collect_fraction = 0.0;
+    add_all(aggressive, pigeonhole(6));
+    REQUIRE(aggressive.solve() == Result::unsat);
+
+    const auto& stats = aggressive.stats();
+    REQUIRE(stats.reductions > 0);
+    REQUIRE(stats.deleted_clauses > 0);
+    REQUIRE(stats.collections > 0);
+    REQUIRE(stats.reclaimed_bytes > 0);
+    REQUIRE(stats.learnt_clauses < stats.conflicts);
+    REQUIRE(aggressive.reduction_log().size() == stats.reductions);
+    REQUIRE(aggressive.reduction_log().back().kept <= stats.learnt_clauses);
+
+    // tier-2 clauses (here all of them) are deleted only after they are
+    // not used for tier2_reductions reductions
+    for (std::uint32_t window : {0u, 5u}) {
+        Solver tiered;
+        tiered.options() = aggressive.options();
+        tiered.options().tier2_lbd = 1000;
+        tiered.options().tier2_reductions = window;
+        add_all(tiered, pigeonhole(6));
+        REQUIRE(tiered.solve() == Result::unsat);
+        const auto& log = tiered.reduction_log();
+        REQUIRE(log.size() > 6);
+        std::uint64_t early = 0;
+        for (std::size_t i = 0; i <= 5; ++i) {
+            early += log[i].deleted;
+        }
+        REQUIRE((window == 0 ? early > 0 : early == 0));
+    }
+
+    // the answers agree with the default schedule on larger instances
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> var(1, 60);
+    for (int round = 0; round < 10; ++round) {
+        Clauses clauses(256);
+        for (auto& clause : clauses) {
+            for (int k = 0; k < 3; ++k) {
+                clause.push_back(rng() % 2 ? var(rng) : -var(rng));
+            }
+        }
+
+        Solver reference;
+        add_all(reference, clauses);
+        Solver reduced;
+        reduced.options() = aggressive.options();
+        add_all(reduced, clauses);
+
+        auto result = reduced.solve();
+        REQUIRE(result == reference.solve());
+        if (result == Result::sat) {
+            REQUIRE(satisfies(reduced, clauses));
+        }
+    }
+}
+
+TEST_CASE("Solver::probing")
+{
+    // probing after every conflict, with a budget to spare
+    SolverOptions eager;
+    eager.probe_interval = 1;
+    eager.probe_effort = 100;
+
+    Solver solver;
+    solver.options() = eager;
+    add_all(solver, pigeonhole(6));
+    REQUIRE(solver.solve() == Result::unsat);
+    REQUIRE(solver.stats().probes > 0);
+
+    // the answers agree with no probing, on formulas with many binary
+    // clauses
+    std::mt19937 rng(21);
+    std::uniform_int_distribution<int> var(1, 60);
+    std::uint64_t failed = 0;
+    std::uint64_t resolvents = 0;
+    for (int round = 0; round < 20; ++round) {
+        Clauses clauses(190);
+        for (std::size_t i = 0; i < clauses.size(); ++i) {
+            for (std::size_t k = 0; k < (i < 40 ? 2u : 3u); ++k) {
+                clauses[i].push_back(rng() % 2 ? var(rng) : -var(rng));
+            }
+        }
+
+        Solver reference;
+        reference.options().probe_interval = 0;
+        add_all(reference, clauses);
+        Solver probing;
+        probing.options() = eager;
+        add_all(probing, clauses);
+
+        auto result = probing.solve();
+        REQUIRE(result == reference.solve());
+        REQUIRE(reference.stats().probes == 0);
+        if (result == Result::sat) {
+            REQUIRE(satisfies(probing, clauses));
+        }
+        failed += probing.stats().failed_literals;
+        resolvents += probing.stats().hyper_binaries;
+    }
+    REQUIRE(failed > 0);
+    REQUIRE(resolvents > 0);
+}
+
+TEST_CASE("Solver::vivification")
+{
+    // vivifying after every conflict, with a budget to spare
+    SolverOptions eager;
+    eager.probe_interval = 0;
+    eager.vivify_interval = 1;
+    eager.vivify_effort = 100;
+
+    Solver solver;
+    solver.options() = eager;
+    add_all(solver, pigeonhole(6));
+    REQUIRE(solver.solve() == Result::unsat);
+
+    // the answers agree with no vivification
+    std::mt19937 rng(22);
+    std::uniform_int_distribution<int> var(1, 60);
+    std::uint64_t removed = 0;
+    for (int round = 0; round < 20; ++round) {
+        Clauses clauses(255);
+        for (auto& clause : clauses) {
+            for (int k = 0; k < 3; ++k) {
+                clause.push_back(rng() % 2 ? var(rng) : -var(rng));
+            }
+        }
+
+        Solver reference;
+        reference.options().vivify_interval = 0;
+        add_all(reference, clauses);
+        Solver vivifying;
+        vivifying.options() = eager;
+        add_all(vivifying, clauses);
+
+        auto result = vivifying.solve();
+        REQUIRE(result == reference.solve());
+        REQUIRE(reference.stats().vivified_clauses == 0);
+        if (result == Result::sat) {
+            REQUIRE(satisfies(vivifying, clauses));
+        }
+        removed += vivifying.stats().vivified_lits;
+    }
+    REQUIRE(removed > 0);
+}
+
+TEST_CASE("Solver::Gaussian elimination")
+{
+    // random XORs of 3 or 4 variables in their direct encodings, with a
+    // few plain clauses; the answers agree with no elimination
+    std::mt19937 rng(24);
+    std::uint64_t xors = 0;
+    std::uint64_t propagations = 0;
+    std::uint64_t conflicts = 0;
+    for (int round = 0; round < 30; ++round) {
+        const int vars = 40;
+        Clauses clauses;
+        for (int x = 0; x < 34 + round % 8; ++x) {
+            std::vector<int> xor_vars;
+            auto size = 3u + rng() % 2;
+            while (xor_vars.size() < size) {
+                auto v = 1 + static_cast<int>(rng() % vars);
+                if (std::find(xor_vars.begin(), xor_vars.end(), v) == xor_vars.end()) {
+                    xor_vars.push_back(v);
+                }
+            }
+            auto parity = rng() % 2;
+            for (std::uint32_t pattern = 0; pattern < (1u << size); ++pattern) {
+                if (simd::popcount(pattern) % 2 == parity) {
+                    continue; // assignments of the right parity are allowed
+                }
+                std::vector<int> clause;
+                for (std::size_t i = 0; i < size; ++i) {
+                    clause.push_back(pattern >> i & 1 ? -xor_vars[i] : xor_vars[i]);
+                }
+                clauses.push_back(clause);
+            }
+        }
+        for (int c = 0; c < 10; ++c) {
+            std::vector<int> clause;
+            for (int k = 0; k < 3; ++k) {
+                auto v = 1 + static_cast<int>(rng() % vars);
+                clause.push_back(rng() % 2 ? v : -v);
+            }
+            clauses.push_back(clause);
+        }
+
+        Solver reference;
+        reference.options().xor_max_size = 0;
+        add_all(reference, clauses);
+        Solver gauss;
+        add_all(gauss, clauses);
+
+        auto result = gauss.solve();
+        REQUIRE(result == reference.solve());
+        REQUIRE(reference.stats().xors == 0);
+        if (result == Result::sat) {
+            REQUIRE(satisfies(gauss, clauses));
+        }
+        xors += gauss.stats().xors;
+        propagations += gauss.stats().gauss_propagations;
+        conflicts += gauss.stats().gauss_conflicts;
+    }
+    REQUIRE(xors > 0);
+    REQUIRE(propagations > 0);
+    REQUIRE(conflicts > 0);
+}
+
+TEST_CASE("Solver::restarts")
+{
+    random_3sat<SolverT<Evsids, LubyRestarts>>(9);
+    random_3sat<SolverT<Vmtf, GeometricRestarts>>(10);
+
+    SolverT<Evsids, LubyRestarts> solver(Evsids(), LubyRestarts(4));
+    solver.options().trace_restarts = true;
+    solver.options().rephase_interval = 50;
+    add_all(solver, pigeonhole(6));
+    REQUIRE(solver.solve() == Result::unsat);
+
+    const auto& stats = solver.stats();
+    REQUIRE(stats.restarts > 0);
+    REQUIRE(stats.rephases > 0);
+    REQUIRE(solver.restart_log().size() == stats.restarts);
+
+    // restarts wait for the next decision, so intervals may overshoot
+    std::uint64_t conflicts = 0;
+    for (const auto& restart : solver.restart_log()) {
+        REQUIRE(restart.interval >= 4);
+        REQUIRE(restart.level > 0);
+        conflicts += restart.interval;
+        REQUIRE(restart.conflicts == conflicts);
+    }
+
+    // no trace unless asked for
+    Solver quiet;
+    add_all(quiet, pigeonhole(6));
+    REQUIRE(quiet.solve() == Result::unsat);
+    REQUIRE(quiet.restart_log().empty());
+}
+
+TEST_CASE("Solver::phases")
+{
+    // the saved phases repeat the previous model
+    Clauses clauses = {{1, 2}, {-1, -2}, {2, 3}, {-2, -3}, {3, 4}, {-3, -4}};
+    Solver solver;
+    add_all(solver, clauses);
+    REQUIRE(solver.solve() == Result::sat);
+    auto first = solver.model();
+    REQUIRE(solver.solve() == Result::sat);
+    REQUIRE(solver.model() == first);
+    REQUIRE(satisfies(solver, clauses));
+}
+
+TEST_CASE("Solver::assumptions")
+{
+    // x1 -> x2 -> x3, x4 -> -x3
+    Solver solver;
+    add_all(solver, {{-1, 2}, {-2, 3}, {-4, -3}, {5, 6}});
+
+    solver.assume(dimacs::Lit(1));
+    REQUIRE(solver.solve() == Result::sat);
+    REQUIRE(solver.model_value(dimacs::Lit(3)) == Value::true_);
+    REQUIRE(solver.failed_assumptions().empty());
+
+    // x5 plays no part in the conflict
+    solver.assume(dimacs::Lit(5));
+    solver.assume(dimacs::Lit(1));
+    solver.assume(dimacs::Lit(4));
+    REQUIRE(solver.solve() == Result::unsat);
+    REQUIRE(solver.failed_assumptions().size() == 2);
+    REQUIRE(solver.failed_assumption(dimacs::Lit(1)));
+    REQUIRE(solver.failed_assumption(dimacs::Lit(4)));
+    REQUIRE(!solver.failed_assumption(dimacs::Lit(5)));
+
+    // the assumptions are gone and the formula is still satisfiable
+    REQUIRE(solver.solve() == Result::sat);
+
+    // contradicting assumptions, and one contradicting a unit
+    solver.assume(dimacs::Lit(6));
+    solver.assume(dimacs::Lit(-6));
+    REQUIRE(solver.solve() == Result::unsat);
+    REQUIRE(solver.failed_assumptions().size() == 2);
+    solver.add_clause({dimacs::Lit(-5)});
+    solver.assume(dimacs::Lit(5));
+    REQUIRE(solver.solve() == Result::unsat);
+    REQUIRE(solver.failed_assumptions().size() == 1);
+    REQUIRE(solver.solve() == Result::sat);
+    REQUIRE_THROWS_AS(solver.assume(dimacs::Lit(0)), std::invalid_argument);
+
+    // the failed assumptions (with the formula) are unsatisfiable, the
+    // learnt clauses are kept across many calls
+    std::mt19937 rng(12);
+    std::uniform_int_distribution<int> var(1, 14);
+    Clauses clauses(50);
+    for (auto& clause : clauses) {
+        for (int k = 0; k < 3; ++k) {
+            clause.push_back(rng() % 2 ? var(rng) : -var(rng));
+        }
+    }
+    Solver incremental;
+    add_all(incremental, clauses);
+    for (int round = 0; round < 100; ++round) {
+        Clauses assumed;
+        for (int k = 0; k < 4; ++k) {
+            int lit = rng() % 2 ? var(rng) : -var(rng);
+            incremental.assume(dimacs::Lit(lit));
+            assumed.push_back({lit});
+        }
+        Clauses all = clauses;
+        all.insert(all.end(), assumed.begin(), assumed.end());
+        auto result = incremental.solve();
+        REQUIRE(result == (brute_force(all, 14) ? Result::sat : Result::unsat));
+        if (result == Result::sat) {
+            REQUIRE(satisfies(incremental, all));
+        } else {
+            Clauses core = clauses;
+            for (auto lit : incremental.failed_assumptions()) {
+                core.push_back({static_cast<int>(Solver::to_dimacs(lit))});
+            }
+            REQUIRE(!brute_force(core, 14));
+        }
+    }
+    REQUIRE(incremental.stats().solves == 100);
+}
+
+TEST_CASE("Solver::clause groups")
+{
+    Solver solver;
+    add_all(solver, {{1, 2}, {-1, 3}});
+
+    auto forbid_two = solver.new_group();
+    solver.add_clause(forbid_two, {dimacs::Lit(-2)});
+    auto forbid_three = solver.new_group();
+    solver.add_clause(forbid_three, {dimacs::Lit(-3)});
+    REQUIRE(solver.num_vars() == 3);
+
+    REQUIRE(solver.solve() == Result::unsat);
+    REQUIRE(solver.failed_assumption(forbid_two));
+    REQUIRE(solver.failed_assumption(forbid_three));
+    REQUIRE(solver.failed_assumptions().empty());
+
+    solver.retract(forbid_three);
+    REQUIRE(solver.solve() == Result::sat);
+    REQUIRE(solver.model_value(dimacs::Lit(1)) == Value::true_);
+    REQUIRE(solver.model_value(dimacs::Lit(3)) == Value::true_);
+    REQUIRE(solver.stats().simplified_clauses > 0);
+    REQUIRE_THROWS_AS(solver.retract(forbid_three), std::invalid_argument);
+
+    // the remaining group still applies, with assumptions too
+    solver.assume(dimacs::Lit(-3));
+    REQUIRE(solver.solve() == Result::unsat);
+    REQUIRE(solver.failed_assumption(dimacs::Lit(-3)));
+    REQUIRE(solver.failed_assumption(forbid_two));
+
+    solver.retract(forbid_two);
+    solver.assume(dimacs::Lit(-3));
+    REQUIRE(solver.solve() == Result::sat);
+    REQUIRE(solver.model_value(dimacs::Lit(2)) == Value::true_);
+
+    // groups of a harder formula: pigeons retracted one by one
+    Solver pigeons;
+    pigeons.grow_to(Var(42));
+    std::vector<ClauseGroup> groups;
+    auto clauses = pigeonhole(6);
+    for (std::size_t i = 0; i < clauses.size(); ++i) {
+        if (i < 7) {
+            groups.push_back(pigeons.new_group());
+        }
+        std::vector<dimacs::Lit> lits;
+        for (auto lit : clauses[i]) {
+            lits.push_back(dimacs::Lit(lit));
+        }
+        tools::Span<const dimacs::Lit> span(lits.data(), lits.size());
+        if (i < 7) {
+            pigeons.add_clause(groups.back(), span);
+        } else {
+            pigeons.add_clause(span);
+        }
+    }
+    REQUIRE(pigeons.solve() == Result::unsat);
+    for (auto group : groups) {
+        REQUIRE(pigeons.failed_assumption(group));
+    }
+    pigeons.retract(groups[3]);
+    REQUIRE(pigeons.solve() == Result::sat);
+}
+
+TEST_CASE("Solver::variables after groups")
+{
+    // as in bounded model checking: each step brings new variables
+    Solver solver;
+    add_all(solver, {{1, 2}});
+    auto group = solver.new_group();
+    solver.add_clause(group, {dimacs::Lit(-1)});
+    add_all(solver, {{3}});
+    REQUIRE(solver.num_vars() == 3);
+    REQUIRE(solver.solve() == Result::sat);
+    REQUIRE(solver.model().size() == 3);
+    REQUIRE(solver.model_value(dimacs::Lit(2)) == Value::true_);
+
+    solver.retract(group);
+    REQUIRE(solver.solve() == Result::sat);
+    REQUIRE(solver.model_value(dimacs::Lit(3)) == Value::true_);
+
+    // a new group's clauses over the new variables, assumed against
+    auto next = solver.new_group();
+    solver.add_clause(next, {dimacs::Lit(-4), dimacs::Lit(-3)});
+    solver.assume(dimacs::Lit(4));
+    REQUIRE(solver.solve() == Result::unsat);
+    REQUIRE(solver.failed_assumptions() == (std::vector<mini::Lit>{Solver::to_mini(dimacs::Lit(4))}));
+    REQUIRE(solver.failed_assumption(next));
+    REQUIRE(solver.num_vars() == 4);
+    solver.retract(next);
+    solver.assume(dimacs::Lit(4));
+    REQUIRE(solver.solve() == Result::sat);
+    REQUIRE(solver.model().size() == 4);
+}
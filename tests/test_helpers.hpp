@@ -0,0 +1,63 @@
+// Copyright (c) 2018 radek
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#ifndef HUBERO_TEST_HELPERS_H_
+#define HUBERO_TEST_HELPERS_H_
+
+#include <hubero/cnf.hpp>
+#include <hubero/core.hpp>
+#include <hubero/tools.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace hubero {
+namespace test {
+
+// The literal of a DIMACS number, e.g. lit(-3)
+inline mini::Lit lit(int dimacs)
+{
+    return mini::Lit(Var(static_cast<unsigned>(dimacs < 0 ? -dimacs : dimacs)), dimacs > 0);
+}
+
+// Uniform random 3-CNF (its clauses may repeat a variable)
+inline Cnf random_3sat(unsigned vars, std::size_t clauses, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<unsigned> var(1, vars);
+    Cnf cnf;
+    for (std::size_t i = 0; i < clauses; ++i) {
+        std::vector<mini::Lit> clause;
+        for (int k = 0; k < 3; ++k) {
+            clause.push_back(mini::Lit(Var(var(rng)), rng() % 2 == 0));
+        }
+        cnf.add_clause(tools::Span<const mini::Lit>(clause.data(), clause.size()));
+    }
+    return cnf;
+}
+
+// Whether a model of one literal per variable (as SolverT::model())
+// satisfies the formula
+inline bool satisfies(const std::vector<dimacs::Lit>& model, const Cnf& cnf)
+{
+    for (auto clause : cnf) {
+        bool satisfied = false;
+        for (auto lit : clause) {
+            auto var = static_cast<std::size_t>(lit.var());
+            satisfied = satisfied || (var <= model.size()
+                && mini::Lit(model[var - 1].var(), model[var - 1].sign()) == lit);
+        }
+        if (!satisfied) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // test
+} // hubero
+#endif // HUBERO_TEST_HELPERS_H_
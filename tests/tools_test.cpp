@@ -39,3 +39,48 @@ TEST_CASE("type_to_string::complex_types")
     REQUIRE(type_to_string<long>() == "long");
     REQUIRE(type_to_string<unsigned long>() == "unsigned long");
 }
+
+TEST_CASE("Span")
+{
+    int data[] = {2, 3, 5, 7};
+    Span<int> all(data, 4);
+    REQUIRE(all.size() == 4);
+    REQUIRE(all.front() == 2);
+    REQUIRE(all.back() == 7);
+    REQUIRE(all[2] == 5);
+
+    Span<const int> tail(data + 1, data + 4);
+    REQUIRE(tail.size() == 3);
+    REQUIRE(*tail.begin() == 3);
+
+    Span<const int> converted = all;
+    REQUIRE(converted.data() == data);
+    REQUIRE(Span<int>().empty());
+}
+
+TEST_CASE("to_chars")
+{
+    char buffer[max_chars<std::uint64_t>()];
+    auto end = buffer + sizeof(buffer);
+
+    // every digit count, every boundary
+    std::uint64_t value = 1;
+    for (int digits = 1; digits <= 20; ++digits) {
+        const std::uint64_t values[] = {value - 1, value, value + 1, value * 9 / 7};
+        for (auto v : values) {
+            auto result = to_chars(buffer, end, v);
+            REQUIRE(result.ec == std::errc());
+            REQUIRE(std::string(buffer, result.ptr) == std::to_string(v));
+        }
+        if (digits < 20) {
+            value *= 10;
+        }
+    }
+    auto max = std::numeric_limits<std::uint64_t>::max();
+    REQUIRE(std::string(buffer, to_chars(buffer, end, max).ptr) == std::to_string(max));
+    REQUIRE(count_digits(max) == 20);
+    REQUIRE(count_digits(0u) == 1);
+
+    REQUIRE(to_chars(buffer, buffer + 2, 100u).ec == std::errc::value_too_large);
+    REQUIRE(std::string(buffer, to_chars(buffer, end, true, 42u).ptr) == "-42");
+}
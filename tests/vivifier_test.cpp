@@ -0,0 +1,177 @@
+// Copyright (c) 2018 radek
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#include <hubero/vivifier.hpp>
+#include "test_helpers.hpp"
+using namespace hubero;
+using namespace hubero::test;
+using namespace hubero::mini;
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+std::vector<Lit> sorted_lits(const Propagator& prop, ClauseRef ref)
+{
+    auto clause = prop.arena()[ref];
+    std::vector<Lit> lits(clause.begin(), clause.end());
+    std::sort(lits.begin(), lits.end());
+    return lits;
+}
+
+// Vivifies the one clause, returns its replacement
+ClauseRef vivify_one(Propagator& prop, Vivifier& vivifier, ClauseRef ref)
+{
+    auto result = ref;
+    REQUIRE(vivifier.vivify(prop, {ref}, 1000, [&result](ClauseRef, ClauseRef shorter) {
+        result = shorter;
+    }));
+    REQUIRE(prop.decision_level() == 0);
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Vivifier::shortening")
+{
+    Vivifier vivifier;
+
+    // -x1 implies x2 by another clause
+    Propagator prop;
+    prop.grow_to(Var(9));
+    prop.add_clause({lit(1), lit(2)});
+    auto ref = prop.add_clause({lit(1), lit(2), lit(3), lit(4)});
+    auto shorter = vivify_one(prop, vivifier, ref);
+    REQUIRE(prop.arena()[ref].garbage());
+    REQUIRE(sorted_lits(prop, shorter) == (std::vector<Lit>{lit(1), lit(2)}));
+    REQUIRE(prop.arena()[shorter].vivified());
+
+    // -x5 and -x6 conflict
+    prop.add_clause({lit(5), lit(6), lit(7)});
+    prop.add_clause({lit(5), lit(6), lit(-7)});
+    ref = prop.add_clause({lit(5), lit(6), lit(8), lit(9)});
+    shorter = vivify_one(prop, vivifier, ref);
+    REQUIRE(sorted_lits(prop, shorter) == (std::vector<Lit>{lit(5), lit(6)}));
+
+    // nothing to remove
+    ref = prop.add_clause({lit(-3), lit(-4), lit(-8)});
+    REQUIRE(vivify_one(prop, vivifier, ref) == ref);
+    REQUIRE(prop.arena()[ref].vivified());
+    REQUIRE(vivifier.stats().tried == 3);
+    REQUIRE(vivifier.stats().shortened == 2);
+    REQUIRE(vivifier.stats().removed_lits == 4);
+}
+
+TEST_CASE("Vivifier::implied false literals")
+{
+    // -x1 implies -x2, which is dropped; then -x3 falsifies the clause
+    Propagator prop;
+    prop.grow_to(Var(3));
+    prop.add_clause({lit(1), lit(-2)});
+    auto ref = prop.add_clause({lit(1), lit(2), lit(3)});
+    Vivifier vivifier;
+    auto shorter = vivify_one(prop, vivifier, ref);
+    REQUIRE(sorted_lits(prop, shorter) == (std::vector<Lit>{lit(1), lit(3)}));
+
+    // units are assigned at level 0
+    Propagator units;
+    units.grow_to(Var(4));
+    units.add_clause({lit(1), lit(2)});
+    units.add_clause({lit(1), lit(-2)});
+    ref = units.add_clause({lit(1), lit(3), lit(4)});
+    shorter = vivify_one(units, vivifier, ref);
+    REQUIRE(!shorter.valid());
+    REQUIRE(units.value(lit(1)) == Value::true_);
+    REQUIRE(vivifier.stats().units == 1);
+}
+
+TEST_CASE("Vivifier::prefixes and ticks")
+{
+    // clauses sharing -x1 -x2 reuse the decisions
+    Propagator prop;
+    prop.grow_to(Var(9));
+    std::vector<ClauseRef> clauses;
+    for (int i = 3; i <= 9; ++i) {
+        clauses.push_back(prop.add_clause({lit(1), lit(2), lit(i)}));
+    }
+    Vivifier vivifier;
+    REQUIRE(vivifier.vivify(prop, clauses, 1000, [](ClauseRef, ClauseRef) {}));
+    REQUIRE(vivifier.stats().tried == 7);
+    REQUIRE(vivifier.stats().shortened == 0);
+    REQUIRE(vivifier.stats().reused_levels >= 12);
+    REQUIRE(vivifier.stats().ticks > 0);
+
+    // no ticks, nothing tried
+    Vivifier idle;
+    REQUIRE(idle.vivify(prop, clauses, 0, [](ClauseRef, ClauseRef) {}));
+    REQUIRE(idle.stats().tried == 0);
+}
+
+TEST_CASE("Vivifier::random formulas")
+{
+    // the vivified formula has the same models
+    std::mt19937 rng(22);
+    std::uniform_int_distribution<int> var(1, 10);
+    std::uint64_t removed = 0;
+    for (int round = 0; round < 200; ++round) {
+        std::vector<std::vector<Lit>> clauses(25);
+        for (std::size_t i = 0; i < clauses.size(); ++i) {
+            auto size = i < 8 ? 2u : 4u;
+            while (clauses[i].size() < size) {
+                auto l = lit(rng() % 2 ? var(rng) : -var(rng));
+                bool fresh = true;
+                for (auto other : clauses[i]) {
+                    fresh = fresh && other != l && other != ~l;
+                }
+                if (fresh) {
+                    clauses[i].push_back(l);
+                }
+            }
+        }
+
+        Propagator prop;
+        prop.grow_to(Var(10));
+        std::vector<ClauseRef> refs;
+        for (const auto& clause : clauses) {
+            refs.push_back(prop.add_clause(tools::Span<const Lit>(clause.data(), clause.size())));
+        }
+        Vivifier vivifier;
+        auto consistent = vivifier.vivify(prop, refs, 100000, [](ClauseRef, ClauseRef) {});
+        removed += vivifier.stats().removed_lits;
+
+        bool same = true;
+        bool any_model = false;
+        for (std::uint32_t bits = 0; bits < (1u << 10); ++bits) {
+            auto is_true = [bits](Lit l) {
+                return ((bits >> (static_cast<unsigned>(l.var()) - 1)) & 1) == (l.sign() ? 1u : 0u);
+            };
+            bool original = true;
+            for (const auto& clause : clauses) {
+                original = original && std::any_of(clause.begin(), clause.end(), is_true);
+            }
+            any_model = any_model || original;
+            if (!consistent) {
+                continue;
+            }
+            bool vivified = true;
+            for (auto l : prop.trail()) {
+                vivified = vivified && is_true(l);
+            }
+            prop.arena().for_each_clause([&](ClauseRef ref) {
+                auto clause = prop.arena()[ref];
+                vivified = vivified && std::any_of(clause.begin(), clause.end(), is_true);
+            });
+            same = same && original == vivified;
+        }
+        REQUIRE(same);
+        REQUIRE((consistent || !any_model));
+    }
+    REQUIRE(removed > 0);
+}
@@ -0,0 +1,70 @@
+// Copyright (c) 2018 radek
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+#include <hubero/vmtf_queue.hpp>
+using namespace hubero;
+
+#include "catch.hpp"
+
+#include <vector>
+
+namespace {
+
+std::vector<unsigned> order_of(const VmtfQueue<Var>& queue)
+{
+    std::vector<unsigned> order;
+    queue.for_each([&](Var var) { order.push_back(static_cast<unsigned>(var)); });
+    return order;
+}
+
+} // namespace
+
+TEST_CASE("VmtfQueue::move_to_front")
+{
+    VmtfQueue<Var> queue;
+    for (unsigned v = 1; v <= 5; ++v) {
+        queue.enqueue(Var(v));
+    }
+    REQUIRE(order_of(queue) == std::vector<unsigned>{1, 2, 3, 4, 5});
+    REQUIRE(queue.contains(Var(3)));
+    REQUIRE(!queue.contains(Var(0)));
+
+    queue.move_to_front(Var(2), true);
+    queue.move_to_front(Var(1), true);
+    queue.move_to_front(Var(1), true);
+    REQUIRE(order_of(queue) == std::vector<unsigned>{3, 4, 5, 2, 1});
+    REQUIRE(queue.stamp(Var(1)) > queue.stamp(Var(2)));
+    REQUIRE(queue.stamp(Var(2)) > queue.stamp(Var(5)));
+}
+
+TEST_CASE("VmtfQueue::next")
+{
+    VmtfQueue<Var> queue;
+    for (unsigned v = 1; v <= 5; ++v) {
+        queue.enqueue(Var(v));
+    }
+    std::vector<bool> assigned(6, false);
+    auto free = [&](Var var) { return !assigned[static_cast<unsigned>(var)]; };
+
+    REQUIRE(queue.next(free) == Var(5));
+    assigned[5] = assigned[4] = true;
+    REQUIRE(queue.next(free) == Var(3));
+    assigned[3] = assigned[2] = assigned[1] = true;
+    REQUIRE(queue.next(free) == Var(0));
+
+    // the cursor returns to later variables only
+    assigned[4] = false;
+    queue.unassigned(Var(4));
+    assigned[1] = false;
+    queue.unassigned(Var(1));
+    REQUIRE(queue.next(free) == Var(4));
+
+    // moving an assigned variable keeps the cursor, an unassigned one takes it
+    queue.move_to_front(Var(5), false);
+    REQUIRE(queue.next(free) == Var(4));
+    assigned[2] = false;
+    queue.move_to_front(Var(2), true);
+    REQUIRE(queue.next(free) == Var(2));
+}